@@ -34,3 +34,27 @@ export const SECURITY_CONFIG = {
     ip.trim(),
   ) || ["127.0.0.1", "::1", "::ffff:127.0.0.1", "0.0.0.0"],
 };
+
+// Batch ingestion configuration
+export const BATCH_CONFIG = {
+  // Most events accepted by one POST /v1/events/batch request
+  MAX_EVENTS: parseInt(process.env.BATCH_MAX_EVENTS || "100", 10),
+};
+
+// PostHog forwarding for batched events
+export const POSTHOG_CONFIG = {
+  // Project API key; without it the batch endpoint refuses events rather
+  // than accepting and losing them
+  API_KEY: process.env.POSTHOG_API_KEY,
+  HOST: process.env.POSTHOG_HOST || "https://eu.i.posthog.com",
+};
+
+// Usage reporting: forwarded events are counted per distinct_id and reported
+// to the backend's metered billing (POST /usage/analytics-events)
+export const USAGE_REPORT_CONFIG = {
+  // Disabled when unset
+  URL: process.env.USAGE_REPORT_URL,
+  // Must match the backend's USAGE_INGEST_SECRET
+  SECRET: process.env.USAGE_REPORT_SECRET,
+  INTERVAL_MS: parseInt(process.env.USAGE_REPORT_INTERVAL_MS || "60000", 10),
+};
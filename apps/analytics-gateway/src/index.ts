@@ -9,6 +9,10 @@ import logger from "./utils/logger";
 
 // Import routes
 import eventsRoutes from "./modules/events/events.routes";
+import {
+  startUsageReporter,
+  stopUsageReporter,
+} from "./modules/usage/usage-reporter";
 
 config();
 
@@ -117,6 +121,8 @@ const startServer = async () => {
       `📚 API Docs available at http://localhost:${SERVER_CONFIG.PORT}/api-docs/openapi.json`,
     );
 
+    startUsageReporter();
+
     // Add shutdown handler
     const handleShutdown = async () => {
       if (isShuttingDown) return;
@@ -124,6 +130,9 @@ const startServer = async () => {
 
       logger.info("Shutting down server...");
 
+      // Report usage counted since the last flush
+      await stopUsageReporter();
+
       // Close the server
       server.close((err) => {
         if (err) {
@@ -1,8 +1,18 @@
 import { OpenAPIHono } from "@hono/zod-openapi";
 import { createRoute } from "@hono/zod-openapi";
 import { z } from "zod";
-import { EventSchema, EventResponseSchema } from "../../types/events";
+import {
+  EventBatchResponseSchema,
+  EventBatchSchema,
+  EventResponseSchema,
+  EventSchema,
+} from "../../types/events";
 import logger from "../../utils/logger";
+import { recordForwardedEvents } from "../usage/usage-reporter";
+import {
+  forwardToPostHog,
+  isPostHogForwardingEnabled,
+} from "./posthog-forwarder";
 
 // Create a router for events
 const router = new OpenAPIHono();
@@ -76,4 +86,118 @@ router.openapi(postEventRoute, async (c) => {
   }
 });
 
+// Define route for receiving a batch of events, so server-side senders can
+// buffer and send many events in one request
+const postEventBatchRoute = createRoute({
+  method: "post",
+  path: "/events/batch",
+  request: {
+    body: {
+      content: {
+        "application/json": {
+          schema: EventBatchSchema,
+        },
+      },
+    },
+  },
+  responses: {
+    200: {
+      content: {
+        "application/json": {
+          schema: EventBatchResponseSchema,
+        },
+      },
+      description: "Batch successfully received",
+    },
+    400: {
+      content: {
+        "application/json": {
+          schema: z.object({
+            success: z.boolean(),
+            message: z.string(),
+          }),
+        },
+      },
+      description: "Invalid batch payload",
+    },
+    502: {
+      content: {
+        "application/json": {
+          schema: z.object({
+            success: z.boolean(),
+            message: z.string(),
+          }),
+        },
+      },
+      description: "PostHog did not accept the batch",
+    },
+    503: {
+      content: {
+        "application/json": {
+          schema: z.object({
+            success: z.boolean(),
+            message: z.string(),
+          }),
+        },
+      },
+      description: "PostHog forwarding is not configured",
+    },
+  },
+});
+
+// Implement the batch route handler
+router.openapi(postEventBatchRoute, async (c) => {
+  const { events } = c.req.valid("json");
+  const receivedAt = new Date().toISOString();
+
+  for (const event of events) {
+    // Add timestamp if not present
+    event.timestamp ??= receivedAt;
+  }
+
+  // Refuse rather than accept events that would go nowhere, so senders
+  // count them as failed
+  if (!isPostHogForwardingEnabled()) {
+    logger.warn("Event batch refused: POSTHOG_API_KEY is not set");
+    return c.json(
+      { success: false, message: "PostHog forwarding is not configured" },
+      503,
+    );
+  }
+
+  try {
+    await forwardToPostHog(events);
+  } catch (error) {
+    logger.error("Error forwarding event batch", {
+      count: events.length,
+      error: (error as Error).message,
+    });
+    return c.json(
+      {
+        success: false,
+        message: "Error forwarding events: " + (error as Error).message,
+      },
+      502,
+    );
+  }
+
+  // Only delivered events count as usage
+  recordForwardedEvents(events);
+
+  // Log the forwarded batch
+  logger.info("Event batch forwarded", {
+    count: events.length,
+    eventIds: events.map((event) => event.id),
+  });
+
+  return c.json(
+    {
+      success: true,
+      message: "Event batch forwarded successfully",
+      received: events.length,
+    },
+    200,
+  );
+});
+
 export default router;
@@ -0,0 +1,31 @@
+import { POSTHOG_CONFIG } from "../../config";
+import { BatchEvent } from "../../types/events";
+
+/** Whether batched events can be forwarded (POSTHOG_API_KEY is set). */
+export const isPostHogForwardingEnabled = (): boolean =>
+  Boolean(POSTHOG_CONFIG.API_KEY);
+
+/**
+ * Sends events to PostHog's batch API in one request. The event id becomes
+ * the PostHog uuid, so a retried batch is deduplicated by PostHog.
+ * @throws When PostHog does not accept the batch.
+ */
+export const forwardToPostHog = async (events: BatchEvent[]): Promise<void> => {
+  const response = await fetch(`${POSTHOG_CONFIG.HOST}/batch/`, {
+    method: "POST",
+    headers: { "Content-Type": "application/json" },
+    body: JSON.stringify({
+      api_key: POSTHOG_CONFIG.API_KEY,
+      batch: events.map(({ id, payload, timestamp }) => ({
+        uuid: id,
+        event: payload.event,
+        distinct_id: payload.distinct_id,
+        properties: payload.properties ?? {},
+        timestamp,
+      })),
+    }),
+  });
+  if (!response.ok) {
+    throw new Error(`PostHog batch API returned ${response.status}`);
+  }
+};
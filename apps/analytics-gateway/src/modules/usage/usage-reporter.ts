@@ -0,0 +1,84 @@
+import { USAGE_REPORT_CONFIG } from "../../config";
+import { BatchEvent } from "../../types/events";
+import logger from "../../utils/logger";
+
+// Event ids remembered so a retried batch is not counted twice
+const MAX_SEEN_IDS = 10000;
+
+let counts = new Map<string, number>();
+const seenIds = new Set<string>();
+let timer: ReturnType<typeof setInterval> | null = null;
+
+const isUsageReportingEnabled = (): boolean =>
+  Boolean(USAGE_REPORT_CONFIG.URL && USAGE_REPORT_CONFIG.SECRET);
+
+/**
+ * Counts forwarded events per distinct_id, to be reported as usage on the
+ * next flush. Events already counted (same id) are skipped.
+ */
+export const recordForwardedEvents = (events: BatchEvent[]): void => {
+  if (!isUsageReportingEnabled()) return;
+  for (const { id, payload } of events) {
+    if (seenIds.has(id)) continue;
+    seenIds.add(id);
+    if (seenIds.size > MAX_SEEN_IDS) {
+      seenIds.delete(seenIds.values().next().value as string);
+    }
+    const distinctId = payload.distinct_id;
+    counts.set(distinctId, (counts.get(distinctId) ?? 0) + 1);
+  }
+};
+
+/**
+ * Reports the counted usage to the backend. On failure the counts are kept
+ * and sent with the next flush, as the backend records a report all or
+ * nothing.
+ */
+export const flushUsage = async (): Promise<void> => {
+  if (!isUsageReportingEnabled() || counts.size === 0) return;
+  const pending = counts;
+  counts = new Map();
+  try {
+    const response = await fetch(USAGE_REPORT_CONFIG.URL!, {
+      method: "POST",
+      headers: {
+        "Content-Type": "application/json",
+        "x-usage-secret": USAGE_REPORT_CONFIG.SECRET!,
+      },
+      body: JSON.stringify({ counts: Object.fromEntries(pending) }),
+    });
+    if (!response.ok) {
+      throw new Error(`Usage endpoint returned ${response.status}`);
+    }
+  } catch (error) {
+    for (const [distinctId, count] of pending) {
+      counts.set(distinctId, (counts.get(distinctId) ?? 0) + count);
+    }
+    logger.warn("Usage report failed; retrying on the next flush", {
+      users: pending.size,
+      error: (error as Error).message,
+    });
+  }
+};
+
+/** Starts reporting usage every USAGE_REPORT_INTERVAL_MS, if configured. */
+export const startUsageReporter = (): void => {
+  if (!isUsageReportingEnabled()) {
+    logger.info("Usage reporting disabled");
+    return;
+  }
+  timer ??= setInterval(
+    () => void flushUsage(),
+    USAGE_REPORT_CONFIG.INTERVAL_MS,
+  );
+  logger.info(
+    `Usage reporting every ${USAGE_REPORT_CONFIG.INTERVAL_MS}ms to ${USAGE_REPORT_CONFIG.URL}`,
+  );
+};
+
+/** Stops the reporter and sends what is still counted. */
+export const stopUsageReporter = async (): Promise<void> => {
+  if (timer) clearInterval(timer);
+  timer = null;
+  await flushUsage();
+};
@@ -1,4 +1,5 @@
 import { z } from "zod";
+import { BATCH_CONFIG } from "../config";
 
 // Schema for event validation
 export const EventSchema = z.object({
@@ -22,3 +23,36 @@ export const EventResponseSchema = z.object({
 });
 
 export type EventResponse = z.infer<typeof EventResponseSchema>;
+
+// Schema for a batched event, which is forwarded to PostHog as a capture
+export const BatchEventSchema = EventSchema.extend({
+  payload: z
+    .object({
+      event: z.string().min(1).describe("PostHog event name"),
+      distinct_id: z.string().min(1).describe("PostHog distinct id"),
+      properties: z.record(z.any()).optional(),
+    })
+    .describe("The PostHog capture"),
+});
+
+export type BatchEvent = z.infer<typeof BatchEventSchema>;
+
+// Schema for batch validation
+export const EventBatchSchema = z.object({
+  events: z
+    .array(BatchEventSchema)
+    .min(1)
+    .max(BATCH_CONFIG.MAX_EVENTS)
+    .describe("Events to ingest, in the order they occurred"),
+});
+
+export type EventBatch = z.infer<typeof EventBatchSchema>;
+
+// Batch response schema
+export const EventBatchResponseSchema = z.object({
+  success: z.boolean().describe("Whether the batch was processed successfully"),
+  message: z.string().describe("Status message"),
+  received: z.number().describe("The number of events forwarded"),
+});
+
+export type EventBatchResponse = z.infer<typeof EventBatchResponseSchema>;
@@ -43,3 +43,90 @@ export const REDIS_CONFIG = {
   CONNECTION_URL: process.env.BULLMQ_REDIS_URL,
   PREFIX: process.env.REDIS_PREFIX || "zer0:",
 };
+
+// Invitation maintenance configuration
+export const INVITATIONS_CONFIG = {
+  // Cron expression for expiring overdue invitations; empty disables the job
+  EXPIRE_CRON: process.env.INVITATIONS_EXPIRE_CRON ?? "*/15 * * * *",
+};
+
+// Frontend cache revalidation (catalog and per-user data)
+export const REVALIDATE_CONFIG = {
+  // Frontend /api/revalidate endpoint (optional); CATALOG_REVALIDATE_URL is
+  // the older name
+  URL:
+    process.env.FRONTEND_REVALIDATE_URL || process.env.CATALOG_REVALIDATE_URL,
+  SECRET: process.env.REVALIDATE_SECRET,
+};
+
+// Entitlements cache configuration
+export const ENTITLEMENTS_CONFIG = {
+  // In-process LRU (first tier); short TTL bounds staleness if an
+  // invalidation message is missed
+  LRU_MAX_ENTRIES: parseInt(process.env.ENTITLEMENTS_LRU_MAX || "10000", 10),
+  LRU_TTL_MS: parseInt(process.env.ENTITLEMENTS_LRU_TTL_MS || "30000", 10),
+  // Shared Redis tier (second tier), used when BULLMQ_REDIS_URL is set
+  REDIS_TTL_SECONDS: parseInt(
+    process.env.ENTITLEMENTS_REDIS_TTL_SECONDS || "300",
+    10,
+  ),
+};
+
+// Billing reconciliation configuration
+export const BILLING_CONFIG = {
+  // Cron expression for reconciling entitlements with Stripe; empty disables
+  RECONCILE_CRON: process.env.BILLING_RECONCILE_CRON ?? "0 3 * * *",
+};
+
+// Stripe webhook fan-out configuration
+export const WEBHOOKS_CONFIG = {
+  // Time limit per subscriber call
+  SUBSCRIBER_TIMEOUT_MS: parseInt(
+    process.env.STRIPE_WEBHOOK_TIMEOUT_MS || "10000",
+    10,
+  ),
+  // Durable subscribers go through BullMQ when BULLMQ_REDIS_URL is set
+  WORKER_CONCURRENCY: parseInt(
+    process.env.STRIPE_WEBHOOK_WORKER_CONCURRENCY || "10",
+    10,
+  ),
+};
+
+// Metered billing configuration
+export const USAGE_CONFIG = {
+  // Stripe billing meter that usage is reported to; empty disables metering
+  METER_EVENT_NAME: process.env.STRIPE_METER_EVENT_NAME || "",
+  FLUSH_INTERVAL_MS: parseInt(
+    process.env.USAGE_FLUSH_INTERVAL_MS || "10000",
+    10,
+  ),
+  // Without Redis, pending usage is checkpointed to this file
+  CHECKPOINT_PATH: process.env.USAGE_CHECKPOINT_PATH || "data/usage.json",
+  CHECKPOINT_INTERVAL_MS: parseInt(
+    process.env.USAGE_CHECKPOINT_INTERVAL_MS || "1000",
+    10,
+  ),
+  // Shared secret the analytics gateway sends with ingested-event counts
+  INGEST_SECRET: process.env.USAGE_INGEST_SECRET,
+};
+
+// Local Stripe stand-in (development and load tests only)
+export const STRIPE_STAND_IN_CONFIG = {
+  PORT: parseInt(process.env.STRIPE_STAND_IN_PORT || "12111", 10),
+  // Backend webhook endpoint that receives signed stand-in events (optional)
+  WEBHOOK_URL: process.env.STRIPE_STAND_IN_WEBHOOK_URL,
+  WEBHOOK_SECRET: process.env.STRIPE_WEBHOOK_SECRET,
+  // Synthetic webhook load; 0 only emits events for API changes
+  EVENTS_PER_SECOND: parseFloat(
+    process.env.STRIPE_STAND_IN_EVENTS_PER_SECOND || "0",
+  ),
+  FIXTURE_CUSTOMERS: parseInt(
+    process.env.STRIPE_STAND_IN_CUSTOMERS || "10",
+    10,
+  ),
+  // Share of meter events answered with a 500 after being recorded, to
+  // exercise idempotent usage retries
+  METER_FAILURE_RATE: parseFloat(
+    process.env.STRIPE_STAND_IN_METER_FAILURE_RATE || "0",
+  ),
+};
@@ -0,0 +1,97 @@
+import { createHmac, randomBytes } from "crypto";
+
+export const STAND_IN_API_VERSION = "2025-03-31.basil";
+
+/** Generates a Stripe-style object id, e.g. `cus_9f86d081884c7d65`. */
+export const stripeId = (prefix: string): string =>
+  `${prefix}_${randomBytes(12).toString("hex")}`;
+
+export const nowSeconds = (): number => Math.floor(Date.now() / 1000);
+
+export interface StandInEvent {
+  id: string;
+  object: "event";
+  api_version: string;
+  created: number;
+  data: { object: unknown; previous_attributes?: unknown };
+  livemode: false;
+  pending_webhooks: number;
+  request: { id: string | null; idempotency_key: string | null };
+  type: string;
+}
+
+/** Wraps an object in a Stripe event envelope. */
+export const createEvent = (type: string, object: unknown): StandInEvent => ({
+  id: stripeId("evt"),
+  object: "event",
+  api_version: STAND_IN_API_VERSION,
+  created: nowSeconds(),
+  data: { object },
+  livemode: false,
+  pending_webhooks: 1,
+  request: { id: null, idempotency_key: null },
+  type,
+});
+
+/**
+ * Builds a `Stripe-Signature` header the SDK's `constructEvent` accepts:
+ * `t=<timestamp>,v1=<HMAC-SHA256 of "<timestamp>.<payload>">`.
+ */
+export const signPayload = (
+  payload: string,
+  secret: string,
+  timestamp = nowSeconds(),
+): string => {
+  const signature = createHmac("sha256", secret)
+    .update(`${timestamp}.${payload}`)
+    .digest("hex");
+  return `t=${timestamp},v1=${signature}`;
+};
+
+export interface DeliveryResult {
+  status: number;
+  latencyMs: number;
+  error?: string;
+}
+
+/**
+ * POSTs a signed event to a webhook endpoint, like Stripe does.
+ * @param url The webhook endpoint, e.g. http://localhost:420/webhooks/stripe.
+ * @param secret The endpoint's signing secret (STRIPE_WEBHOOK_SECRET).
+ * @param event The event to deliver.
+ * @returns The response status (0 on network errors) and latency.
+ */
+export const deliverEvent = async (
+  url: string,
+  secret: string,
+  event: StandInEvent,
+): Promise<DeliveryResult> => {
+  const payload = JSON.stringify(event);
+  const startedAt = performance.now();
+  try {
+    const response = await fetch(url, {
+      method: "POST",
+      headers: {
+        "Content-Type": "application/json",
+        "Stripe-Signature": signPayload(payload, secret),
+      },
+      body: payload,
+    });
+    // The webhook route acknowledges handler failures with 200 and an
+    // `error` field, so Stripe does not retry them; surface those too.
+    const body = (await response.json().catch(() => null)) as {
+      error?: string;
+    } | null;
+    return {
+      status: response.status,
+      latencyMs: performance.now() - startedAt,
+      error: body?.error,
+    };
+  } catch (error) {
+    return {
+      status: 0,
+      latencyMs: performance.now() - startedAt,
+      error: error instanceof Error ? error.message : String(error),
+    };
+  }
+};
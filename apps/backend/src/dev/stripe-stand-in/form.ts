@@ -0,0 +1,32 @@
+type FormValue = string | FormValue[] | { [key: string]: FormValue };
+
+/**
+ * Parses Stripe's form encoding (`metadata[plan]=pro`,
+ * `line_items[0][price]=price_1`, `expand[]=customer`) into nested objects
+ * and arrays, the way the Stripe API reads request bodies and query strings.
+ */
+export const parseStripeForm = (
+  params: URLSearchParams,
+): Record<string, FormValue> => {
+  const root: Record<string, FormValue> = {};
+
+  params.forEach((value, name) => {
+    const [head, ...rest] = name.split("[");
+    const path = [head, ...rest.map((part) => part.replace(/]$/, ""))];
+
+    let target: any = root;
+    path.forEach((segment, index) => {
+      const isLast = index === path.length - 1;
+      const nextIsIndex = !isLast && /^\d*$/.test(path[index + 1]);
+      const key = segment === "" ? target.length : segment;
+      if (isLast) {
+        target[key] = value;
+      } else {
+        target[key] ??= nextIsIndex ? [] : {};
+        target = target[key];
+      }
+    });
+  });
+
+  return root;
+};
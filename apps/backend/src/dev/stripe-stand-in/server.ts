@@ -0,0 +1,406 @@
+import { serve } from "@hono/node-server";
+import { Context, Hono } from "hono";
+import { STRIPE_STAND_IN_CONFIG } from "@/config";
+import logger from "@/utils/logger";
+import { createEvent, deliverEvent, nowSeconds, stripeId } from "./events";
+import { parseStripeForm } from "./form";
+import { createFixtureStore } from "./store";
+
+// Local Stripe stand-in for offline development and load tests:
+//   pnpm stripe:stand-in
+// Point the SDK at it with STRIPE_API_BASE=http://localhost:12111 and set
+// STRIPE_STAND_IN_WEBHOOK_URL to receive signed webhooks for every change.
+
+const store = createFixtureStore(STRIPE_STAND_IN_CONFIG.FIXTURE_CUSTOMERS);
+const baseUrl = `http://localhost:${STRIPE_STAND_IN_CONFIG.PORT}`;
+
+const stats = { emitted: 0, delivered: 0, failed: 0 };
+
+// Meter event totals per event name and customer; identifiers are
+// deduplicated like Stripe's, so retried usage is only counted once.
+const meterTotals: Record<string, Record<string, number>> = {};
+const meterIdentifiers = new Set<string>();
+const meterStats = { accepted: 0, duplicates: 0, injectedFailures: 0 };
+
+/** Sends a signed webhook for a change, without delaying the API response. */
+const emit = (type: string, object: unknown) => {
+  const { WEBHOOK_URL, WEBHOOK_SECRET } = STRIPE_STAND_IN_CONFIG;
+  if (!WEBHOOK_URL || !WEBHOOK_SECRET) return;
+  stats.emitted += 1;
+  const event = createEvent(type, object);
+  void deliverEvent(WEBHOOK_URL, WEBHOOK_SECRET, event).then(
+    ({ status, error }) => {
+      if (status >= 200 && status < 300 && !error) {
+        stats.delivered += 1;
+      } else {
+        stats.failed += 1;
+        logger.warn(`Stand-in webhook ${type} failed: ${error ?? status}`);
+      }
+    },
+  );
+};
+
+const notFound = (c: Context, id: string, param = "id") =>
+  c.json(
+    {
+      error: {
+        type: "invalid_request_error",
+        code: "resource_missing",
+        message: `No such object: '${id}'`,
+        param,
+      },
+    },
+    404,
+  );
+
+const readBody = async (c: Context): Promise<Record<string, any>> =>
+  parseStripeForm(new URLSearchParams(await c.req.text()));
+
+const readQuery = (c: Context): Record<string, any> =>
+  parseStripeForm(new URL(c.req.url).searchParams);
+
+const listOptions = (query: Record<string, any>) => ({
+  limit: query.limit ? parseInt(query.limit, 10) : undefined,
+  startingAfter: query.starting_after as string | undefined,
+});
+
+const app = new Hono();
+
+app.use("/v1/*", async (c, next) => {
+  if (!c.req.header("authorization")?.startsWith("Bearer ")) {
+    return c.json(
+      {
+        error: {
+          type: "invalid_request_error",
+          message: "You did not provide an API key.",
+        },
+      },
+      401,
+    );
+  }
+  await next();
+});
+
+// ========= Products and prices =========
+app.get("/v1/products", (c) => {
+  const query = readQuery(c);
+  return c.json(
+    store.list("products", {
+      ...listOptions(query),
+      filter: (product) =>
+        query.active === undefined || String(product.active) === query.active,
+    }),
+  );
+});
+
+app.post("/v1/products", async (c) => {
+  const body = await readBody(c);
+  const product = store.insert("products", {
+    active: body.active !== "false",
+    name: body.name,
+    description: body.description ?? null,
+    default_price: null,
+    images: body.images ?? [],
+    marketing_features: [],
+    metadata: body.metadata ?? {},
+  });
+  emit("product.created", product);
+  return c.json(product);
+});
+
+app.get("/v1/products/:id", (c) => {
+  const product = store.get("products", c.req.param("id"));
+  return product ? c.json(product) : notFound(c, c.req.param("id"));
+});
+
+app.post("/v1/products/:id", async (c) => {
+  const body = await readBody(c);
+  if (body.active !== undefined) body.active = body.active === "true";
+  const product = store.update("products", c.req.param("id"), body);
+  if (!product) return notFound(c, c.req.param("id"));
+  emit("product.updated", product);
+  return c.json(product);
+});
+
+app.get("/v1/prices", (c) => {
+  const query = readQuery(c);
+  const lookupKeys: string[] | undefined = query.lookup_keys;
+  return c.json(
+    store.list("prices", {
+      ...listOptions(query),
+      filter: (price) =>
+        (query.product === undefined || price.product === query.product) &&
+        (query.active === undefined || String(price.active) === query.active) &&
+        (!lookupKeys || lookupKeys.includes(price.lookup_key)),
+    }),
+  );
+});
+
+app.get("/v1/prices/:id", (c) => {
+  const price = store.get("prices", c.req.param("id"));
+  return price ? c.json(price) : notFound(c, c.req.param("id"));
+});
+
+// ========= Customers =========
+app.get("/v1/customers", (c) => {
+  const query = readQuery(c);
+  return c.json(
+    store.list("customers", {
+      ...listOptions(query),
+      filter: (customer) => !query.email || customer.email === query.email,
+    }),
+  );
+});
+
+app.post("/v1/customers", async (c) => {
+  const body = await readBody(c);
+  const customer = store.insert("customers", {
+    email: body.email ?? null,
+    name: body.name ?? null,
+    metadata: body.metadata ?? {},
+  });
+  emit("customer.created", customer);
+  return c.json(customer);
+});
+
+app.get("/v1/customers/:id", (c) => {
+  const customer = store.get("customers", c.req.param("id"));
+  return customer ? c.json(customer) : notFound(c, c.req.param("id"));
+});
+
+app.post("/v1/customers/:id", async (c) => {
+  const customer = store.update(
+    "customers",
+    c.req.param("id"),
+    await readBody(c),
+  );
+  if (!customer) return notFound(c, c.req.param("id"));
+  emit("customer.updated", customer);
+  return c.json(customer);
+});
+
+app.delete("/v1/customers/:id", (c) => {
+  const customer = store.get("customers", c.req.param("id"));
+  if (!customer) return notFound(c, c.req.param("id"));
+  store.remove("customers", customer.id);
+  emit("customer.deleted", customer);
+  return c.json({ id: customer.id, object: "customer", deleted: true });
+});
+
+// ========= Checkout sessions =========
+app.post("/v1/checkout/sessions", async (c) => {
+  const body = await readBody(c);
+  const lineItem = body.line_items?.[0];
+  if (!lineItem?.price || !store.get("prices", lineItem.price)) {
+    return notFound(c, lineItem?.price ?? "", "line_items[0][price]");
+  }
+  if (body.customer && !store.get("customers", body.customer)) {
+    return notFound(c, body.customer, "customer");
+  }
+  const session = store.insert("checkout_sessions", {
+    customer: body.customer ?? null,
+    mode: body.mode,
+    status: "open",
+    payment_status: "unpaid",
+    success_url: body.success_url,
+    cancel_url: body.cancel_url,
+    metadata: body.metadata ?? {},
+    subscription: null,
+    // Stand-in only: line items are kept to complete the session later
+    line_items: { object: "list", data: [lineItem], has_more: false },
+    subscription_data: body.subscription_data ?? {},
+  });
+  const withUrl = store.update("checkout_sessions", session.id, {
+    url: `${baseUrl}/checkout/${session.id}`,
+  });
+  return c.json(withUrl);
+});
+
+app.get("/v1/checkout/sessions/:id", (c) => {
+  const session = store.get("checkout_sessions", c.req.param("id"));
+  return session ? c.json(session) : notFound(c, c.req.param("id"));
+});
+
+// Stand-in for the hosted checkout page: completes the session immediately,
+// emits the events Stripe would, and redirects to the success URL.
+app.get("/checkout/:id", (c) => {
+  const session = store.get("checkout_sessions", c.req.param("id"));
+  if (!session || session.status !== "open") {
+    return c.text("Checkout session not found or already completed", 404);
+  }
+
+  const customer =
+    store.get("customers", session.customer ?? "") ??
+    store.insert("customers", { email: null, name: null });
+  if (!session.customer) emit("customer.created", customer);
+
+  let subscriptionId: string | null = null;
+  if (session.mode === "subscription") {
+    const subscription = store.createSubscription(
+      customer.id,
+      session.line_items.data[0].price,
+      session.subscription_data.metadata ?? {},
+    );
+    subscriptionId = subscription.id;
+    emit("customer.subscription.created", subscription);
+  }
+
+  const completed = store.update("checkout_sessions", session.id, {
+    customer: customer.id,
+    status: "complete",
+    payment_status: "paid",
+    subscription: subscriptionId,
+  });
+  emit("checkout.session.completed", completed);
+
+  return c.redirect(
+    session.success_url.replace("{CHECKOUT_SESSION_ID}", session.id),
+  );
+});
+
+// ========= Subscriptions =========
+app.get("/v1/subscriptions", (c) => {
+  const query = readQuery(c);
+  // Like Stripe, canceled subscriptions are only listed on request
+  const matchesStatus = (status: string) =>
+    query.status === "all" ||
+    (query.status ? status === query.status : status !== "canceled");
+  return c.json(
+    store.list("subscriptions", {
+      ...listOptions(query),
+      filter: (subscription) =>
+        (!query.customer || subscription.customer === query.customer) &&
+        matchesStatus(subscription.status),
+    }),
+  );
+});
+
+app.get("/v1/subscriptions/:id", (c) => {
+  const subscription = store.get("subscriptions", c.req.param("id"));
+  return subscription
+    ? c.json(subscription)
+    : notFound(c, c.req.param("id"));
+});
+
+app.post("/v1/subscriptions/:id", async (c) => {
+  const body = await readBody(c);
+  const fields: Record<string, unknown> = { metadata: body.metadata };
+  if (body.cancel_at_period_end !== undefined) {
+    fields.cancel_at_period_end = body.cancel_at_period_end === "true";
+  }
+  const subscription = store.update("subscriptions", c.req.param("id"), fields);
+  if (!subscription) return notFound(c, c.req.param("id"));
+  emit("customer.subscription.updated", subscription);
+  return c.json(subscription);
+});
+
+app.delete("/v1/subscriptions/:id", (c) => {
+  const subscription = store.update("subscriptions", c.req.param("id"), {
+    status: "canceled",
+    canceled_at: Math.floor(Date.now() / 1000),
+  });
+  if (!subscription) return notFound(c, c.req.param("id"));
+  emit("customer.subscription.deleted", subscription);
+  return c.json(subscription);
+});
+
+// ========= Billing meter events =========
+app.post("/v1/billing/meter_events", async (c) => {
+  const body = await readBody(c);
+  const customerId = body.payload?.stripe_customer_id;
+  const value = Number(body.payload?.value ?? 1);
+  if (!body.event_name || !customerId || !Number.isFinite(value)) {
+    return c.json(
+      {
+        error: {
+          type: "invalid_request_error",
+          message: "event_name and payload[stripe_customer_id] are required",
+        },
+      },
+      400,
+    );
+  }
+  if (!store.get("customers", customerId)) {
+    return notFound(c, customerId, "payload[stripe_customer_id]");
+  }
+
+  const identifier: string = body.identifier ?? stripeId("mtr");
+  if (meterIdentifiers.has(identifier)) {
+    meterStats.duplicates += 1;
+    return c.json(
+      {
+        error: {
+          type: "invalid_request_error",
+          message: `An event already exists with identifier ${identifier}.`,
+        },
+      },
+      400,
+    );
+  }
+  meterIdentifiers.add(identifier);
+  const totals = (meterTotals[body.event_name] ??= {});
+  totals[customerId] = (totals[customerId] ?? 0) + value;
+  meterStats.accepted += 1;
+
+  // Simulates a response lost after Stripe recorded the event
+  if (Math.random() < STRIPE_STAND_IN_CONFIG.METER_FAILURE_RATE) {
+    meterStats.injectedFailures += 1;
+    return c.json(
+      { error: { type: "api_error", message: "Injected failure" } },
+      500,
+    );
+  }
+
+  return c.json({
+    object: "billing.meter_event",
+    created: nowSeconds(),
+    event_name: body.event_name,
+    identifier,
+    livemode: false,
+    payload: body.payload,
+    timestamp: body.timestamp ? Number(body.timestamp) : nowSeconds(),
+  });
+});
+
+// ========= Synthetic webhook load =========
+// Re-emits updates for fixture objects at a steady rate to drive the backend.
+const EVENT_LOAD_TICK_MS = 10;
+
+const startEventLoad = (eventsPerSecond: number) => {
+  const products = store.list("products", { limit: 100 }).data;
+  const subscriptions = store.list("subscriptions", { limit: 100 }).data;
+  let sent = 0;
+  let due = 0;
+  return setInterval(() => {
+    due += (eventsPerSecond * EVENT_LOAD_TICK_MS) / 1000;
+    for (; due >= 1; due -= 1) {
+      sent += 1;
+      if (sent % 2 === 0 && subscriptions.length > 0) {
+        const subscription = subscriptions[sent % subscriptions.length];
+        emit("customer.subscription.updated", subscription);
+      } else {
+        emit("product.updated", products[sent % products.length]);
+      }
+    }
+  }, EVENT_LOAD_TICK_MS);
+};
+
+app.get("/stand-in/stats", (c) => c.json({ ...stats, meter: meterStats }));
+
+// Usage recorded per meter and customer, for checking usage load tests
+app.get("/stand-in/meter-totals", (c) => c.json(meterTotals));
+
+serve({ fetch: app.fetch, port: STRIPE_STAND_IN_CONFIG.PORT });
+logger.info(`Stripe stand-in listening on ${baseUrl}`);
+
+if (STRIPE_STAND_IN_CONFIG.EVENTS_PER_SECOND > 0) {
+  if (!STRIPE_STAND_IN_CONFIG.WEBHOOK_URL) {
+    logger.warn("STRIPE_STAND_IN_EVENTS_PER_SECOND needs a webhook URL");
+  } else {
+    startEventLoad(STRIPE_STAND_IN_CONFIG.EVENTS_PER_SECOND);
+    logger.info(
+      `Emitting ${STRIPE_STAND_IN_CONFIG.EVENTS_PER_SECOND} webhook events/s ` +
+        `to ${STRIPE_STAND_IN_CONFIG.WEBHOOK_URL}`,
+    );
+  }
+}
@@ -0,0 +1,198 @@
+import { nowSeconds, stripeId } from "./events";
+
+type StripeObject = { id: string; object: string } & Record<string, any>;
+
+/** Resources the stand-in serves, keyed by their URL segment. */
+export type Resource =
+  | "products"
+  | "prices"
+  | "customers"
+  | "checkout_sessions"
+  | "subscriptions";
+
+const OBJECT_NAMES: Record<Resource, string> = {
+  products: "product",
+  prices: "price",
+  customers: "customer",
+  checkout_sessions: "checkout.session",
+  subscriptions: "subscription",
+};
+
+const ID_PREFIXES: Record<Resource, string> = {
+  products: "prod",
+  prices: "price",
+  customers: "cus",
+  checkout_sessions: "cs_test",
+  subscriptions: "sub",
+};
+
+const THIRTY_DAYS = 30 * 24 * 60 * 60;
+
+/**
+ * In-memory Stripe objects. Maps keep insertion order; lists are returned
+ * newest first like Stripe's.
+ */
+export class StandInStore {
+  private readonly objects: Record<Resource, Map<string, StripeObject>> = {
+    products: new Map(),
+    prices: new Map(),
+    customers: new Map(),
+    checkout_sessions: new Map(),
+    subscriptions: new Map(),
+  };
+
+  get(resource: Resource, id: string): StripeObject | undefined {
+    return this.objects[resource].get(id);
+  }
+
+  /**
+   * Returns one page of a resource, newest first, with Stripe's cursor
+   * semantics (`limit`, `starting_after`) and an optional filter.
+   */
+  list(
+    resource: Resource,
+    {
+      limit = 10,
+      startingAfter,
+      filter,
+    }: {
+      limit?: number;
+      startingAfter?: string;
+      filter?: (object: StripeObject) => boolean;
+    },
+  ) {
+    const all = Array.from(this.objects[resource].values())
+      .reverse()
+      .filter((object) => !filter || filter(object));
+    const start = startingAfter
+      ? all.findIndex((object) => object.id === startingAfter) + 1
+      : 0;
+    const data = all.slice(start, start + Math.min(Math.max(limit, 1), 100));
+    return {
+      object: "list" as const,
+      data,
+      has_more: start + data.length < all.length,
+      url: `/v1/${resource.replace("_", "/")}`,
+    };
+  }
+
+  insert(resource: Resource, fields: Record<string, any>): StripeObject {
+    const object: StripeObject = {
+      id: stripeId(ID_PREFIXES[resource]),
+      object: OBJECT_NAMES[resource],
+      created: nowSeconds(),
+      livemode: false,
+      metadata: {},
+      ...fields,
+    };
+    this.objects[resource].set(object.id, object);
+    return object;
+  }
+
+  /** Merges fields into an object; `metadata` is merged key by key. */
+  update(
+    resource: Resource,
+    id: string,
+    fields: Record<string, any>,
+  ): StripeObject | undefined {
+    const existing = this.objects[resource].get(id);
+    if (!existing) return undefined;
+    const { metadata, ...rest } = fields;
+    const updated = {
+      ...existing,
+      ...rest,
+      metadata: { ...existing.metadata, ...(metadata ?? {}) },
+    };
+    this.objects[resource].set(id, updated);
+    return updated;
+  }
+
+  remove(resource: Resource, id: string): boolean {
+    return this.objects[resource].delete(id);
+  }
+
+  /**
+   * Creates an active subscription for a customer and price, with the
+   * billing period on the item as in API version 2025-03-31.basil.
+   */
+  createSubscription(
+    customerId: string,
+    priceId: string,
+    metadata: Record<string, string> = {},
+  ): StripeObject {
+    const price = this.get("prices", priceId);
+    const start = nowSeconds();
+    return this.insert("subscriptions", {
+      customer: customerId,
+      status: "active",
+      cancel_at_period_end: false,
+      metadata,
+      items: {
+        object: "list",
+        data: [
+          {
+            id: stripeId("si"),
+            object: "subscription_item",
+            price,
+            quantity: 1,
+            current_period_start: start,
+            current_period_end: start + THIRTY_DAYS,
+          },
+        ],
+        has_more: false,
+      },
+    });
+  }
+}
+
+/**
+ * Seeds a store with a small catalog (two plans, monthly and yearly) and the
+ * given number of customers, each with an active subscription.
+ * @param customers How many customers (and subscriptions) to create.
+ */
+export const createFixtureStore = (customers = 10): StandInStore => {
+  const store = new StandInStore();
+
+  const plans = [
+    { name: "Starter", amount: 900, features: "projects" },
+    { name: "Pro", amount: 2900, features: "projects,exports,api" },
+  ];
+  const prices = plans.flatMap((plan) => {
+    const product = store.insert("products", {
+      active: true,
+      name: plan.name,
+      description: `${plan.name} plan`,
+      default_price: null,
+      images: [],
+      marketing_features: [],
+      metadata: { features: plan.features },
+    });
+    const intervals = ["month", "year"] as const;
+    const planPrices = intervals.map((interval) =>
+      store.insert("prices", {
+        product: product.id,
+        active: true,
+        currency: "usd",
+        unit_amount: interval === "month" ? plan.amount : plan.amount * 10,
+        type: "recurring",
+        recurring: { interval, interval_count: 1 },
+        lookup_key: `${plan.name.toLowerCase()}_${interval}ly`,
+        nickname: `${plan.name} ${interval}ly`,
+      }),
+    );
+    store.update("products", product.id, {
+      default_price: planPrices[0].id,
+    });
+    return planPrices;
+  });
+
+  for (let index = 0; index < customers; index += 1) {
+    const customer = store.insert("customers", {
+      email: `customer-${index}@stand-in.test`,
+      name: `Customer ${index}`,
+    });
+    store.createSubscription(customer.id, prices[index % prices.length].id);
+  }
+
+  return store;
+};
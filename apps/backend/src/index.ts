@@ -6,12 +6,24 @@ import { mkdirSync } from "fs";
 import { rateLimiter } from "hono-rate-limiter";
 import { cors } from "hono/cors";
 import { RATE_LIMIT_CONFIG, SERVER_CONFIG } from "./config";
+import { startExpireInvitationsJob } from "./jobs/expire-invitations";
+import { startReconcileBillingJob } from "./jobs/reconcile-billing";
 import { ipWhitelist } from "./middleware/ip-whitelist";
+import {
+  startEntitlementsInvalidationListener,
+} from "./modules/entitlements/cache";
+import {
+  closeWebhookQueue,
+  startStripeWebhookWorker,
+} from "./modules/stripe/webhook-queue";
+import { stripeWebhookBus } from "./modules/stripe/webhook-subscribers";
+import { startUsageMeter } from "./modules/usage/meter";
 import logger from "./utils/logger";
 config();
 
 // Import webhook routes
 import webhookRoutes from "./modules/stripe/webhooks.routes";
+import usageRoutes from "./modules/usage/usage.routes";
 
 // Create logs directory if it doesn't exist
 try {
@@ -72,6 +84,9 @@ app.get("/api-docs", swaggerUI({ url: "/api-docs/openapi.json" }));
 // Mount webhook routes
 app.route("/webhooks", webhookRoutes);
 
+// Metered usage reported by the analytics gateway
+app.route("/usage", usageRoutes);
+
 // Routes
 app.get("/", (c) => {
   logger.info("Health check request received");
@@ -129,6 +144,19 @@ const startServer = async () => {
       `📚 API Docs available at http://localhost:${SERVER_CONFIG.PORT}/api-docs`,
     );
 
+    // Scheduled jobs
+    const expireInvitationsJob = startExpireInvitationsJob();
+    const reconcileBillingJob = startReconcileBillingJob();
+
+    // Cross-instance entitlements cache invalidation
+    const entitlementsListener = startEntitlementsInvalidationListener();
+
+    // Durable Stripe webhook subscribers (when Redis is configured)
+    const webhookWorker = startStripeWebhookWorker(stripeWebhookBus);
+
+    // Batched metered-usage reporting to Stripe
+    const usageMeter = startUsageMeter();
+
     // Add shutdown handler
     const handleShutdown = async () => {
       if (isShuttingDown) return;
@@ -136,6 +164,19 @@ const startServer = async () => {
 
       logger.info("Shutting down server...");
 
+      // Stop scheduled jobs
+      expireInvitationsJob?.stop();
+      reconcileBillingJob?.stop();
+      entitlementsListener?.disconnect();
+      // Report pending usage before exiting
+      await usageMeter
+        ?.stop()
+        .catch((error) => logger.error("Error flushing usage:", error));
+      // Jobs interrupted here are picked up again as stalled jobs
+      await Promise.all([webhookWorker?.close(), closeWebhookQueue()]).catch(
+        (error) => logger.error("Error closing webhook queue:", error),
+      );
+
       // Close the server
       server.close((err) => {
         if (err) {
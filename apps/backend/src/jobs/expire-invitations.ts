@@ -0,0 +1,50 @@
+import { expireInvitations } from "@maestro/supabase";
+import { CronJob } from "cron";
+import { INVITATIONS_CONFIG } from "../config";
+import { supabaseAdmin } from "../lib/supabase";
+import logger from "../utils/logger";
+
+/**
+ * Marks every overdue pending invitation as expired in one indexed UPDATE.
+ * Safe to run on demand; concurrent runs simply find nothing left to expire.
+ * @returns The number of invitations expired.
+ */
+export const runExpireInvitations = async (): Promise<number> => {
+  const { data, error } = await expireInvitations({ supabase: supabaseAdmin });
+  if (error) {
+    throw new Error(`Failed to expire invitations: ${error.message}`);
+  }
+  return data ?? 0;
+};
+
+/**
+ * Schedules `runExpireInvitations` using `INVITATIONS_CONFIG.EXPIRE_CRON`.
+ * @returns The started job, or null when the schedule is disabled.
+ */
+export const startExpireInvitationsJob = (): CronJob | null => {
+  if (!INVITATIONS_CONFIG.EXPIRE_CRON) {
+    logger.info("Invitation expiry job disabled");
+    return null;
+  }
+
+  const job = CronJob.from({
+    cronTime: INVITATIONS_CONFIG.EXPIRE_CRON,
+    onTick: async () => {
+      try {
+        const expired = await runExpireInvitations();
+        if (expired > 0) {
+          logger.info(`Expired ${expired} overdue invitations`);
+        }
+      } catch (error) {
+        logger.error("Invitation expiry job failed:", error);
+      }
+    },
+    start: true,
+    waitForCompletion: true,
+  });
+
+  logger.info(
+    `Invitation expiry job scheduled (${INVITATIONS_CONFIG.EXPIRE_CRON})`,
+  );
+  return job;
+};
@@ -0,0 +1,38 @@
+import { CronJob } from "cron";
+import { BILLING_CONFIG } from "../config";
+import { reconcileEntitlements } from "../modules/entitlements/reconcile";
+import logger from "../utils/logger";
+
+/**
+ * Schedules `reconcileEntitlements` using `BILLING_CONFIG.RECONCILE_CRON`.
+ * @returns The started job, or null when the schedule is disabled.
+ */
+export const startReconcileBillingJob = (): CronJob | null => {
+  if (!BILLING_CONFIG.RECONCILE_CRON) {
+    logger.info("Billing reconciliation job disabled");
+    return null;
+  }
+
+  const job = CronJob.from({
+    cronTime: BILLING_CONFIG.RECONCILE_CRON,
+    onTick: async () => {
+      try {
+        const { scanned, missing, changed, repaired } =
+          await reconcileEntitlements();
+        logger.info(
+          `Billing reconciliation: ${scanned} subscriptions scanned, ` +
+            `${missing} missing, ${changed} outdated, ${repaired} repaired`,
+        );
+      } catch (error) {
+        logger.error("Billing reconciliation job failed:", error);
+      }
+    },
+    start: true,
+    waitForCompletion: true,
+  });
+
+  logger.info(
+    `Billing reconciliation job scheduled (${BILLING_CONFIG.RECONCILE_CRON})`,
+  );
+  return job;
+};
@@ -0,0 +1,41 @@
+import Redis from "ioredis";
+import { REDIS_CONFIG } from "../config";
+import logger from "../utils/logger";
+
+const createClient = (name: string, failFast: boolean): Redis => {
+  const client = new Redis(REDIS_CONFIG.CONNECTION_URL as string, {
+    // Fail fast while disconnected: callers fall back (e.g. to the database
+    // or a local store) instead of queueing commands.
+    enableOfflineQueue: !failFast,
+    maxRetriesPerRequest: failFast ? 1 : null,
+  });
+  client.on("error", (error) => {
+    logger.warn(`Redis ${name} connection error: ${error.message}`);
+  });
+  return client;
+};
+
+let commandClient: Redis | null = null;
+
+/**
+ * Returns the shared Redis client for application data, or null when no
+ * Redis URL is configured (`BULLMQ_REDIS_URL`). BullMQ manages its own
+ * connections.
+ */
+export const getRedis = (): Redis | null => {
+  if (!REDIS_CONFIG.CONNECTION_URL) return null;
+  if (!commandClient) commandClient = createClient("shared", true);
+  return commandClient;
+};
+
+/**
+ * Creates a dedicated connection for pub/sub (a subscribed connection cannot
+ * run other commands), or null when Redis is not configured.
+ * @param name Used in connection error logs.
+ */
+export const createRedisSubscriber = (name: string): Redis | null =>
+  REDIS_CONFIG.CONNECTION_URL ? createClient(name, false) : null;
+
+/** Prefixes a cache key with `REDIS_CONFIG.PREFIX`. */
+export const redisKey = (...parts: string[]): string =>
+  `${REDIS_CONFIG.PREFIX}${parts.join(":")}`;
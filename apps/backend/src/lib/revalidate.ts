@@ -0,0 +1,42 @@
+import { REVALIDATE_CONFIG } from "@/config";
+import logger from "@/utils/logger";
+
+/** Tags per request; the frontend rejects larger batches. */
+const TAGS_PER_REQUEST = 100;
+
+/**
+ * Asks the frontend to drop cached reads with the given tags (see its
+ * /api/revalidate route). Failures, including redirects and other non-2xx
+ * responses, are logged, not thrown: every cached read also expires on its
+ * own.
+ * @param tags Cache tags, e.g. "stripe-catalog" or "entitlements:<user id>".
+ */
+export const revalidateFrontendTags = async (tags: string[]): Promise<void> => {
+  if (!REVALIDATE_CONFIG.URL || !REVALIDATE_CONFIG.SECRET || !tags.length) {
+    return;
+  }
+  for (let i = 0; i < tags.length; i += TAGS_PER_REQUEST) {
+    try {
+      const response = await fetch(REVALIDATE_CONFIG.URL, {
+        method: "POST",
+        headers: {
+          "Content-Type": "application/json",
+          "x-revalidate-secret": REVALIDATE_CONFIG.SECRET,
+        },
+        body: JSON.stringify({ tags: tags.slice(i, i + TAGS_PER_REQUEST) }),
+        // A redirect means the request never reached the route (e.g. the
+        // middleware sent it to /login); following it would hide that
+        redirect: "manual",
+      });
+      if (response.status >= 300 && response.status < 400) {
+        logger.warn(
+          `Frontend revalidation was redirected to ${response.headers.get("location")}; is /api/revalidate excluded from the middleware?`,
+        );
+      } else if (!response.ok) {
+        logger.warn(`Frontend revalidation returned ${response.status}`);
+      }
+    } catch (error) {
+      logger.warn("Frontend revalidation request failed:", error);
+    }
+  }
+};
@@ -1,10 +1,35 @@
-import Stripe from "stripe";
+import { addStripeTelemetryListener, getStripeClient } from "@maestro/stripe";
+import logger from "@/utils/logger";
 
 if (!process.env.STRIPE_SECRET_KEY) {
   throw new Error("STRIPE_SECRET_KEY environment variable is not set.");
 }
 
-export const stripe = new Stripe(process.env.STRIPE_SECRET_KEY, {
+// Pooled client: reuses keep-alive connections across requests. Request
+// handlers and webhooks use the interactive lane of the rate-limit scheduler.
+export const stripe = getStripeClient({
+  apiKey: process.env.STRIPE_SECRET_KEY,
   apiVersion: "2025-03-31.basil", // Use the latest API version
-  typescript: true,
+  lane: "interactive",
+  apiBase: process.env.STRIPE_API_BASE, // e.g. the local stand-in
+});
+
+// Same account, batch lane: syncs, backfills and reconciliation only use
+// capacity that interactive calls leave free.
+export const stripeBatch = getStripeClient({
+  apiKey: process.env.STRIPE_SECRET_KEY,
+  apiVersion: "2025-03-31.basil",
+  lane: "batch",
+  apiBase: process.env.STRIPE_API_BASE,
+});
+
+// Per-call latency for every Stripe request made through pooled clients
+addStripeTelemetryListener(({ method, path, status, elapsedMs, requestId }) => {
+  logger.debug("Stripe API call", {
+    method,
+    path,
+    status,
+    elapsedMs,
+    requestId,
+  });
 });
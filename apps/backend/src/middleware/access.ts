@@ -0,0 +1,133 @@
+import {
+  fetchProjectAccess,
+  fetchUserAccess,
+  hasProjectAccess,
+  toUserAccessSet,
+  UserAccess,
+  UserAccessSet,
+} from "@maestro/supabase";
+import { Context, Next } from "hono";
+import { supabaseAdmin } from "../lib/supabase";
+import logger from "../utils/logger";
+
+/**
+ * Returns the authenticated user's access set, fetching it at most once per
+ * request. Later calls in the same request (other middleware, handlers,
+ * services) reuse the same promise. Requires `authenticateUser` to have run.
+ * @param c The Hono context.
+ * @returns The user's access set.
+ * @example
+ * const access = await getUserAccess(c);
+ * const visible = projectIds.filter((id) => access.projects.has(id));
+ */
+export const getUserAccess = (c: Context): Promise<UserAccessSet> => {
+  const cached = c.get("userAccess");
+  if (cached) return cached;
+
+  const user = c.get("user");
+  const pending = fetchUserAccess({
+    supabase: supabaseAdmin,
+    profileId: user.id,
+  }).then(({ data, error }) => {
+    if (error) {
+      throw new Error(`Failed to load user access: ${error.message}`);
+    }
+    return toUserAccessSet(user.id, data ?? []);
+  });
+
+  // Drop failed lookups so a retry within the request can succeed.
+  pending.catch(() => c.set("userAccess", undefined));
+  c.set("userAccess", pending);
+  return pending;
+};
+
+/**
+ * Returns the authenticated user's access row for one project, or null
+ * without access. Reuses the access set when this request already loaded it;
+ * otherwise reads the single row by primary key.
+ * @param c The Hono context.
+ * @param projectId The project to check.
+ */
+export const getProjectAccess = async (
+  c: Context,
+  projectId: string,
+): Promise<UserAccess | null> => {
+  const cached = c.get("userAccess");
+  if (cached) return (await cached).projects.get(projectId) ?? null;
+
+  const { data, error } = await fetchProjectAccess({
+    supabase: supabaseAdmin,
+    profileId: c.get("user").id,
+    projectId,
+  });
+  if (error) {
+    throw new Error(`Failed to load project access: ${error.message}`);
+  }
+  return data;
+};
+
+/**
+ * Rejects the request unless the user can access the project named by a
+ * route parameter, optionally with one of the given roles.
+ * @param param The route parameter holding the project id (default: "projectId").
+ * @param roles Organization or project roles that satisfy the check.
+ * @example
+ * app.patch(
+ *   "/projects/:projectId",
+ *   authenticateUser,
+ *   requireProjectAccess("projectId", ["owner", "admin", "editor"]),
+ *   handler,
+ * );
+ */
+export const requireProjectAccess =
+  (param = "projectId", roles?: readonly string[]) =>
+  async (c: Context, next: Next) => {
+    const projectId = c.req.param(param);
+    if (!projectId) {
+      return c.json(
+        { error: "Bad Request", message: `Missing route parameter: ${param}` },
+        400,
+      );
+    }
+
+    try {
+      const access = await getProjectAccess(c, projectId);
+      if (!hasProjectAccess(access, roles)) {
+        logger.warn("Project access denied", {
+          userId: c.get("user").id,
+          projectId,
+          path: c.req.path,
+          method: c.req.method,
+        });
+        return c.json(
+          {
+            error: "Forbidden",
+            message: "You do not have access to this project",
+          },
+          403,
+        );
+      }
+    } catch (error) {
+      logger.error("Access check error", {
+        error: error instanceof Error ? error.message : String(error),
+        path: c.req.path,
+        method: c.req.method,
+      });
+      return c.json(
+        {
+          error: "Access check failed",
+          message: "An error occurred while checking access",
+        },
+        500,
+      );
+    }
+
+    await next();
+  };
+
+// Type declaration for the access set in context
+declare module "hono" {
+  interface ContextVariableMap {
+    userAccess: Promise<UserAccessSet> | undefined;
+  }
+}
@@ -0,0 +1,174 @@
+import {
+  EntitlementSet,
+  fetchEntitlements,
+  toEntitlementSet,
+} from "@maestro/supabase";
+import type Redis from "ioredis";
+import { ENTITLEMENTS_CONFIG } from "@/config";
+import { createRedisSubscriber, getRedis, redisKey } from "@/lib/redis";
+import { revalidateFrontendTags } from "@/lib/revalidate";
+import { supabaseAdmin } from "@/lib/supabase";
+import { LruCache } from "@/utils/lru-cache";
+import logger from "@/utils/logger";
+
+/** Pub/sub channel every instance listens on to evict its local entries. */
+const INVALIDATION_CHANNEL = redisKey("entitlements", "invalidate");
+
+const cacheKey = (profileId: string) => redisKey("entitlements", profileId);
+
+/** Tag of the frontend's cached entitlements for a user (lib/data). */
+const frontendTag = (profileId: string) => `entitlements:${profileId}`;
+
+const local = new LruCache<string, EntitlementSet>(
+  ENTITLEMENTS_CONFIG.LRU_MAX_ENTRIES,
+  ENTITLEMENTS_CONFIG.LRU_TTL_MS,
+);
+
+// Concurrent misses for the same user share one lookup.
+const inFlight = new Map<string, Promise<EntitlementSet>>();
+
+// Bumped on every invalidation; lookups that started earlier are not cached.
+let generation = 0;
+
+const readShared = async (
+  profileId: string,
+): Promise<EntitlementSet | null> => {
+  const redis = getRedis();
+  if (!redis) return null;
+  try {
+    const cached = await redis.get(cacheKey(profileId));
+    return cached ? (JSON.parse(cached) as EntitlementSet) : null;
+  } catch (error) {
+    logger.warn("Entitlements cache read failed:", error);
+    return null;
+  }
+};
+
+const writeShared = async (entitlements: EntitlementSet) => {
+  const redis = getRedis();
+  if (!redis) return;
+  try {
+    await redis.set(
+      cacheKey(entitlements.profileId),
+      JSON.stringify(entitlements),
+      "EX",
+      ENTITLEMENTS_CONFIG.REDIS_TTL_SECONDS,
+    );
+  } catch (error) {
+    logger.warn("Entitlements cache write failed:", error);
+  }
+};
+
+const load = async (
+  profileId: string,
+  startedAt: number,
+): Promise<EntitlementSet> => {
+  const shared = await readShared(profileId);
+  if (shared) return shared;
+
+  const { data, error } = await fetchEntitlements({
+    supabase: supabaseAdmin,
+    profileId,
+  });
+  if (error) {
+    throw new Error(`Failed to load entitlements: ${error.message}`);
+  }
+  const entitlements = toEntitlementSet(profileId, data ?? []);
+  if (startedAt === generation) await writeShared(entitlements);
+  return entitlements;
+};
+
+/**
+ * Returns the plans and features a user is entitled to. Served from the
+ * in-process LRU when possible, then from Redis, then from the database; each
+ * miss fills the tiers above it. Subscription webhooks invalidate both tiers
+ * (see `invalidateEntitlements`), and the TTLs in `ENTITLEMENTS_CONFIG` bound
+ * staleness for changes that do not go through a webhook, such as a user
+ * joining an organization.
+ * @param profileId The user's profile id.
+ * @returns The user's entitlement set.
+ * @example
+ * const entitlements = await getEntitlements(user.id);
+ * if (!hasFeature(entitlements, "exports")) {
+ *   return c.json({ error: "Upgrade required" }, 402);
+ * }
+ */
+export const getEntitlements = async (
+  profileId: string,
+): Promise<EntitlementSet> => {
+  const cached = local.get(profileId);
+  if (cached) return cached;
+
+  let pending = inFlight.get(profileId);
+  if (!pending) {
+    const startedAt = generation;
+    pending = load(profileId, startedAt)
+      .then((entitlements) => {
+        if (startedAt === generation) local.set(profileId, entitlements);
+        return entitlements;
+      })
+      .finally(() => inFlight.delete(profileId));
+    inFlight.set(profileId, pending);
+  }
+  return pending;
+};
+
+const evictLocal = (profileIds: string[]) => {
+  generation += 1;
+  profileIds.forEach((profileId) => local.delete(profileId));
+};
+
+/**
+ * Drops cached entitlements after a subscription change: deletes the Redis
+ * entries of the affected users, tells every instance (this one included)
+ * to evict them from its LRU and revalidates the frontend's cached copies.
+ * For an organization, pass all of its members so those who were not
+ * entitled before are refreshed too. Failures are logged, not thrown: every
+ * tier also expires on its own.
+ * @param profileIds The users whose entitlements changed.
+ */
+export const invalidateEntitlements = async (
+  profileIds: string[],
+): Promise<void> => {
+  if (profileIds.length === 0) return;
+  evictLocal(profileIds);
+
+  const redis = getRedis();
+  if (redis) {
+    try {
+      await redis.del(...profileIds.map(cacheKey));
+      await redis.publish(INVALIDATION_CHANNEL, JSON.stringify(profileIds));
+    } catch (error) {
+      logger.warn("Entitlements cache invalidation failed:", error);
+    }
+  }
+
+  await revalidateFrontendTags(profileIds.map(frontendTag));
+};
+
+/**
+ * Subscribes to invalidation messages from other instances so their
+ * subscription changes evict entries from this instance's LRU.
+ * @returns The subscriber connection (close it on shutdown), or null when
+ * Redis is not configured.
+ */
+export const startEntitlementsInvalidationListener = (): Redis | null => {
+  const subscriber = createRedisSubscriber("entitlements subscriber");
+  if (!subscriber) {
+    logger.info("Entitlements cache running without Redis (local LRU only)");
+    return null;
+  }
+
+  subscriber.subscribe(INVALIDATION_CHANNEL).catch((error) => {
+    logger.error("Failed to subscribe to entitlements invalidation:", error);
+  });
+  subscriber.on("message", (channel, message) => {
+    if (channel !== INVALIDATION_CHANNEL) return;
+    try {
+      evictLocal(JSON.parse(message) as string[]);
+    } catch (error) {
+      logger.warn("Ignoring malformed entitlements invalidation:", error);
+    }
+  });
+  return subscriber;
+};
@@ -0,0 +1,220 @@
+import { fromStripeTimestamp, stripeId } from "@maestro/stripe";
+import { EntitlementSync, upsertEntitlement } from "@maestro/supabase";
+import Stripe from "stripe";
+import { stripe } from "@/lib/stripe/config";
+import { supabaseAdmin } from "@/lib/supabase";
+import logger from "@/utils/logger";
+import { invalidateEntitlements } from "./cache";
+
+const parseFeatures = (value: string | undefined): string[] =>
+  (value ?? "")
+    .split(",")
+    .map((feature) => feature.trim())
+    .filter(Boolean);
+
+type Owner = Pick<EntitlementSync, "profile_id" | "organization_id">;
+
+/**
+ * Resolves who a subscription belongs to: `organization_id` or
+ * `supabase_user_id` in the subscription metadata (set at checkout), else the
+ * user linked to the customer in `stripe_customers`, else the customer's
+ * `supabase_user_id` metadata.
+ */
+const resolveOwner = async (
+  subscription: Stripe.Subscription,
+): Promise<Owner | null> => {
+  const { organization_id, supabase_user_id } = subscription.metadata ?? {};
+  if (organization_id) return { profile_id: null, organization_id };
+  if (supabase_user_id) {
+    return { profile_id: supabase_user_id, organization_id: null };
+  }
+
+  const customerId = stripeId(subscription.customer);
+  const { data: linked } = await supabaseAdmin
+    .from("stripe_customers")
+    .select("profile_id")
+    .eq("stripe_customer_id", customerId)
+    .maybeSingle();
+  if (linked) return { profile_id: linked.profile_id, organization_id: null };
+
+  const customer =
+    typeof subscription.customer === "string"
+      ? await stripe.customers.retrieve(subscription.customer)
+      : subscription.customer;
+  if (customer.deleted || !customer.metadata?.supabase_user_id) return null;
+  return {
+    profile_id: customer.metadata.supabase_user_id,
+    organization_id: null,
+  };
+};
+
+/**
+ * Features of a product, from the `features` metadata key (comma separated).
+ * Reads the catalog mirror first and falls back to Stripe.
+ */
+const productFeatures = async (productId: string): Promise<string[]> => {
+  const { data } = await supabaseAdmin
+    .from("stripe_products")
+    .select("metadata")
+    .eq("id", productId)
+    .maybeSingle();
+  const mirrored = data?.metadata as Record<string, string> | undefined;
+  if (mirrored) return parseFeatures(mirrored.features);
+
+  const product = await stripe.products.retrieve(productId);
+  return parseFeatures(product.metadata?.features);
+};
+
+const organizationMemberIds = async (
+  organizationId: string,
+): Promise<string[]> => {
+  const { data, error } = await supabaseAdmin
+    .from("organization_members")
+    .select("profile_id")
+    .eq("organization_id", organizationId);
+  if (error) {
+    throw new Error(`Failed to load organization members: ${error.message}`);
+  }
+  return data.map((member) => member.profile_id);
+};
+
+/** Everyone whose entitlements an owner's subscription affects. */
+const affectedProfileIds = async (owner: Owner): Promise<string[]> => {
+  if (owner.organization_id) {
+    return organizationMemberIds(owner.organization_id);
+  }
+  return owner.profile_id ? [owner.profile_id] : [];
+};
+
+const storedOwner = async (subscriptionId: string): Promise<Owner | null> => {
+  const { data, error } = await supabaseAdmin
+    .from("entitlements")
+    .select("profile_id, organization_id")
+    .eq("stripe_subscription_id", subscriptionId)
+    .maybeSingle();
+  if (error) {
+    throw new Error(`Failed to load entitlement: ${error.message}`);
+  }
+  return data;
+};
+
+/**
+ * Latest period end across the items, as an ISO string. Billing periods are
+ * per item since API version 2025-03-31.basil.
+ */
+export const latestPeriodEnd = (
+  items: readonly Stripe.SubscriptionItem[],
+): string | null =>
+  items.length > 0
+    ? fromStripeTimestamp(
+        Math.max(...items.map((item) => item.current_period_end)),
+      )
+    : null;
+
+/**
+ * Writes the entitlement for a subscription as observed at `observedAt`, then
+ * invalidates the cached entitlements of everyone it affects, including the
+ * previous owner when the subscription changed hands. Every item counts: the
+ * plans and features are those of the base plan and all add-ons. Writes are
+ * ordered by `observedAt`, so older data never overwrites newer state. When
+ * another event with the same (one-second) time is already stored, the
+ * subscription is re-read from Stripe and that data is written instead.
+ * @param subscription The Stripe subscription.
+ * @param observedAt ISO time the subscription data reflects (event creation
+ * or fetch time).
+ * @param eventId The event the data comes from; omit for data read from the
+ * API.
+ * @returns False when the subscription has no items or no known owner.
+ */
+export const projectSubscription = async (
+  subscription: Stripe.Subscription,
+  observedAt: string,
+  eventId: string | null = null,
+): Promise<boolean> => {
+  const items = subscription.items.data;
+  if (items.length === 0) {
+    logger.warn(`Subscription ${subscription.id} has no items; skipped`);
+    return false;
+  }
+
+  const owner = await resolveOwner(subscription);
+  if (!owner) {
+    logger.warn(
+      `Subscription ${subscription.id} has no linked user or organization`,
+    );
+    return false;
+  }
+
+  const previousOwner = await storedOwner(subscription.id);
+  const productIds = items.map((item) => stripeId(item.price.product));
+  const features = await Promise.all(productIds.map(productFeatures));
+  const { data: stored, error } = await upsertEntitlement({
+    supabase: supabaseAdmin,
+    entitlement: {
+      stripe_subscription_id: subscription.id,
+      stripe_customer_id: stripeId(subscription.customer),
+      ...owner,
+      status: subscription.status,
+      plans: items.map((item, i) => item.price.lookup_key ?? productIds[i]),
+      product_ids: productIds,
+      price_ids: items.map((item) => item.price.id),
+      features: Array.from(new Set(features.flat())),
+      current_period_end: latestPeriodEnd(items),
+      cancel_at_period_end: subscription.cancel_at_period_end,
+      last_event_at: observedAt,
+      last_event_id: eventId,
+    },
+  });
+  if (error) {
+    throw new Error(`Failed to store entitlement: ${error.message}`);
+  }
+
+  const tied =
+    eventId !== null &&
+    stored.last_event_id !== eventId &&
+    Date.parse(stored.last_event_at) === Date.parse(observedAt);
+  if (tied) {
+    // Which of two same-second events is newer is unknown; Stripe's current
+    // state covers both and wins the tie.
+    logger.info(
+      `Event ${eventId} ties with the stored state of ${subscription.id}; re-reading it`,
+    );
+    const current = await stripe.subscriptions.retrieve(subscription.id);
+    return projectSubscription(current, observedAt);
+  }
+
+  const ownerChanged =
+    previousOwner !== null &&
+    (previousOwner.profile_id !== stored.profile_id ||
+      previousOwner.organization_id !== stored.organization_id);
+  const affected = await Promise.all([
+    affectedProfileIds(stored),
+    ownerChanged ? affectedProfileIds(previousOwner) : [],
+  ]);
+  await invalidateEntitlements(Array.from(new Set(affected.flat())));
+
+  logger.info(
+    `Entitlement for subscription ${subscription.id} is ${stored.status}`,
+  );
+  return true;
+};
+
+/**
+ * Projects a `customer.subscription.*` webhook event into the entitlements
+ * table. The event's `created` time orders writes, so a late, older event
+ * never overwrites newer state. Deleted subscriptions are stored with their
+ * final status (`canceled`) and stop granting access.
+ * @param event The verified Stripe event.
+ */
+export const applySubscriptionEvent = async (
+  event:
+    | Stripe.CustomerSubscriptionCreatedEvent
+    | Stripe.CustomerSubscriptionUpdatedEvent
+    | Stripe.CustomerSubscriptionDeletedEvent,
+): Promise<void> => {
+  await projectSubscription(
+    event.data.object,
+    fromStripeTimestamp(event.created),
+    event.id,
+  );
+};
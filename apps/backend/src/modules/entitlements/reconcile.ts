@@ -0,0 +1,90 @@
+import { Entitlement } from "@maestro/supabase";
+import {
+  mapWithConcurrency,
+  paginateStripePages,
+  reconcileStripeList,
+} from "@maestro/stripe";
+import Stripe from "stripe";
+import { stripeBatch } from "@/lib/stripe/config";
+import { supabaseAdmin } from "@/lib/supabase";
+import { latestPeriodEnd, projectSubscription } from "./projection";
+
+/** Parallel repairs; each may call Stripe and write to the database. */
+const REPAIR_CONCURRENCY = 4;
+
+type StoredState = Pick<
+  Entitlement,
+  | "stripe_subscription_id"
+  | "status"
+  | "price_ids"
+  | "current_period_end"
+  | "cancel_at_period_end"
+>;
+
+const loadEntitlements = async (ids: string[]): Promise<StoredState[]> => {
+  const { data, error } = await supabaseAdmin
+    .from("entitlements")
+    .select(
+      "stripe_subscription_id, status, price_ids, current_period_end, cancel_at_period_end",
+    )
+    .in("stripe_subscription_id", ids);
+  if (error) {
+    throw new Error(`Failed to load entitlements: ${error.message}`);
+  }
+  return data;
+};
+
+const isUpToDate = (subscription: Stripe.Subscription, row: StoredState) => {
+  const items = subscription.items.data;
+  const periodEnd = latestPeriodEnd(items);
+  return (
+    row.status === subscription.status &&
+    row.price_ids.join() === items.map((item) => item.price.id).join() &&
+    row.cancel_at_period_end === subscription.cancel_at_period_end &&
+    row.current_period_end !== null &&
+    periodEnd !== null &&
+    new Date(row.current_period_end).getTime() === Date.parse(periodEnd)
+  );
+};
+
+/**
+ * Compares every Stripe subscription with the entitlements table and
+ * re-projects the ones that are missing or outdated (e.g. after a dropped
+ * webhook). Streams one page of subscriptions at a time, so memory stays
+ * constant regardless of account size.
+ * @returns Counts of subscriptions scanned, missing, outdated and repaired.
+ */
+export const reconcileEntitlements = async () => {
+  const stats = { scanned: 0, missing: 0, changed: 0, repaired: 0 };
+  // When each subscription's page was requested. Stripe's snapshot is at
+  // least that recent, so a webhook created after it is newer and wins; a
+  // single start-of-run stamp would let older events block the repair of
+  // pages read long after the run began.
+  const readAt = new WeakMap<Stripe.Subscription, string>();
+
+  const pages = paginateStripePages(async (cursor) => {
+    const requestedAt = new Date().toISOString();
+    const page = await stripeBatch.subscriptions.list({
+      ...cursor,
+      status: "all",
+    });
+    page.data.forEach((subscription) => readAt.set(subscription, requestedAt));
+    stats.scanned += page.data.length;
+    return page;
+  });
+  const diffs = reconcileStripeList({
+    remote: pages,
+    fetchLocal: loadEntitlements,
+    localId: (row) => row.stripe_subscription_id,
+    isEqual: isUpToDate,
+  });
+
+  const repairs = mapWithConcurrency(diffs, REPAIR_CONCURRENCY, (diff) => {
+    stats[diff.kind] += 1;
+    return projectSubscription(diff.remote, readAt.get(diff.remote)!);
+  });
+  for await (const repaired of repairs) {
+    if (repaired) stats.repaired += 1;
+  }
+  return stats;
+};
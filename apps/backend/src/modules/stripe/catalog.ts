@@ -0,0 +1,182 @@
+import {
+  deleteStaleStripeCatalog,
+  StripePriceSync,
+  StripeProductSync,
+  upsertStripePrices,
+  upsertStripeProducts,
+} from "@maestro/supabase";
+import {
+  fromStripeTimestamp,
+  paginateStripePages,
+  stripeId,
+} from "@maestro/stripe";
+import Stripe from "stripe";
+import { revalidateFrontendTags } from "@/lib/revalidate";
+import { stripeBatch } from "@/lib/stripe/config";
+import { supabaseAdmin } from "@/lib/supabase";
+import logger from "@/utils/logger";
+
+/** Cache tag the frontend uses for everything read from the catalog mirror. */
+export const CATALOG_CACHE_TAG = "stripe-catalog";
+
+/** Objects per Stripe list page and per mirror write during a full sync. */
+const SYNC_PAGE_SIZE = 100;
+
+/**
+ * Maps a Stripe product to a mirror row.
+ * @param product The Stripe product.
+ * @param eventAt When the product data was observed (event or fetch time).
+ */
+export const toProductRow = (
+  product: Stripe.Product,
+  eventAt: string,
+): StripeProductSync => ({
+  id: product.id,
+  active: product.active,
+  name: product.name,
+  description: product.description ?? null,
+  default_price_id: stripeId(product.default_price),
+  images: product.images ?? [],
+  metadata: product.metadata ?? {},
+  marketing_features: (product.marketing_features ?? []).map((feature) => ({
+    name: feature.name ?? null,
+  })),
+  livemode: product.livemode,
+  deleted: false,
+  created_at: fromStripeTimestamp(product.created),
+  last_event_at: eventAt,
+});
+
+/**
+ * Maps a Stripe price to a mirror row.
+ * @param price The Stripe price.
+ * @param eventAt When the price data was observed (event or fetch time).
+ */
+export const toPriceRow = (
+  price: Stripe.Price,
+  eventAt: string,
+): StripePriceSync => ({
+  id: price.id,
+  product_id: stripeId(price.product),
+  active: price.active,
+  currency: price.currency,
+  unit_amount: price.unit_amount ?? null,
+  type: price.type,
+  recurring_interval: price.recurring?.interval ?? null,
+  recurring_interval_count: price.recurring?.interval_count ?? null,
+  lookup_key: price.lookup_key ?? null,
+  nickname: price.nickname ?? null,
+  metadata: price.metadata ?? {},
+  livemode: price.livemode,
+  deleted: false,
+  created_at: fromStripeTimestamp(price.created),
+  last_event_at: eventAt,
+});
+
+const writeProducts = async (rows: StripeProductSync[]) => {
+  if (rows.length === 0) return;
+  const { error } = await upsertStripeProducts({
+    supabase: supabaseAdmin,
+    products: rows,
+  });
+  if (error) throw new Error(`Failed to mirror products: ${error.message}`);
+};
+
+const writePrices = async (rows: StripePriceSync[]) => {
+  if (rows.length === 0) return;
+  const { error } = await upsertStripePrices({
+    supabase: supabaseAdmin,
+    prices: rows,
+  });
+  if (error) throw new Error(`Failed to mirror prices: ${error.message}`);
+};
+
+/**
+ * Asks the frontend to drop its cached catalog. Failures are logged, not
+ * thrown: the cache also expires on its own (see the frontend `revalidate`).
+ */
+export const revalidateCatalogCache = (): Promise<void> =>
+  revalidateFrontendTags([CATALOG_CACHE_TAG]);
+
+// Deleted objects stay in the mirror as inactive tombstones, so a late
+// `*.updated` event cannot bring them back (see 0010_STRIPE_CATALOG.sql).
+const TOMBSTONE = { active: false, deleted: true } as const;
+
+/**
+ * Applies a `product.*` or `price.*` webhook event to the mirror, then
+ * revalidates the frontend cache. The event's `created` time orders writes,
+ * so a late, older event never overwrites newer data, and deletions are
+ * tombstones that no later write revives.
+ * @param event The verified Stripe event.
+ */
+export const applyCatalogEvent = async (event: Stripe.Event): Promise<void> => {
+  const eventAt = fromStripeTimestamp(event.created);
+
+  switch (event.type) {
+    case "product.created":
+    case "product.updated":
+      await writeProducts([toProductRow(event.data.object, eventAt)]);
+      break;
+    case "product.deleted":
+      await writeProducts([
+        { ...toProductRow(event.data.object, eventAt), ...TOMBSTONE },
+      ]);
+      break;
+    case "price.created":
+    case "price.updated":
+      await writePrices([toPriceRow(event.data.object, eventAt)]);
+      break;
+    case "price.deleted":
+      await writePrices([
+        { ...toPriceRow(event.data.object, eventAt), ...TOMBSTONE },
+      ]);
+      break;
+    default:
+      return;
+  }
+
+  logger.info(`Catalog mirror updated from ${event.type} (${event.id})`);
+  await revalidateCatalogCache();
+};
+
+/**
+ * Re-syncs the whole catalog from Stripe page by page, prefetching the next
+ * page while the current one is written, then removes mirror rows that no
+ * longer exist in Stripe.
+ * Safe to run while webhooks are flowing: newer webhook data is kept.
+ * @returns The number of products and prices synced and removed.
+ */
+export const syncStripeCatalog = async () => {
+  const startedAt = new Date().toISOString();
+  let products = 0;
+  let prices = 0;
+
+  // One mirror write per Stripe page; the next page is prefetched meanwhile.
+  const pageOptions = { pageSize: SYNC_PAGE_SIZE };
+  for await (const page of paginateStripePages(
+    (cursor) => stripeBatch.products.list(cursor),
+    pageOptions,
+  )) {
+    await writeProducts(page.map((row) => toProductRow(row, startedAt)));
+    products += page.length;
+  }
+
+  for await (const page of paginateStripePages(
+    (cursor) => stripeBatch.prices.list(cursor),
+    pageOptions,
+  )) {
+    await writePrices(page.map((row) => toPriceRow(row, startedAt)));
+    prices += page.length;
+  }
+
+  const { data: removed, error } = await deleteStaleStripeCatalog({
+    supabase: supabaseAdmin,
+    before: startedAt,
+  });
+  if (error) {
+    throw new Error(`Failed to remove stale catalog rows: ${error.message}`);
+  }
+
+  await revalidateCatalogCache();
+  return { products, prices, removed };
+};
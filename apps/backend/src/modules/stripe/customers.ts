@@ -0,0 +1,83 @@
+import { linkStripeCustomer, unlinkStripeCustomer } from "@maestro/supabase";
+import Stripe from "stripe";
+import { stripeBatch } from "@/lib/stripe/config";
+import { supabaseAdmin } from "@/lib/supabase";
+import logger from "@/utils/logger";
+
+/**
+ * Links a Stripe customer to the Supabase user in its `supabase_user_id`
+ * metadata. An existing link for that user is kept (first link wins), as is
+ * an existing link of the customer to another user.
+ * @returns True when the customer is now the user's linked customer.
+ */
+const linkCustomer = async (customer: Stripe.Customer): Promise<boolean> => {
+  const profileId = customer.metadata?.supabase_user_id;
+  if (!profileId) return false;
+
+  const { data: linkedId, error } = await linkStripeCustomer({
+    supabase: supabaseAdmin,
+    profileId,
+    customerId: customer.id,
+  });
+  if (error) {
+    // 23503: the profile does not exist (e.g. test-mode data, deleted user)
+    if (error.code === "23503") {
+      logger.warn(`Customer ${customer.id} has unknown user ${profileId}`);
+      return false;
+    }
+    // 23505: the customer is already linked to another user (its metadata
+    // was changed); the existing link is kept
+    if (error.code === "23505") {
+      logger.warn(
+        `Customer ${customer.id} is linked to another user than ${profileId}; skipped`,
+      );
+      return false;
+    }
+    throw new Error(`Failed to link Stripe customer: ${error.message}`);
+  }
+  return linkedId === customer.id;
+};
+
+/**
+ * Keeps the user -> customer mapping current from `customer.*` webhook
+ * events: customers created outside checkout are linked, deleted customers
+ * are unlinked so the next checkout creates a new one.
+ * @param event The verified Stripe event.
+ */
+export const applyCustomerEvent = async (
+  event: Stripe.Event,
+): Promise<void> => {
+  switch (event.type) {
+    case "customer.created":
+    case "customer.updated":
+      await linkCustomer(event.data.object);
+      break;
+    case "customer.deleted": {
+      const { error } = await unlinkStripeCustomer({
+        supabase: supabaseAdmin,
+        customerId: event.data.object.id,
+      });
+      if (error) {
+        throw new Error(`Failed to unlink Stripe customer: ${error.message}`);
+      }
+      break;
+    }
+    default:
+      return;
+  }
+};
+
+/**
+ * Links every existing Stripe customer that carries `supabase_user_id`
+ * metadata, for accounts created before the mapping table existed.
+ * @returns The number of customers scanned and linked.
+ */
+export const backfillStripeCustomers = async () => {
+  let scanned = 0;
+  let linked = 0;
+  for await (const customer of stripeBatch.customers.list({ limit: 100 })) {
+    scanned += 1;
+    if (await linkCustomer(customer)) linked += 1;
+  }
+  return { scanned, linked };
+};
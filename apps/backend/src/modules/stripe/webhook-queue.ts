@@ -0,0 +1,84 @@
+import { StripeWebhookBus, WebhookQueueAdapter } from "@maestro/stripe";
+import { Queue, Worker } from "bullmq";
+import Stripe from "stripe";
+import { REDIS_CONFIG, WEBHOOKS_CONFIG } from "@/config";
+import { attachLoggers, defaultQueueOptions } from "@/utils/queue/config";
+import logger from "@/utils/logger";
+
+const QUEUE_NAME = "stripe-webhooks";
+
+// Completed jobs are kept, and their ids deduplicate redeliveries, for as
+// long as Stripe retries an event (3 days)
+const COMPLETED_JOB_RETENTION_SECONDS = 3 * 24 * 60 * 60;
+
+interface WebhookJobData {
+  subscriber: string;
+  event: Stripe.Event;
+}
+
+let queue: Queue<WebhookJobData> | null = null;
+
+/**
+ * BullMQ-backed queue for durable webhook subscribers, or undefined when
+ * Redis is not configured (durable subscribers then run inline). Stripe
+ * redelivers events, so jobs are keyed by event and subscriber and a
+ * redelivery of a queued or completed event is ignored. Completed jobs are
+ * kept by age rather than count, so no burst of events evicts an id before
+ * Stripe stops retrying it.
+ */
+export const createWebhookQueue = (): WebhookQueueAdapter | undefined => {
+  if (!REDIS_CONFIG.CONNECTION_URL) return undefined;
+  return {
+    enqueue: async ({ subscriber, event }) => {
+      if (!queue) {
+        queue = new Queue<WebhookJobData>(QUEUE_NAME, defaultQueueOptions);
+        attachLoggers(queue, QUEUE_NAME);
+      }
+      await queue.add(
+        subscriber,
+        { subscriber, event },
+        {
+          // BullMQ job ids cannot contain ":"
+          jobId: `${event.id}-${subscriber}`,
+          removeOnComplete: { age: COMPLETED_JOB_RETENTION_SECONDS },
+        },
+      );
+    },
+  };
+};
+
+/**
+ * Starts the worker that runs queued subscriber calls on the bus. A failed
+ * or timed-out call throws, so BullMQ retries it with backoff.
+ * @returns The worker, or null when Redis is not configured.
+ */
+export const startStripeWebhookWorker = (
+  bus: StripeWebhookBus,
+): Worker<WebhookJobData> | null => {
+  if (!REDIS_CONFIG.CONNECTION_URL) return null;
+
+  const worker = new Worker<WebhookJobData>(
+    QUEUE_NAME,
+    async (job) => {
+      const { subscriber, event } = job.data;
+      await bus.runSubscriber(subscriber, event, job.attemptsMade + 1);
+    },
+    {
+      connection: defaultQueueOptions.connection,
+      prefix: defaultQueueOptions.prefix,
+      concurrency: WEBHOOKS_CONFIG.WORKER_CONCURRENCY,
+    },
+  );
+  attachLoggers(worker, QUEUE_NAME);
+
+  logger.info(
+    `Stripe webhook worker started (concurrency ${WEBHOOKS_CONFIG.WORKER_CONCURRENCY})`,
+  );
+  return worker;
+};
+
+/** Closes the producer connection opened by the first durable dispatch. */
+export const closeWebhookQueue = async (): Promise<void> => {
+  await queue?.close();
+  queue = null;
+};
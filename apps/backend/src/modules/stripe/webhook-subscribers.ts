@@ -0,0 +1,80 @@
+import { StripeWebhookBus } from "@maestro/stripe";
+import { WEBHOOKS_CONFIG } from "@/config";
+import logger from "@/utils/logger";
+import { applySubscriptionEvent } from "../entitlements/projection";
+import { applyCatalogEvent } from "./catalog";
+import { applyCustomerEvent } from "./customers";
+import { createWebhookQueue } from "./webhook-queue";
+
+/**
+ * Subscribers for verified Stripe webhook events. Each concern registers
+ * independently and they run in parallel; add fulfilment, analytics or email
+ * as further subscribers rather than extending an existing one. Database
+ * projections are durable: with Redis they are queued and retried, and
+ * their `last_event_at` guards make retries and reordering safe. A durable
+ * subscriber that fails inline or cannot be enqueued fails the webhook
+ * response, so Stripe redelivers the event.
+ */
+export const stripeWebhookBus = new StripeWebhookBus({
+  defaultTimeoutMs: WEBHOOKS_CONFIG.SUBSCRIBER_TIMEOUT_MS,
+  queue: createWebhookQueue(),
+});
+
+// Project subscription changes into entitlements
+stripeWebhookBus.on(
+  [
+    "customer.subscription.created",
+    "customer.subscription.updated",
+    "customer.subscription.deleted",
+  ],
+  (event) => applySubscriptionEvent(event),
+  { name: "entitlements", durable: true },
+);
+
+// Keep the user -> customer mapping current
+stripeWebhookBus.on(
+  ["customer.created", "customer.updated", "customer.deleted"],
+  (event) => applyCustomerEvent(event),
+  { name: "customer-links", durable: true },
+);
+
+// Keep the local catalog mirror current
+stripeWebhookBus.on(
+  [
+    "product.created",
+    "product.updated",
+    "product.deleted",
+    "price.created",
+    "price.updated",
+    "price.deleted",
+  ],
+  (event) => applyCatalogEvent(event),
+  { name: "catalog", durable: true },
+);
+
+stripeWebhookBus.on(
+  "checkout.session.completed",
+  (event) => {
+    logger.info(`Checkout session ${event.data.object.id} completed.`);
+    // TODO: Fulfill the purchase (e.g., grant access, update DB)
+  },
+  { name: "fulfilment" },
+);
+
+stripeWebhookBus.on(
+  "invoice.paid",
+  (event) => {
+    logger.info(`Invoice ${event.data.object.id} paid successfully.`);
+    // TODO: Update billing status, maybe grant access if renewal
+  },
+  { name: "invoice-paid" },
+);
+
+stripeWebhookBus.on(
+  "invoice.payment_failed",
+  (event) => {
+    logger.warn(`Invoice ${event.data.object.id} payment failed.`);
+    // TODO: Notify user, potentially restrict access
+  },
+  { name: "invoice-payment-failed" },
+);
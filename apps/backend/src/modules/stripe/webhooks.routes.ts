@@ -2,19 +2,10 @@ import { Hono } from "hono";
 import { stripe } from "@/lib/stripe/config";
 import logger from "@/utils/logger";
 import Stripe from "stripe";
+import { stripeWebhookBus } from "./webhook-subscribers";
 
 const webhooks = new Hono();
 
-const relevantEvents = new Set([
-  "checkout.session.completed",
-  "customer.subscription.created",
-  "customer.subscription.updated",
-  "customer.subscription.deleted",
-  "invoice.paid",
-  "invoice.payment_failed",
-  // Add other events you need to handle
-]);
-
 webhooks.post("/stripe", async (c) => {
   const signature = c.req.header("stripe-signature");
   const webhookSecret = process.env.STRIPE_WEBHOOK_SECRET;
@@ -43,50 +34,21 @@ webhooks.post("/stripe", async (c) => {
     return c.json({ error: `Webhook Error: ${err.message}` }, 400);
   }
 
-  // Handle the event
-  if (relevantEvents.has(event.type)) {
-    try {
-      switch (event.type) {
-        case "checkout.session.completed":
-          // Handle successful checkout
-          const session = event.data.object as Stripe.Checkout.Session;
-          logger.info(`Checkout session ${session.id} completed.`);
-          // TODO: Fulfill the purchase (e.g., grant access, update DB)
-          break;
-        case "customer.subscription.updated":
-        case "customer.subscription.deleted":
-        case "customer.subscription.created":
-          // Handle subscription changes
-          const subscription = event.data.object as Stripe.Subscription;
-          logger.info(`Subscription ${subscription.id} ${event.type}.`);
-          // TODO: Update subscription status in DB
-          break;
-        case "invoice.paid":
-          // Handle successful payment
-          const invoicePaid = event.data.object as Stripe.Invoice;
-          logger.info(`Invoice ${invoicePaid.id} paid successfully.`);
-          // TODO: Update billing status, maybe grant access if renewal
-          break;
-        case "invoice.payment_failed":
-          // Handle failed payment
-          const invoiceFailed = event.data.object as Stripe.Invoice;
-          logger.warn(`Invoice ${invoiceFailed.id} payment failed.`);
-          // TODO: Notify user, potentially restrict access
-          break;
-        default:
-          logger.warn(`Unhandled relevant event type: ${event.type}`);
-      }
-      // TODO: Consider asynchronous processing for DB updates (e.g., BullMQ)
-    } catch (error: any) {
+  // Fan the event out to its subscribers (see webhook-subscribers.ts)
+  if (stripeWebhookBus.handles(event.type)) {
+    const results = await stripeWebhookBus.publish(event);
+    const failed = results.filter((result) => result.error);
+    for (const { subscriber, status, error } of failed) {
       logger.error(
-        `Error handling Stripe event ${event.type} (${event.id}): ${error.message}`,
-        { stack: error.stack },
+        `Stripe subscriber ${subscriber} ${status} on ${event.type} (${event.id}): ${error!.message}`,
+        { stack: error!.stack },
       );
-      // Still return 200 to Stripe, but log the internal error
-      return c.json({
-        received: true,
-        error: "Internal server error occurred",
-      });
+    }
+    // Durable subscribers (entitlements, customer links, catalog) rely on
+    // Stripe redelivering the event; failures of best-effort ones are only
+    // logged.
+    if (failed.some((result) => result.durable)) {
+      return c.json({ error: "Internal server error occurred" }, 500);
     }
   }
 
@@ -0,0 +1,38 @@
+import { UsageCheckpoint, UsageCheckpointState } from "@maestro/stripe";
+import { mkdir, readFile, rename, writeFile } from "fs/promises";
+import { dirname } from "path";
+
+/**
+ * Stores a `MemoryUsageStore`'s state in a JSON file. Writes go to a
+ * temporary file that is renamed over the checkpoint, so a crash mid-write
+ * leaves the previous checkpoint intact.
+ * @param path Checkpoint file, created with its directory on first save.
+ */
+export const createFileCheckpoint = (path: string): UsageCheckpoint => {
+  // Saves are serialized so an older state never overwrites a newer one.
+  let lastSave: Promise<void> = Promise.resolve();
+
+  const write = async (state: UsageCheckpointState) => {
+    await mkdir(dirname(path), { recursive: true });
+    const temporary = `${path}.${process.pid}.tmp`;
+    await writeFile(temporary, JSON.stringify(state));
+    await rename(temporary, path);
+  };
+
+  return {
+    load: async () => {
+      try {
+        return JSON.parse(await readFile(path, "utf8")) as UsageCheckpointState;
+      } catch (error: any) {
+        if (error.code === "ENOENT") return null;
+        throw error;
+      }
+    },
+    save: (state) => {
+      // Snapshot now: the store keeps mutating its state after this call.
+      const snapshot = structuredClone(state);
+      lastSave = lastSave.catch(() => undefined).then(() => write(snapshot));
+      return lastSave;
+    },
+  };
+};
@@ -0,0 +1,127 @@
+import {
+  MemoryUsageStore,
+  UsageAggregator,
+  UsageStore,
+} from "@maestro/stripe";
+import { USAGE_CONFIG } from "@/config";
+import { getRedis } from "@/lib/redis";
+import { stripeBatch } from "@/lib/stripe/config";
+import logger from "@/utils/logger";
+import { createFileCheckpoint } from "./file-checkpoint";
+import { RedisUsageStore } from "./redis-store";
+
+interface UsageMeters {
+  primary: UsageAggregator;
+  /** In-memory, checkpointed store used while Redis is unreachable. */
+  fallback: UsageAggregator | null;
+}
+
+let meters: UsageMeters | null = null;
+let fallbackActive = false;
+
+const createAggregator = (
+  eventName: string,
+  store: UsageStore,
+): UsageAggregator =>
+  new UsageAggregator({
+    stripe: stripeBatch,
+    eventName,
+    store,
+    flushIntervalMs: USAGE_CONFIG.FLUSH_INTERVAL_MS,
+    checkpointIntervalMs: USAGE_CONFIG.CHECKPOINT_INTERVAL_MS,
+    onError: (error, customerId, batchId) => {
+      const message = error instanceof Error ? error.message : String(error);
+      logger.warn(
+        `Usage report failed (batch ${batchId}, customer ${customerId}): ${message}`,
+      );
+    },
+  });
+
+const createMemoryStore = () =>
+  new MemoryUsageStore(createFileCheckpoint(USAGE_CONFIG.CHECKPOINT_PATH));
+
+const getUsageMeters = (): UsageMeters | null => {
+  const eventName = USAGE_CONFIG.METER_EVENT_NAME;
+  if (!eventName) return null;
+  if (!meters) {
+    const redis = getRedis();
+    meters = redis
+      ? {
+          primary: createAggregator(
+            eventName,
+            new RedisUsageStore(redis, eventName),
+          ),
+          fallback: createAggregator(eventName, createMemoryStore()),
+        }
+      : {
+          primary: createAggregator(eventName, createMemoryStore()),
+          fallback: null,
+        };
+  }
+  return meters;
+};
+
+/**
+ * Records billable usage for a customer, e.g. the number of analytics events
+ * ingested (see usage.routes.ts). Reported to Stripe on the next flush. When
+ * the Redis store fails (it does not queue commands while disconnected), the
+ * usage goes to the local, checkpointed store instead of being lost; both
+ * stores report under their own batch ids, so nothing is counted twice.
+ * Never throws, so callers on hot paths need no error handling.
+ * @param customerId The Stripe customer id.
+ * @param value Usage quantity (default: 1).
+ */
+export const recordUsage = async (
+  customerId: string,
+  value = 1,
+): Promise<void> => {
+  const usage = getUsageMeters();
+  if (!usage) return;
+  const { primary, fallback } = usage;
+  try {
+    await primary.record(customerId, value);
+    if (fallbackActive) {
+      fallbackActive = false;
+      logger.info("Usage store recovered; recording to it again");
+    }
+    return;
+  } catch (error) {
+    if (!fallback) {
+      logger.error(`Failed to record usage for ${customerId}:`, error);
+      return;
+    }
+    if (!fallbackActive) {
+      fallbackActive = true;
+      logger.warn("Usage store unavailable; recording locally:", error);
+    }
+  }
+  try {
+    await fallback.record(customerId, value);
+  } catch (error) {
+    logger.error(`Failed to record usage for ${customerId}:`, error);
+  }
+};
+
+/**
+ * Starts periodic usage flushing and checkpointing.
+ * @returns A handle that stops the meter and reports pending usage, or null
+ * when metering is disabled.
+ */
+export const startUsageMeter = (): { stop: () => Promise<void> } | null => {
+  const usage = getUsageMeters();
+  if (!usage) {
+    logger.info("Usage metering disabled");
+    return null;
+  }
+  usage.primary.start();
+  usage.fallback?.start();
+  logger.info(
+    `Usage metering started (${USAGE_CONFIG.METER_EVENT_NAME}, ` +
+      `flush every ${USAGE_CONFIG.FLUSH_INTERVAL_MS}ms)`,
+  );
+  return {
+    stop: async () => {
+      await Promise.all([usage.primary.stop(), usage.fallback?.stop()]);
+    },
+  };
+};
@@ -0,0 +1,111 @@
+import {
+  createUsageBatchId,
+  UsageBatch,
+  UsageStore,
+} from "@maestro/stripe";
+import type Redis from "ioredis";
+import { redisKey } from "@/lib/redis";
+
+// Renames the pending hash to a batch hash and indexes it, in one step, so
+// no increment lands between reading and clearing the totals.
+const DRAIN_SCRIPT = `
+if redis.call("EXISTS", KEYS[1]) == 0 then return 0 end
+redis.call("RENAME", KEYS[1], KEYS[2])
+redis.call("HSET", KEYS[3], ARGV[1], ARGV[2])
+return 1
+`;
+
+// Removes reported customers and drops the batch once it is empty.
+const ACKNOWLEDGE_SCRIPT = `
+for i = 2, #ARGV do redis.call("HDEL", KEYS[1], ARGV[i]) end
+if redis.call("HLEN", KEYS[1]) == 0 then
+  redis.call("HDEL", KEYS[2], ARGV[1])
+end
+return 1
+`;
+
+/**
+ * Usage store shared by every instance: increments are `HINCRBY`s on one
+ * hash per meter and drained batches stay in Redis until acknowledged, so
+ * no usage is lost when an instance crashes. Batches are claimed before
+ * reporting, so only one instance sends each.
+ */
+export class RedisUsageStore implements UsageStore {
+  private readonly pendingKey: string;
+  private readonly batchesKey: string;
+
+  constructor(
+    private readonly redis: Redis,
+    private readonly eventName: string,
+  ) {
+    this.pendingKey = redisKey("usage", eventName, "pending");
+    this.batchesKey = redisKey("usage", eventName, "batches");
+  }
+
+  async increment(customerId: string, value: number): Promise<void> {
+    await this.redis.hincrby(this.pendingKey, customerId, value);
+  }
+
+  async drain(): Promise<UsageBatch | null> {
+    const batch = { id: createUsageBatchId(), createdAt: Date.now() };
+    const drained = await this.redis.eval(
+      DRAIN_SCRIPT,
+      3,
+      this.pendingKey,
+      this.batchKey(batch.id),
+      this.batchesKey,
+      batch.id,
+      String(batch.createdAt),
+    );
+    if (drained !== 1) return null;
+    return { ...batch, totals: await this.readTotals(batch.id) };
+  }
+
+  async unacknowledged(): Promise<UsageBatch[]> {
+    const index = await this.redis.hgetall(this.batchesKey);
+    const batches = await Promise.all(
+      Object.entries(index).map(async ([id, createdAt]) => ({
+        id,
+        createdAt: Number(createdAt),
+        totals: await this.readTotals(id),
+      })),
+    );
+    return batches.sort((a, b) => a.createdAt - b.createdAt);
+  }
+
+  async acknowledge(batchId: string, customerIds: string[]): Promise<void> {
+    await this.redis.eval(
+      ACKNOWLEDGE_SCRIPT,
+      2,
+      this.batchKey(batchId),
+      this.batchesKey,
+      batchId,
+      ...customerIds,
+    );
+  }
+
+  async claim(batchId: string, ttlMs: number): Promise<boolean> {
+    const claimed = await this.redis.set(
+      redisKey("usage", this.eventName, "claim", batchId),
+      "1",
+      "PX",
+      ttlMs,
+      "NX",
+    );
+    return claimed === "OK";
+  }
+
+  private batchKey(batchId: string) {
+    return redisKey("usage", this.eventName, "batch", batchId);
+  }
+
+  private async readTotals(batchId: string): Promise<Record<string, number>> {
+    const raw = await this.redis.hgetall(this.batchKey(batchId));
+    return Object.fromEntries(
+      Object.entries(raw).map(([customerId, value]) => [
+        customerId,
+        Number(value),
+      ]),
+    );
+  }
+}
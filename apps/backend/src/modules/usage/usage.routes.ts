@@ -0,0 +1,82 @@
+import { fetchStripeCustomer } from "@maestro/supabase";
+import { Hono } from "hono";
+import { USAGE_CONFIG } from "@/config";
+import { supabaseAdmin } from "@/lib/supabase";
+import { LruCache } from "@/utils/lru-cache";
+import logger from "@/utils/logger";
+import { recordUsage } from "./meter";
+
+// Profile id -> Stripe customer id (null: no customer, nothing to bill)
+const customerIds = new LruCache<string, string | null>(10_000, 5 * 60_000);
+
+const customerIdFor = async (profileId: string): Promise<string | null> => {
+  const cached = customerIds.get(profileId);
+  if (cached !== undefined) return cached;
+  const { data, error } = await fetchStripeCustomer({
+    supabase: supabaseAdmin,
+    profileId,
+  });
+  if (error) {
+    throw new Error(`Failed to look up Stripe customer: ${error.message}`);
+  }
+  const customerId = data?.stripe_customer_id ?? null;
+  customerIds.set(profileId, customerId);
+  return customerId;
+};
+
+const usage = new Hono();
+
+/**
+ * Records analytics events ingested by the gateway as metered usage.
+ * Body: `{ "counts": { "<profile id>": 42 } }`. Every customer is resolved
+ * before anything is recorded, so a failed lookup fails the whole report and
+ * the gateway's retry cannot count part of it twice.
+ */
+usage.post("/analytics-events", async (c) => {
+  const secret = USAGE_CONFIG.INGEST_SECRET;
+  if (!secret || c.req.header("x-usage-secret") !== secret) {
+    return c.json({ error: "Unauthorized" }, 401);
+  }
+
+  const body = (await c.req.json().catch(() => null)) as {
+    counts?: unknown;
+  } | null;
+  const counts =
+    body?.counts && typeof body.counts === "object"
+      ? Object.entries(body.counts as Record<string, unknown>).filter(
+          (entry): entry is [string, number] =>
+            Number.isInteger(entry[1]) && (entry[1] as number) > 0,
+        )
+      : [];
+  if (counts.length === 0) {
+    return c.json({ error: "No valid counts" }, 400);
+  }
+
+  let resolved: (string | null)[];
+  try {
+    resolved = await Promise.all(
+      counts.map(([profileId]) => customerIdFor(profileId)),
+    );
+  } catch (error) {
+    logger.error("Failed to resolve customers for usage:", error);
+    return c.json({ error: "Customer lookup failed" }, 503);
+  }
+
+  let recorded = 0;
+  let skipped = 0;
+  await Promise.all(
+    counts.map(async ([, count], i) => {
+      const customerId = resolved[i];
+      if (!customerId) {
+        // Users without a Stripe customer have no metered plan
+        skipped += count;
+        return;
+      }
+      await recordUsage(customerId, count);
+      recorded += count;
+    }),
+  );
+  return c.json({ recorded, skipped });
+});
+
+export default usage;
@@ -0,0 +1,16 @@
+import { backfillStripeCustomers } from "@/modules/stripe/customers";
+import logger from "@/utils/logger";
+
+// Links existing Stripe customers to users: pnpm stripe:backfill-customers
+const main = async () => {
+  logger.info("Backfilling Stripe customer links...");
+  const { scanned, linked } = await backfillStripeCustomers();
+  logger.info(`Stripe customers scanned: ${scanned}, linked: ${linked}`);
+};
+
+main()
+  .then(() => process.exit(0))
+  .catch((error) => {
+    logger.error("Stripe customer backfill failed:", error);
+    process.exit(1);
+  });
@@ -0,0 +1,148 @@
+import {
+  MemoryUsageStore,
+  UsageAggregator,
+  UsageFlushResult,
+  UsageStore,
+} from "@maestro/stripe";
+import { getRedis } from "@/lib/redis";
+import { stripeBatch } from "@/lib/stripe/config";
+import { RedisUsageStore } from "@/modules/usage/redis-store";
+import logger from "@/utils/logger";
+
+// Usage metering load test against the local Stripe stand-in:
+//   pnpm stripe:stand-in   (optionally STRIPE_STAND_IN_METER_FAILURE_RATE=0.1)
+//   STRIPE_API_BASE=http://localhost:12111 pnpm bench:usage
+// Records usage increments as fast as possible while flushing, then checks
+// that the stand-in's meter totals match exactly (no loss, no double count).
+//   BENCH_USAGE_EVENTS      increments to record (default: 100000)
+//   BENCH_USAGE_CUSTOMERS   customers to spread them over (default: 10)
+//   BENCH_USAGE_FLUSH_MS    flush interval (default: 250)
+//   BENCH_USAGE_STORE       "memory" or "redis" (default: memory)
+
+const apiBase = process.env.STRIPE_API_BASE;
+const total = parseInt(process.env.BENCH_USAGE_EVENTS || "100000", 10);
+const customerCount = parseInt(process.env.BENCH_USAGE_CUSTOMERS || "10", 10);
+const flushIntervalMs = parseInt(process.env.BENCH_USAGE_FLUSH_MS || "250", 10);
+const storeKind = process.env.BENCH_USAGE_STORE || "memory";
+
+// Unique per run, so totals from earlier runs do not mix in.
+const eventName = `bench_usage_${Date.now()}`;
+
+const createStore = (): UsageStore => {
+  if (storeKind !== "redis") return new MemoryUsageStore();
+  const redis = getRedis();
+  if (!redis) throw new Error("BENCH_USAGE_STORE=redis needs BULLMQ_REDIS_URL");
+  return new RedisUsageStore(redis, eventName);
+};
+
+const addResults = (sum: UsageFlushResult, result: UsageFlushResult) => {
+  sum.reported += result.reported;
+  sum.rejected += result.rejected;
+  sum.failed += result.failed;
+  sum.usage += result.usage;
+};
+
+const main = async () => {
+  if (!apiBase) {
+    throw new Error("Set STRIPE_API_BASE to the stand-in, not live Stripe");
+  }
+
+  const customers = (
+    await stripeBatch.customers.list({ limit: customerCount })
+  ).data.map((customer) => customer.id);
+  if (customers.length === 0) throw new Error("The stand-in has no customers");
+
+  const store = createStore();
+  const totals: UsageFlushResult = {
+    reported: 0,
+    rejected: 0,
+    failed: 0,
+    usage: 0,
+  };
+  let errors = 0;
+  const aggregator = new UsageAggregator({
+    stripe: stripeBatch,
+    eventName,
+    store,
+    onError: () => {
+      errors += 1;
+    },
+  });
+
+  logger.info(
+    `Recording ${total} usage increments for ${customers.length} customers ` +
+      `(${storeKind} store, flush every ${flushIntervalMs}ms)`,
+  );
+
+  const expected: Record<string, number> = {};
+  const startedAt = performance.now();
+  // One flush at a time, so each flush's result is counted once
+  let flushing: Promise<void> | null = null;
+  const timer = setInterval(() => {
+    if (flushing) return;
+    flushing = aggregator
+      .flush()
+      .then((result) => addResults(totals, result))
+      .catch((error) => logger.warn("Usage flush failed:", error))
+      .finally(() => {
+        flushing = null;
+      });
+  }, flushIntervalMs);
+
+  for (let index = 0; index < total; index += 1) {
+    const customerId = customers[index % customers.length];
+    expected[customerId] = (expected[customerId] ?? 0) + 1;
+    await aggregator.record(customerId);
+    // Yield now and then so flushes run while usage is recorded
+    if (index % 1000 === 999) await new Promise(setImmediate);
+  }
+  const recordSeconds = (performance.now() - startedAt) / 1000;
+
+  clearInterval(timer);
+  await flushing;
+  // Drain: transient failures stay in their batch until a flush succeeds
+  for (let attempt = 0; attempt < 10; attempt += 1) {
+    addResults(totals, await aggregator.flush());
+    if ((await store.unacknowledged()).length === 0) break;
+  }
+  const elapsedSeconds = (performance.now() - startedAt) / 1000;
+
+  const response = await fetch(`${apiBase}/stand-in/meter-totals`);
+  const recorded: Record<string, number> =
+    ((await response.json()) as Record<string, Record<string, number>>)[
+      eventName
+    ] ?? {};
+  const mismatches = customers.filter(
+    (customerId) => (recorded[customerId] ?? 0) !== expected[customerId],
+  );
+
+  logger.info("Usage benchmark results", {
+    increments: total,
+    meterEvents: totals.reported,
+    incrementsPerMeterEvent: Number(
+      (total / Math.max(totals.reported, 1)).toFixed(1),
+    ),
+    rejected: totals.rejected,
+    retriedFailures: totals.failed,
+    reportErrors: errors,
+    recordsPerSecond: Math.round(total / recordSeconds),
+    seconds: Number(elapsedSeconds.toFixed(2)),
+    totalsMatch: mismatches.length === 0,
+  });
+  if (mismatches.length > 0) {
+    for (const customerId of mismatches) {
+      logger.error(
+        `Usage mismatch for ${customerId}: expected ${expected[customerId]}, ` +
+          `Stripe stand-in has ${recorded[customerId] ?? 0}`,
+      );
+    }
+    throw new Error(`${mismatches.length} customers have wrong usage totals`);
+  }
+};
+
+main()
+  .then(() => process.exit(0))
+  .catch((error) => {
+    logger.error("Usage benchmark failed:", error);
+    process.exit(1);
+  });
@@ -0,0 +1,115 @@
+import { SERVER_CONFIG } from "@/config";
+import {
+  createEvent,
+  deliverEvent,
+  DeliveryResult,
+} from "@/dev/stripe-stand-in/events";
+import { createFixtureStore } from "@/dev/stripe-stand-in/store";
+import logger from "@/utils/logger";
+
+// End-to-end webhook benchmark: pnpm bench:webhooks
+// Sends signed events to a running backend and reports throughput and
+// latency. Run the backend with STRIPE_API_BASE pointing at the stand-in
+// (pnpm stripe:stand-in) so handlers that call Stripe stay offline.
+//   BENCH_WEBHOOK_URL   target endpoint (default: this backend's /webhooks/stripe)
+//   BENCH_EVENTS        number of events (default: 1000)
+//   BENCH_RATE          events per second, 0 for as fast as possible (default: 0)
+//   BENCH_CONCURRENCY   maximum requests in flight (default: 50)
+//   BENCH_EVENT_TYPES   comma-separated mix (default: product.updated,customer.subscription.updated)
+
+const url =
+  process.env.BENCH_WEBHOOK_URL ||
+  `http://localhost:${SERVER_CONFIG.PORT}/webhooks/stripe`;
+const total = parseInt(process.env.BENCH_EVENTS || "1000", 10);
+const rate = parseFloat(process.env.BENCH_RATE || "0");
+const concurrency = parseInt(process.env.BENCH_CONCURRENCY || "50", 10);
+const eventTypes = (
+  process.env.BENCH_EVENT_TYPES ||
+  "product.updated,customer.subscription.updated"
+)
+  .split(",")
+  .map((type) => type.trim());
+
+const percentile = (sorted: number[], p: number) =>
+  sorted.length === 0
+    ? 0
+    : sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+
+const main = async () => {
+  const secret = process.env.STRIPE_WEBHOOK_SECRET;
+  if (!secret) throw new Error("STRIPE_WEBHOOK_SECRET is not set");
+
+  const store = createFixtureStore(100);
+  const objects: Record<string, unknown[]> = {
+    product: store.list("products", { limit: 100 }).data,
+    price: store.list("prices", { limit: 100 }).data,
+    customer: store.list("customers", { limit: 100 }).data,
+    "customer.subscription": store.list("subscriptions", { limit: 100 }).data,
+  };
+  const objectFor = (type: string, index: number) => {
+    const pool = objects[type.slice(0, type.lastIndexOf("."))];
+    if (!pool) throw new Error(`Unsupported event type: ${type}`);
+    return pool[index % pool.length];
+  };
+
+  logger.info(
+    `Sending ${total} events to ${url} ` +
+      `(rate: ${rate || "max"}/s, concurrency: ${concurrency})`,
+  );
+
+  const results: DeliveryResult[] = [];
+  const inFlight = new Set<Promise<void>>();
+  const startedAt = performance.now();
+
+  for (let index = 0; index < total; index += 1) {
+    if (rate > 0) {
+      const dueAt = startedAt + (index / rate) * 1000;
+      const wait = dueAt - performance.now();
+      if (wait > 0) await new Promise((resolve) => setTimeout(resolve, wait));
+    }
+    while (inFlight.size >= concurrency) await Promise.race(inFlight);
+
+    const type = eventTypes[index % eventTypes.length];
+    const delivery = deliverEvent(
+      url,
+      secret,
+      createEvent(type, objectFor(type, index)),
+    ).then((result) => {
+      results.push(result);
+      inFlight.delete(delivery);
+    });
+    inFlight.add(delivery);
+  }
+  await Promise.all(inFlight);
+
+  const elapsedSeconds = (performance.now() - startedAt) / 1000;
+  const failed = results.filter(
+    ({ status, error }) => status < 200 || status >= 300 || error,
+  );
+  const latencies = results
+    .map(({ latencyMs }) => latencyMs)
+    .sort((a, b) => a - b);
+
+  logger.info("Webhook benchmark results", {
+    events: results.length,
+    failed: failed.length,
+    seconds: Number(elapsedSeconds.toFixed(2)),
+    eventsPerSecond: Number((results.length / elapsedSeconds).toFixed(1)),
+    latencyMs: {
+      p50: Number(percentile(latencies, 0.5).toFixed(1)),
+      p95: Number(percentile(latencies, 0.95).toFixed(1)),
+      p99: Number(percentile(latencies, 0.99).toFixed(1)),
+      max: Number((latencies[latencies.length - 1] ?? 0).toFixed(1)),
+    },
+  });
+  if (failed.length > 0) {
+    logger.warn(`First failure: ${failed[0].error ?? failed[0].status}`);
+  }
+};
+
+main()
+  .then(() => process.exit(0))
+  .catch((error) => {
+    logger.error("Webhook benchmark failed:", error);
+    process.exit(1);
+  });
@@ -0,0 +1,19 @@
+import { reconcileEntitlements } from "@/modules/entitlements/reconcile";
+import logger from "@/utils/logger";
+
+// On-demand billing reconciliation: pnpm billing:reconcile
+const main = async () => {
+  logger.info("Reconciling entitlements with Stripe...");
+  const { scanned, missing, changed, repaired } = await reconcileEntitlements();
+  logger.info(
+    `Billing reconciled: ${scanned} subscriptions scanned, ` +
+      `${missing} missing, ${changed} outdated, ${repaired} repaired`,
+  );
+};
+
+main()
+  .then(() => process.exit(0))
+  .catch((error) => {
+    logger.error("Billing reconciliation failed:", error);
+    process.exit(1);
+  });
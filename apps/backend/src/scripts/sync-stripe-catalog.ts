@@ -0,0 +1,19 @@
+import { syncStripeCatalog } from "@/modules/stripe/catalog";
+import logger from "@/utils/logger";
+
+// Full re-sync of the Stripe catalog mirror: pnpm stripe:sync-catalog
+const main = async () => {
+  logger.info("Syncing Stripe catalog mirror...");
+  const { products, prices, removed } = await syncStripeCatalog();
+  logger.info(
+    `Stripe catalog synced: ${products} products, ${prices} prices, ` +
+      `${removed?.products ?? 0} products and ${removed?.prices ?? 0} prices removed`,
+  );
+};
+
+main()
+  .then(() => process.exit(0))
+  .catch((error) => {
+    logger.error("Stripe catalog sync failed:", error);
+    process.exit(1);
+  });
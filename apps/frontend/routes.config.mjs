@@ -0,0 +1,36 @@
+// Route access rules, compiled by `pnpm routes:generate` (run before dev and
+// build) into src/lib/routes/manifest.generated.ts and the middleware
+// matcher. A pattern is an exact path ("/") or a path and everything below
+// it ("/ingest/**"). Paths in no list are protected.
+
+/** @type {import("./scripts/generate-route-manifest.mjs").RouteConfig} */
+const routes = {
+  // Never run middleware: proxies (see rewrites in next.config.ts), static
+  // assets and routes that authenticate themselves
+  excluded: [
+    "/ingest/**",
+    "/_next/static/**",
+    "/_next/image/**",
+    "/favicon.ico",
+    "/api/revalidate/**", // Called by the backend with x-revalidate-secret
+  ],
+  // No session needed; also excluded from the middleware
+  public: [
+    "/",
+    "/auth/update-password/**",
+    "/auth/verify-request/**",
+    "/auth/verify-otp/**",
+    "/auth/callback/**", // Supabase auth callback
+    "/auth/auth-error/**",
+    "/login/**",
+    "/register/**",
+    "/forgot-password/**",
+    "/update-password/**",
+  ],
+  // Public, but signed-in users are sent to the dashboard
+  authOnly: ["/auth/login/**", "/auth/register/**", "/auth/forgot-password/**"],
+  // Static files matched by extension anywhere
+  staticExtensions: ["svg", "png", "jpg", "jpeg", "gif", "webp"],
+};
+
+export default routes;
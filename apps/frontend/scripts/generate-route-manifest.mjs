@@ -0,0 +1,151 @@
+// Compiles routes.config.mjs into a prefix trie for the middleware
+// (src/lib/routes/manifest.generated.ts) and rewrites the `matcher` in
+// src/middleware.ts so excluded and public routes never invoke it.
+//   pnpm routes:generate           write both files
+//   pnpm routes:generate --check   fail if either is out of date (CI)
+
+import { readFile, writeFile } from "fs/promises";
+import { dirname, join } from "path";
+import { fileURLToPath } from "url";
+import routes from "../routes.config.mjs";
+
+/**
+ * @typedef {{
+ *   excluded: string[];
+ *   public: string[];
+ *   authOnly: string[];
+ *   staticExtensions: string[];
+ * }} RouteConfig
+ */
+
+const root = join(dirname(fileURLToPath(import.meta.url)), "..");
+const manifestPath = join(root, "src/lib/routes/manifest.generated.ts");
+const middlewarePath = join(root, "src/middleware.ts");
+const MATCHER_START = "// <route-matcher> generated by pnpm routes:generate";
+const MATCHER_END = "// </route-matcher>";
+
+/** Splits "/a/b/**" into { segments: ["a", "b"], subtree: true }. */
+const parsePattern = (pattern) => {
+  if (!pattern.startsWith("/")) {
+    throw new Error(`Route pattern must start with "/": ${pattern}`);
+  }
+  const subtree = pattern.endsWith("/**");
+  const path = subtree ? pattern.slice(0, -3) : pattern;
+  const segments = path.split("/").filter(Boolean);
+  if (segments.some((segment) => segment.includes("*"))) {
+    throw new Error(`Only a trailing "/**" wildcard is supported: ${pattern}`);
+  }
+  return { pattern, segments, subtree };
+};
+
+const buildTrie = () => {
+  const trie = {};
+  const kinds = [
+    ["excluded", routes.excluded],
+    ["public", routes.public],
+    ["auth-only", routes.authOnly],
+  ];
+  for (const [kind, patterns] of kinds) {
+    for (const { pattern, segments, subtree } of patterns.map(parsePattern)) {
+      let node = trie;
+      for (const segment of segments) {
+        node.children ??= {};
+        node = node.children[segment] ??= {};
+      }
+      const key = subtree ? "subtree" : "exact";
+      if (node[key] && node[key] !== kind) {
+        throw new Error(`${pattern} is both ${node[key]} and ${kind}`);
+      }
+      node[key] = kind;
+    }
+  }
+  return trie;
+};
+
+// Auth-only routes need the middleware, so no skipped subtree may cover one.
+const checkCoverage = () => {
+  const skipped = [...routes.excluded, ...routes.public]
+    .map(parsePattern)
+    .filter(({ subtree }) => subtree);
+  for (const authOnly of routes.authOnly.map(parsePattern)) {
+    const covering = skipped.find(
+      ({ segments }) =>
+        segments.length <= authOnly.segments.length &&
+        segments.every((segment, i) => segment === authOnly.segments[i]),
+    );
+    if (covering) {
+      throw new Error(
+        `${authOnly.pattern} is auth-only but ${covering.pattern} skips the middleware`,
+      );
+    }
+  }
+};
+
+const escapeRegex = (value) => value.replace(/[.+?^${}()|[\]\\]/g, "\\$&");
+
+const buildMatcher = () => {
+  const alternatives = [...routes.excluded, ...routes.public]
+    .map(parsePattern)
+    .map(({ segments, subtree }) => {
+      const path = segments.map(escapeRegex).join("/");
+      if (!path) return subtree ? "" : "$";
+      return subtree ? `${path}(?:/|$)` : `${path}$`;
+    });
+  const extensions = routes.staticExtensions.map(escapeRegex).join("|");
+  if (extensions) alternatives.push(`.*\\.(?:${extensions})$`);
+  return `/((?!${alternatives.join("|")}).*)`;
+};
+
+const renderManifest = (trie) =>
+  `// Generated by scripts/generate-route-manifest.mjs from routes.config.mjs.
+// Do not edit; change routes.config.mjs and run \`pnpm routes:generate\`.
+import type { RouteTrieNode } from "./classify";
+
+export const ROUTE_TRIE: RouteTrieNode = ${JSON.stringify(trie, null, 2)};
+`;
+
+const renderMiddleware = (source, matcher) => {
+  const start = source.indexOf(MATCHER_START);
+  const end = source.indexOf(MATCHER_END);
+  if (start === -1 || end === -1) {
+    throw new Error(`Matcher markers not found in ${middlewarePath}`);
+  }
+  const indent = source.slice(source.lastIndexOf("\n", start) + 1, start);
+  return (
+    source.slice(0, start + MATCHER_START.length) +
+    `\n${indent}${JSON.stringify(matcher)},\n${indent}` +
+    source.slice(end)
+  );
+};
+
+const main = async () => {
+  const check = process.argv.includes("--check");
+  checkCoverage();
+
+  const outputs = [
+    [manifestPath, renderManifest(buildTrie())],
+    [
+      middlewarePath,
+      renderMiddleware(await readFile(middlewarePath, "utf8"), buildMatcher()),
+    ],
+  ];
+
+  let stale = false;
+  for (const [path, contents] of outputs) {
+    const current = await readFile(path, "utf8").catch(() => null);
+    if (current === contents) continue;
+    if (check) {
+      console.error(`${path} is out of date; run pnpm routes:generate`);
+      stale = true;
+    } else {
+      await writeFile(path, contents);
+      console.log(`Wrote ${path}`);
+    }
+  }
+  if (stale) process.exit(1);
+};
+
+main().catch((error) => {
+  console.error(error.message);
+  process.exit(1);
+});
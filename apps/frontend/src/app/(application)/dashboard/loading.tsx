@@ -0,0 +1,21 @@
+import { Skeleton } from "@/components/ui/skeleton";
+import { PlanCardSkeleton } from "@/features/dashboard/components/plan-card";
+import { WelcomeCardSkeleton } from "@/features/dashboard/components/welcome-card";
+
+// Shown inside the app shell while the page checks the session.
+export default function DashboardLoading() {
+  return (
+    <>
+      <header className="flex h-14 items-center border-b border-border px-4">
+        <Skeleton className="h-6 w-40" />
+      </header>
+      <div className="container p-4">
+        <Skeleton className="h-9 w-48 mb-4" />
+        <div className="grid gap-4 md:grid-cols-2">
+          <WelcomeCardSkeleton />
+          <PlanCardSkeleton />
+        </div>
+      </div>
+    </>
+  );
+}
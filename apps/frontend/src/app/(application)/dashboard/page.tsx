@@ -1,20 +1,28 @@
+import { Suspense } from "react";
 import { protectedRoute } from "@/lib/auth";
-import { createSupabaseServerClient } from "@/lib/supabase/server";
+import { getProfile } from "@/lib/data/profile";
+import { getEntitlements } from "@/lib/entitlements";
 import { Button } from "@/components/ui/button";
 import { executeSignOut } from "@/features/auth/actions/auth-actions";
+import {
+  PlanCard,
+  PlanCardSkeleton,
+} from "@/features/dashboard/components/plan-card";
+import {
+  WelcomeCard,
+  WelcomeCardSkeleton,
+} from "@/features/dashboard/components/welcome-card";
 import { PageHeader } from "@/features/layout/components/page-header";
 
 // Server component to display user info and a logout button
 export default async function DashboardPage() {
   const user = await protectedRoute("/login"); // Protect this page, redirect to /login if not authed
-  const supabase = await createSupabaseServerClient();
 
-  // Example: Fetch user profile data if you have a profiles table
-  const { data: profile } = await supabase
-    .from("profiles")
-    .select("full_name")
-    .eq("id", user.id)
-    .single();
+  // Start every widget's query now so they run in parallel; each widget reads
+  // the same request-cached result behind its own Suspense boundary, so the
+  // page streams without waiting on the slowest one.
+  void getProfile(user.id);
+  void getEntitlements(user.id);
 
   const handleSignOut = async () => {
     "use server";
@@ -33,8 +41,14 @@ export default async function DashboardPage() {
       />
       <div className="container p-4">
         <h1 className="text-3xl font-bold mb-4">Dashboard</h1>
-        <p className="mb-2">Welcome, {profile?.full_name || user.email}!</p>
-        <p className="mb-4 text-sm text-muted-foreground">User ID: {user.id}</p>
+        <div className="grid gap-4 mb-4 md:grid-cols-2">
+          <Suspense fallback={<WelcomeCardSkeleton />}>
+            <WelcomeCard user={user} />
+          </Suspense>
+          <Suspense fallback={<PlanCardSkeleton />}>
+            <PlanCard userId={user.id} />
+          </Suspense>
+        </div>
 
         <form action={handleSignOut}>
           <Button type="submit" variant="outline">
@@ -1,5 +1,35 @@
-const ApplicationLayout = ({ children }: { children: React.ReactNode }) => {
-  return <>{children}</>;
+import { Suspense } from "react";
+import { cookies } from "next/headers";
+import { SidebarInset, SidebarProvider } from "@/components/ui/sidebar";
+import { AppSidebar } from "@/features/layout/components/app-sidebar";
+import {
+  SidebarUser,
+  SidebarUserSkeleton,
+} from "@/features/layout/components/sidebar-user";
+
+// The shell waits on no data, so it is sent in the first flush; pages and
+// widgets that fetch stream in behind their own Suspense boundaries.
+const ApplicationLayout = async ({
+  children,
+}: {
+  children: React.ReactNode;
+}) => {
+  // Restore the state the sidebar saves in its cookie when toggled
+  const defaultOpen =
+    (await cookies()).get("sidebar_state")?.value !== "false";
+
+  return (
+    <SidebarProvider defaultOpen={defaultOpen}>
+      <AppSidebar
+        footer={
+          <Suspense fallback={<SidebarUserSkeleton />}>
+            <SidebarUser />
+          </Suspense>
+        }
+      />
+      <SidebarInset>{children}</SidebarInset>
+    </SidebarProvider>
+  );
 };
 
 export default ApplicationLayout;
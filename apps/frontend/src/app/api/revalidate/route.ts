@@ -0,0 +1,38 @@
+import { revalidateTag } from "next/cache";
+import { NextRequest, NextResponse } from "next/server";
+import { isRevalidatableTag } from "@/lib/data/cache-tags";
+
+// Matches the backend's batch size (lib/revalidate.ts)
+const MAX_TAGS_PER_REQUEST = 100;
+
+/**
+ * Invalidates cached data by tag. Called by the backend after it updates a
+ * mirror (e.g. the Stripe catalog) or a user's entitlements, authenticated
+ * with a shared secret.
+ * Body: `{ "tags": ["stripe-catalog", "entitlements:<user id>"] }`.
+ */
+export async function POST(request: NextRequest) {
+  const secret = process.env.REVALIDATE_SECRET;
+  if (!secret || request.headers.get("x-revalidate-secret") !== secret) {
+    return NextResponse.json({ error: "Unauthorized" }, { status: 401 });
+  }
+
+  const body = (await request.json().catch(() => null)) as {
+    tags?: unknown;
+  } | null;
+  if (Array.isArray(body?.tags) && body.tags.length > MAX_TAGS_PER_REQUEST) {
+    return NextResponse.json({ error: "Too many tags" }, { status: 400 });
+  }
+  const tags = Array.isArray(body?.tags)
+    ? body.tags.filter(
+        (tag): tag is string =>
+          typeof tag === "string" && isRevalidatableTag(tag),
+      )
+    : [];
+  if (tags.length === 0) {
+    return NextResponse.json({ error: "No valid tags" }, { status: 400 });
+  }
+
+  tags.forEach((tag) => revalidateTag(tag));
+  return NextResponse.json({ revalidated: tags, now: Date.now() });
+}
@@ -1,16 +1,16 @@
 "use client";
 
-import { QueryClient, QueryClientProvider } from "@tanstack/react-query";
+import { QueryClientProvider } from "@tanstack/react-query";
 import { ReactQueryDevtools } from "@tanstack/react-query-devtools";
-import { useState } from "react";
 import { AnalyticsProvider } from "../lib/analytics/provider";
+import { getQueryClient } from "../lib/query-client";
 
 interface AppProviderProps {
   children: React.ReactNode;
 }
 
 export function AppProvider({ children }: AppProviderProps) {
-  const [queryClient] = useState(() => new QueryClient());
+  const queryClient = getQueryClient();
 
   return (
     <QueryClientProvider client={queryClient}>
@@ -8,8 +8,10 @@ import {
   type ReactNode,
 } from "react";
 import { useRouter } from "next/navigation";
+import { useRealtimeCacheSync } from "@maestro/supabase";
 import { AuthContext, type AuthContextType } from "../context/auth-context";
 import { supabaseClient } from "@/lib/supabase/client";
+import { useServerDataRevalidation } from "@/features/profile/hooks/use-server-data-revalidation";
 import type { User, Session, AuthChangeEvent } from "@supabase/supabase-js";
 import type {
   LoadingState,
@@ -37,6 +39,11 @@ export const AuthProvider: React.FC<AuthProviderProps> = ({ children }) => {
   const [loadingState, setLoadingState] = useState<LoadingState>("idle");
   const router = useRouter();
 
+  // Patch React Query caches from realtime changes while signed in.
+  useRealtimeCacheSync({ supabase: supabaseClient, enabled: !!user });
+  // ...and revalidate cached server data (lib/data) when the profile changes.
+  useServerDataRevalidation(user?.id);
+
   useEffect(() => {
     const getInitialSession = async () => {
       setIsLoading(true);
@@ -0,0 +1,60 @@
+import Link from "next/link";
+import { Badge } from "@/components/ui/badge";
+import {
+  Card,
+  CardContent,
+  CardDescription,
+  CardHeader,
+  CardTitle,
+} from "@/components/ui/card";
+import { Skeleton } from "@/components/ui/skeleton";
+import { getEntitlements } from "@/lib/entitlements";
+
+/** The user's plans and features; render behind `PlanCardSkeleton`. */
+export const PlanCard = async ({ userId }: { userId: string }) => {
+  const entitlements = await getEntitlements(userId);
+  const [subscription] = entitlements.subscriptions;
+
+  return (
+    <Card>
+      <CardHeader>
+        <CardTitle>
+          {entitlements.plans.length > 0
+            ? entitlements.plans.join(", ")
+            : "Free plan"}
+        </CardTitle>
+        <CardDescription>
+          {subscription?.current_period_end ? (
+            `${subscription.cancel_at_period_end ? "Ends" : "Renews"} on ${new Date(subscription.current_period_end).toLocaleDateString()}`
+          ) : (
+            <Link href="/pricing" className="underline underline-offset-4">
+              See plans
+            </Link>
+          )}
+        </CardDescription>
+      </CardHeader>
+      {entitlements.features.length > 0 && (
+        <CardContent className="flex flex-wrap gap-2">
+          {entitlements.features.map((feature) => (
+            <Badge key={feature} variant="secondary">
+              {feature}
+            </Badge>
+          ))}
+        </CardContent>
+      )}
+    </Card>
+  );
+};
+
+export const PlanCardSkeleton = () => (
+  <Card>
+    <CardHeader>
+      <Skeleton className="h-5 w-32" />
+      <Skeleton className="h-4 w-40" />
+    </CardHeader>
+    <CardContent className="flex gap-2">
+      <Skeleton className="h-5 w-16" />
+      <Skeleton className="h-5 w-20" />
+    </CardContent>
+  </Card>
+);
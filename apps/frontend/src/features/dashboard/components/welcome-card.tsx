@@ -0,0 +1,32 @@
+import type { AuthUser } from "@/lib/auth";
+import {
+  Card,
+  CardDescription,
+  CardHeader,
+  CardTitle,
+} from "@/components/ui/card";
+import { Skeleton } from "@/components/ui/skeleton";
+import { getProfile } from "@/lib/data/profile";
+
+/** Greets the user by profile name; render behind `WelcomeCardSkeleton`. */
+export const WelcomeCard = async ({ user }: { user: AuthUser }) => {
+  const profile = await getProfile(user.id);
+
+  return (
+    <Card>
+      <CardHeader>
+        <CardTitle>Welcome, {profile?.full_name || user.email}!</CardTitle>
+        <CardDescription>User ID: {user.id}</CardDescription>
+      </CardHeader>
+    </Card>
+  );
+};
+
+export const WelcomeCardSkeleton = () => (
+  <Card>
+    <CardHeader>
+      <Skeleton className="h-5 w-48" />
+      <Skeleton className="h-4 w-72" />
+    </CardHeader>
+  </Card>
+);
@@ -0,0 +1,85 @@
+"use client";
+
+import Link from "next/link";
+import { usePathname } from "next/navigation";
+import { Activity, CreditCard, LayoutDashboard } from "lucide-react";
+import { Logo } from "@/components/ui/logo";
+import {
+  Sidebar,
+  SidebarContent,
+  SidebarFooter,
+  SidebarGroup,
+  SidebarGroupContent,
+  SidebarGroupLabel,
+  SidebarHeader,
+  SidebarMenu,
+  SidebarMenuButton,
+  SidebarMenuItem,
+  SidebarRail,
+} from "@/components/ui/sidebar";
+
+const NAV_ITEMS = [
+  { label: "Dashboard", href: "/dashboard", icon: LayoutDashboard },
+  { label: "Analytics", href: "/dashboard/analytics", icon: Activity },
+  { label: "Pricing", href: "/pricing", icon: CreditCard },
+];
+
+interface AppSidebarProps {
+  /** Rendered at the bottom, e.g. the user menu behind a Suspense boundary. */
+  footer?: React.ReactNode;
+}
+
+/**
+ * Navigation for the signed-in app. It needs no data, so it is part of the
+ * first flush; anything that does is passed in as `footer` and streams in.
+ */
+export const AppSidebar = ({ footer }: AppSidebarProps) => {
+  const pathname = usePathname();
+  // The longest matching link wins, so "/dashboard" is not also active on
+  // its sub-pages
+  const activeHref = NAV_ITEMS.map((item) => item.href)
+    .filter((href) => pathname === href || pathname.startsWith(`${href}/`))
+    .sort((a, b) => b.length - a.length)[0];
+
+  return (
+    <Sidebar collapsible="icon">
+      <SidebarHeader>
+        <SidebarMenu>
+          <SidebarMenuItem>
+            <SidebarMenuButton asChild tooltip="Home">
+              <Link href="/dashboard">
+                <Logo className="size-4" />
+                <span className="font-semibold">Zer0</span>
+              </Link>
+            </SidebarMenuButton>
+          </SidebarMenuItem>
+        </SidebarMenu>
+      </SidebarHeader>
+      <SidebarContent>
+        <SidebarGroup>
+          <SidebarGroupLabel>Application</SidebarGroupLabel>
+          <SidebarGroupContent>
+            <SidebarMenu>
+              {NAV_ITEMS.map((item) => (
+                <SidebarMenuItem key={item.href}>
+                  <SidebarMenuButton
+                    asChild
+                    isActive={item.href === activeHref}
+                    tooltip={item.label}
+                  >
+                    <Link href={item.href}>
+                      <item.icon />
+                      <span>{item.label}</span>
+                    </Link>
+                  </SidebarMenuButton>
+                </SidebarMenuItem>
+              ))}
+            </SidebarMenu>
+          </SidebarGroupContent>
+        </SidebarGroup>
+      </SidebarContent>
+      {footer && <SidebarFooter>{footer}</SidebarFooter>}
+      <SidebarRail />
+    </Sidebar>
+  );
+};
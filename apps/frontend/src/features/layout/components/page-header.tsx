@@ -8,6 +8,7 @@ import {
   BreadcrumbPage,
   BreadcrumbSeparator,
 } from "@/components/ui/breadcrumb";
+import { SidebarTrigger } from "@/components/ui/sidebar";
 import Link from "next/link";
 
 interface BreadcrumbItem {
@@ -28,6 +29,8 @@ export const PageHeader = ({ items, title, actions }: PageHeaderProps) => {
       {(title || actions) && (
         <div className="flex gap-4 sm:flex-row items-end md:items-center sm:justify-between">
           <div className="flex flex-col gap-2 sm:flex-row sm:items-center sm:gap-4 min-w-0 flex-1">
+            {/* Toggles the app shell's sidebar (see (application)/layout) */}
+            <SidebarTrigger className="-ml-1" />
             {title && (
               <h2 className="text-lg sm:text-xl font-bold tracking-tight text-foreground truncate">
                 {title}
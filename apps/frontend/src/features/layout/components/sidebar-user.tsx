@@ -0,0 +1,67 @@
+import Link from "next/link";
+import { Avatar, AvatarFallback, AvatarImage } from "@/components/ui/avatar";
+import {
+  SidebarMenu,
+  SidebarMenuButton,
+  SidebarMenuItem,
+} from "@/components/ui/sidebar";
+import { Skeleton } from "@/components/ui/skeleton";
+import { auth } from "@/lib/auth";
+import { getProfile } from "@/lib/data/profile";
+
+const initialsOf = (name: string) =>
+  name
+    .split(/[\s@.]+/)
+    .filter(Boolean)
+    .slice(0, 2)
+    .map((part) => part[0]!.toUpperCase())
+    .join("");
+
+/**
+ * The signed-in user's name and avatar for the sidebar footer. Render it
+ * behind `<Suspense fallback={<SidebarUserSkeleton />}>` so the profile read
+ * does not hold up the shell.
+ */
+export const SidebarUser = async () => {
+  const user = await auth();
+  if (!user) return null;
+  const profile = await getProfile(user.id);
+  const name = profile?.full_name || user.email || "Account";
+
+  return (
+    <SidebarMenu>
+      <SidebarMenuItem>
+        <SidebarMenuButton size="lg" asChild tooltip={name}>
+          <Link href="/dashboard">
+            <Avatar className="size-8 rounded-lg">
+              {profile?.avatar_url && (
+                <AvatarImage src={profile.avatar_url} alt={name} />
+              )}
+              <AvatarFallback className="rounded-lg">
+                {initialsOf(name)}
+              </AvatarFallback>
+            </Avatar>
+            <div className="grid flex-1 text-left text-sm leading-tight">
+              <span className="truncate font-medium">{name}</span>
+              {user.email && (
+                <span className="truncate text-xs text-muted-foreground">
+                  {user.email}
+                </span>
+              )}
+            </div>
+          </Link>
+        </SidebarMenuButton>
+      </SidebarMenuItem>
+    </SidebarMenu>
+  );
+};
+
+export const SidebarUserSkeleton = () => (
+  <div className="flex h-12 items-center gap-2 p-2">
+    <Skeleton className="size-8 shrink-0 rounded-lg" />
+    <div className="grid flex-1 gap-1.5 group-data-[collapsible=icon]:hidden">
+      <Skeleton className="h-3 w-24" />
+      <Skeleton className="h-3 w-32" />
+    </div>
+  </div>
+);
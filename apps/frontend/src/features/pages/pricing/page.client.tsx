@@ -1,6 +1,6 @@
 "use client";
 
-import { useState } from "react";
+import { useCallback, useEffect, useRef, useState } from "react";
 import Link from "next/link";
 import { useMutation, useQueryClient } from "@tanstack/react-query";
 import { Loader2, Mail } from "lucide-react";
@@ -16,9 +16,17 @@ import {
   CardTitle,
 } from "@/components/ui/card";
 import getStripe from "@/lib/stripe/client";
-import { createCheckoutSession } from "@/features/stripe/actions/checkout.actions"; // Use server action
+import {
+  createCheckoutSession,
+  prewarmCheckout,
+} from "@/features/stripe/actions/checkout.actions"; // Use server actions
 import type { ProductWithPrice } from "@/features/stripe/actions/product.actions"; // Use type from server action
 
+// Hover time before prewarming, so sweeping the cursor across plans is free.
+const PREWARM_HOVER_DELAY_MS = 150;
+// Matches the server's prewarmed session lifetime.
+const PREWARM_INTERVAL_MS = 60_000;
+
 interface PricingClientProps {
   initialProducts: ProductWithPrice[];
   // You might want to pass initial error/loading state from the server component if needed
@@ -60,7 +68,34 @@ export function PricingClient({ initialProducts }: PricingClientProps) {
     },
   });
 
+  // Intent-based prewarming: a short hover (or keyboard focus) on a plan asks
+  // the server to resolve the customer and prepare the session, once per
+  // price per minute, so the click only waits for the redirect.
+  const prewarmedAt = useRef(new Map<string, number>());
+  const prewarmTimer = useRef<ReturnType<typeof setTimeout> | null>(null);
+
+  const cancelPrewarm = useCallback(() => {
+    if (prewarmTimer.current) clearTimeout(prewarmTimer.current);
+    prewarmTimer.current = null;
+  }, []);
+
+  const schedulePrewarm = useCallback(
+    (priceId: string) => {
+      cancelPrewarm();
+      const last = prewarmedAt.current.get(priceId);
+      if (last && Date.now() - last < PREWARM_INTERVAL_MS) return;
+      prewarmTimer.current = setTimeout(() => {
+        prewarmedAt.current.set(priceId, Date.now());
+        void prewarmCheckout({ priceId, mode: "subscription" });
+      }, PREWARM_HOVER_DELAY_MS);
+    },
+    [cancelPrewarm],
+  );
+
+  useEffect(() => cancelPrewarm, [cancelPrewarm]);
+
   const handleCheckout = (priceId: string) => {
+    cancelPrewarm();
     console.log(`Initiating checkout for price ID: ${priceId}`);
     setSelectedPriceId(priceId);
     // Pass arguments as an object matching the server action
@@ -106,6 +141,9 @@ export function PricingClient({ initialProducts }: PricingClientProps) {
             <CardFooter>
               <Button
                 onClick={() => handleCheckout(product.default_price.id)}
+                onMouseEnter={() => schedulePrewarm(product.default_price.id)}
+                onMouseLeave={cancelPrewarm}
+                onFocus={() => schedulePrewarm(product.default_price.id)}
                 disabled={
                   checkoutMutation.isPending &&
                   selectedPriceId === product.default_price.id
@@ -0,0 +1,17 @@
+"use server";
+
+import { revalidateTag } from "next/cache";
+import { auth } from "@/lib/auth";
+import { profileTag } from "@/lib/data/cache-tags";
+
+/**
+ * Revalidates the signed-in user's cached profile. The only way the profile
+ * cache is refreshed: called when realtime reports a change to the profile
+ * row, wherever it was made. A user can only revalidate their own tag.
+ * Entitlements are revalidated by the backend instead.
+ */
+export async function revalidateOwnProfile(): Promise<void> {
+  const user = await auth();
+  if (!user) return;
+  revalidateTag(profileTag(user.id));
+}
@@ -0,0 +1,47 @@
+"use client";
+
+import { useEffect } from "react";
+import { supabaseClient } from "@/lib/supabase/client";
+import { revalidateOwnProfile } from "../actions/profile.actions";
+
+// Coalesces a burst of changes into one revalidation
+const REVALIDATE_DELAY_MS = 500;
+
+/**
+ * Revalidates the signed-in user's cached profile (see lib/data) when
+ * realtime reports a change to it, so server components stop serving the old
+ * copy. The action's revalidation also refreshes the current route.
+ * @param userId The signed-in user's id; nothing is subscribed without one.
+ */
+export const useServerDataRevalidation = (userId: string | undefined) => {
+  useEffect(() => {
+    if (!userId) return;
+    let timer: ReturnType<typeof setTimeout> | undefined;
+
+    const channel = supabaseClient
+      .channel(`server-data:${userId}`)
+      .on(
+        "postgres_changes",
+        {
+          event: "UPDATE",
+          schema: "public",
+          table: "profiles",
+          filter: `id=eq.${userId}`,
+        },
+        () => {
+          clearTimeout(timer);
+          timer = setTimeout(() => {
+            revalidateOwnProfile().catch((error) =>
+              console.error("Failed to revalidate profile:", error),
+            );
+          }, REVALIDATE_DELAY_MS);
+        },
+      )
+      .subscribe();
+
+    return () => {
+      clearTimeout(timer);
+      supabaseClient.removeChannel(channel);
+    };
+  }, [userId]);
+};
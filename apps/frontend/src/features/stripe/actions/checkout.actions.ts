@@ -1,56 +1,126 @@
 "use server";
 
-import { createSupabaseServerClient } from "@/lib/supabase/server";
+import { auth } from "@/lib/auth";
 import { stripe } from "@/lib/stripe/config";
 import { createCheckoutSession as createStripeCheckoutSession } from "@maestro/stripe"; // Renamed import to avoid conflict
+import {
+  fetchStripeCustomer,
+  linkStripeCustomer,
+  unlinkStripeCustomer,
+} from "@maestro/supabase";
+import { captureServerEvent } from "@/lib/posthog";
+import { getSupabaseAdmin } from "@/lib/supabase/admin";
+import {
+  PREWARM_SESSION_EXPIRY_SECONDS,
+  allowPrewarm,
+  isSessionPrewarmEnabled,
+  reservePrewarmedSession,
+  takePrewarmedSession,
+} from "@/features/stripe/checkout-prewarm";
 import Stripe from "stripe";
+import { createHash } from "node:crypto";
 import { headers } from "next/headers"; // To get referer for cancel/success URLs if needed
 
+// Supabase user id -> Stripe customer id, bounded to keep memory flat. A link
+// only changes when its customer is deleted in Stripe; checkout then gets
+// `resource_missing` for the cached id and relinks (relinkStripeCustomer),
+// which drops the entry.
+const customerIdCache = new Map<string, string>();
+const CUSTOMER_ID_CACHE_SIZE = 10_000;
+
+const rememberCustomerId = (supabaseUserId: string, customerId: string) => {
+  if (customerIdCache.size >= CUSTOMER_ID_CACHE_SIZE) {
+    const oldest = customerIdCache.keys().next();
+    if (!oldest.done) customerIdCache.delete(oldest.value);
+  }
+  customerIdCache.set(supabaseUserId, customerId);
+};
+
 // Helper function (kept private to this module for now)
+// Read-through: memory, then the stripe_customers table; Stripe is only
+// called the first time a user checks out.
 async function findOrCreateStripeCustomer(
   supabaseUserId: string,
   email: string,
 ): Promise<string> {
-  if (!email) {
-    throw new Error("Email is required to find or create a Stripe customer.");
-  }
-  console.log(
-    `Attempting to find or create Stripe customer for email: ${email}, Supabase User ID: ${supabaseUserId}`,
-  );
-
-  const listResult = await stripe.customers.list({ email: email, limit: 1 });
+  const cached = customerIdCache.get(supabaseUserId);
+  if (cached) return cached;
 
-  if (listResult.data.length > 0) {
-    const existingCustomer = listResult.data[0];
-    console.log(
-      `Found existing Stripe customer ${existingCustomer.id} for email ${email}`,
+  const supabaseAdmin = getSupabaseAdmin();
+  const { data: existing, error: lookupError } = await fetchStripeCustomer({
+    supabase: supabaseAdmin,
+    profileId: supabaseUserId,
+  });
+  if (lookupError) {
+    throw new Error(
+      `Failed to look up Stripe customer: ${lookupError.message}`,
     );
-    if (existingCustomer.metadata?.supabase_user_id !== supabaseUserId) {
-      console.log(
-        `Updating metadata for Stripe customer ${existingCustomer.id} to link Supabase user ${supabaseUserId}`,
-      );
-      await stripe.customers.update(existingCustomer.id, {
-        metadata: { supabase_user_id: supabaseUserId },
-      });
-    }
-    return existingCustomer.id;
+  }
+  if (existing?.stripe_customer_id) {
+    rememberCustomerId(supabaseUserId, existing.stripe_customer_id);
+    return existing.stripe_customer_id;
   }
 
-  console.log(
-    `No existing Stripe customer found for email ${email}. Creating a new one.`,
-  );
+  if (!email) {
+    throw new Error("Email is required to create a Stripe customer.");
+  }
   const customerParams: Stripe.CustomerCreateParams = {
     email: email,
     metadata: { supabase_user_id: supabaseUserId },
   };
 
-  const newCustomer = await stripe.customers.create(customerParams);
-  console.log(
-    `Created new Stripe customer ${newCustomer.id} for Supabase user ${supabaseUserId}`,
-  );
-  return newCustomer.id;
+  // The idempotency key makes concurrent first checkouts (double clicks, two
+  // tabs) receive the same customer from Stripe instead of creating two. The
+  // generation is bumped whenever a linked customer is deleted, so the key
+  // never maps to a deleted customer. The email hash keeps a retry after an
+  // email change from replaying a key with different parameters, which Stripe
+  // rejects.
+  const generation = existing?.generation ?? 0;
+  const emailHash = createHash("sha256")
+    .update(email)
+    .digest("hex")
+    .slice(0, 16);
+  const newCustomer = await stripe.customers.create(customerParams, {
+    idempotencyKey: `customer-create-${supabaseUserId}-${generation}-${emailHash}`,
+  });
+
+  // First link wins; a request that lost the race uses the winner's customer.
+  const { data: linkedId, error: linkError } = await linkStripeCustomer({
+    supabase: supabaseAdmin,
+    profileId: supabaseUserId,
+    customerId: newCustomer.id,
+  });
+  if (linkError) {
+    throw new Error(`Failed to link Stripe customer: ${linkError.message}`);
+  }
+  rememberCustomerId(supabaseUserId, linkedId);
+  return linkedId;
 }
 
+// The linked customer was deleted in Stripe: drop the link (bumping the
+// generation, unless the customer.deleted webhook already did) and create a
+// new customer.
+async function relinkStripeCustomer(
+  supabaseUserId: string,
+  email: string,
+  deletedCustomerId: string,
+): Promise<string> {
+  customerIdCache.delete(supabaseUserId);
+  const { error } = await unlinkStripeCustomer({
+    supabase: getSupabaseAdmin(),
+    customerId: deletedCustomerId,
+  });
+  if (error) {
+    throw new Error(`Failed to unlink Stripe customer: ${error.message}`);
+  }
+  return findOrCreateStripeCustomer(supabaseUserId, email);
+}
+
+const isMissingCustomerError = (error: unknown): boolean =>
+  error instanceof Stripe.errors.StripeInvalidRequestError &&
+  error.code === "resource_missing" &&
+  error.param === "customer";
+
 interface CreateCheckoutArgs {
   priceId: string;
   mode?: Stripe.Checkout.SessionCreateParams.Mode;
@@ -62,25 +132,24 @@ interface CheckoutResult {
   url: string;
 }
 
-// Server Action
-export async function createCheckoutSession({
-  priceId,
-  mode = "subscription",
-  quantity = 1,
-}: CreateCheckoutArgs): Promise<CheckoutResult> {
-  console.log(
-    `Creating checkout session via server action for price ${priceId}, mode ${mode}`,
-  );
-  const supabase = await createSupabaseServerClient(); // Server client works in server actions
-  const { data: userData, error: userError } = await supabase.auth.getUser();
+interface CheckoutUser {
+  id: string;
+  email: string;
+}
+
+// Shared by checkout and prewarming: the signed-in user and validated args.
+async function getCheckoutUser(
+  priceId: string,
+  mode: Stripe.Checkout.SessionCreateParams.Mode,
+): Promise<CheckoutUser> {
+  // Uses the user verified by the middleware when it was forwarded
+  const user = await auth();
 
-  if (userError || !userData?.user) {
-    console.error("Authentication error in createCheckoutSession:", userError);
+  if (!user) {
+    console.error("Authentication error in checkout: no signed-in user");
     throw new Error("Unauthorized: User must be logged in.");
   }
 
-  const { user } = userData;
-
   if (!user.email) {
     console.error("User email is missing for Supabase user:", user.id);
     throw new Error("User email is missing, cannot process payment.");
@@ -94,48 +163,121 @@ export async function createCheckoutSession({
     throw new Error("Invalid mode specified.");
   }
 
+  return { id: user.id, email: user.email };
+}
+
+async function buildSessionParams(
+  user: CheckoutUser,
+  priceId: string,
+  mode: Stripe.Checkout.SessionCreateParams.Mode,
+  quantity: number,
+): Promise<Stripe.Checkout.SessionCreateParams> {
+  const customerId = await findOrCreateStripeCustomer(user.id, user.email);
+
+  // Define success and cancel URLs
+  // Use NEXT_PUBLIC_APP_URL, fallback to referer header, then localhost
+  const referer = (await headers()).get("referer");
+  const baseUrl =
+    process.env.NEXT_PUBLIC_APP_URL ||
+    (referer ? new URL(referer).origin : null) || // Try to get origin from referer
+    "http://localhost:3000"; // Fallback
+
+  const successUrl = `${baseUrl}/payment-success?session_id={CHECKOUT_SESSION_ID}`;
+  // Use /pricing as cancel URL, ensuring it's absolute
+  const cancelUrl = `${baseUrl}/pricing`;
+
+  return {
+    customer: customerId,
+    line_items: [{ price: priceId, quantity: quantity }],
+    mode: mode,
+    success_url: successUrl,
+    cancel_url: cancelUrl,
+    // metadata: { supabase_user_id: user.id }, // Optional: Add if needed for webhooks
+    // Lets subscription webhooks find the user without a customer lookup
+    ...(mode === "subscription" && {
+      subscription_data: { metadata: { supabase_user_id: user.id } },
+    }),
+  };
+}
+
+async function createSessionForUser(
+  user: CheckoutUser,
+  sessionParams: Stripe.Checkout.SessionCreateParams,
+): Promise<CheckoutResult> {
+  const customerId = sessionParams.customer as string;
+  let session: Stripe.Checkout.Session;
   try {
-    const customerId = await findOrCreateStripeCustomer(user.id, user.email);
-
-    // Define success and cancel URLs
-    // Use NEXT_PUBLIC_APP_URL, fallback to referer header, then localhost
-    const referer = (await headers()).get("referer");
-    const baseUrl =
-      process.env.NEXT_PUBLIC_APP_URL ||
-      (referer ? new URL(referer).origin : null) || // Try to get origin from referer
-      "http://localhost:3000"; // Fallback
-
-    const successUrl = `${baseUrl}/payment-success?session_id={CHECKOUT_SESSION_ID}`;
-    // Use /pricing as cancel URL, ensuring it's absolute
-    const cancelUrl = `${baseUrl}/pricing`;
-
-    console.log(`Using Base URL: ${baseUrl}`);
-    console.log(`Success URL: ${successUrl}`);
-    console.log(`Cancel URL: ${cancelUrl}`);
-
-    const sessionParams: Stripe.Checkout.SessionCreateParams = {
-      customer: customerId,
-      line_items: [{ price: priceId, quantity: quantity }],
-      mode: mode,
-      success_url: successUrl,
-      cancel_url: cancelUrl,
-      // metadata: { supabase_user_id: user.id }, // Optional: Add if needed for webhooks
-    };
-
-    const session = await createStripeCheckoutSession({
+    session = await createStripeCheckoutSession({
       stripe: stripe,
       params: sessionParams,
     });
+  } catch (error: unknown) {
+    if (!isMissingCustomerError(error)) throw error;
+    console.warn(`Stripe customer ${customerId} no longer exists, relinking`);
+    session = await createStripeCheckoutSession({
+      stripe: stripe,
+      params: {
+        ...sessionParams,
+        customer: await relinkStripeCustomer(user.id, user.email, customerId),
+      },
+    });
+  }
+
+  if (!session.url) {
+    console.error("Checkout session URL was not returned by Stripe.");
+    throw new Error("Checkout session URL is missing.");
+  }
+  return { sessionId: session.id, url: session.url };
+}
+
+// Server Action
+export async function createCheckoutSession({
+  priceId,
+  mode = "subscription",
+  quantity = 1,
+}: CreateCheckoutArgs): Promise<CheckoutResult> {
+  console.log(
+    `Creating checkout session via server action for price ${priceId}, mode ${mode}`,
+  );
+  const user = await getCheckoutUser(priceId, mode);
 
-    if (!session.url) {
-      console.error("Checkout session URL was not returned by Stripe.");
-      throw new Error("Checkout session URL is missing.");
+  // A session pre-created on hover is used as is (prewarming is quantity 1).
+  if (quantity === 1) {
+    const prewarmed = takePrewarmedSession(user.id, priceId, mode);
+    if (prewarmed) {
+      console.log(
+        `Using pre-warmed checkout session ${prewarmed.sessionId} for user ${user.id}`,
+      );
+      captureServerEvent({
+        distinctId: user.id,
+        event: "checkout_session_created",
+        properties: { price_id: priceId, mode, quantity, prewarmed: true },
+      });
+      return prewarmed;
     }
+  }
 
+  try {
+    const sessionParams = await buildSessionParams(
+      user,
+      priceId,
+      mode,
+      quantity,
+    );
+    console.log(`Success URL: ${sessionParams.success_url}`);
+    console.log(`Cancel URL: ${sessionParams.cancel_url}`);
+
+    const session = await createSessionForUser(user, sessionParams);
     console.log(
-      `Successfully created checkout session ${session.id} for user ${user.id}`,
+      `Successfully created checkout session ${session.sessionId} for user ${user.id}`,
     );
-    return { sessionId: session.id, url: session.url };
+    // Buffered and sent after the response, never inline
+    captureServerEvent({
+      distinctId: user.id,
+      event: "checkout_session_created",
+      properties: { price_id: priceId, mode, quantity, prewarmed: false },
+    });
+    return session;
   } catch (error: unknown) {
     console.error("Error creating Stripe checkout session:", error);
     const errorMessage =
@@ -146,3 +288,43 @@ export async function createCheckoutSession({
     throw new Error(`Failed to create checkout session: ${errorMessage}`);
   }
 }
+
+/**
+ * Server Action called when a user shows intent to buy (hover or focus on a
+ * plan). Resolves and caches the Stripe customer so the click skips that
+ * lookup, and with CHECKOUT_PREWARM_SESSIONS=true also pre-creates the
+ * session (expiring in 30 minutes, discarded after a minute if unused).
+ * Never throws: prewarming is an optimisation and failures only mean the
+ * click does the work instead.
+ * @returns Whether a session is ready for this user and price.
+ */
+export async function prewarmCheckout({
+  priceId,
+  mode = "subscription",
+}: Omit<CreateCheckoutArgs, "quantity">): Promise<boolean> {
+  try {
+    const user = await getCheckoutUser(priceId, mode);
+    if (!allowPrewarm(user.id)) return false;
+
+    const sessionParams = await buildSessionParams(user, priceId, mode, 1);
+    if (!isSessionPrewarmEnabled()) return false;
+    const reservation = reservePrewarmedSession(user.id, priceId, mode);
+    if (!reservation) return false;
+
+    try {
+      const session = await createSessionForUser(user, {
+        ...sessionParams,
+        expires_at:
+          Math.floor(Date.now() / 1000) + PREWARM_SESSION_EXPIRY_SECONDS,
+      });
+      reservation.fill({ id: session.sessionId, url: session.url });
+    } catch (error: unknown) {
+      reservation.release();
+      throw error;
+    }
+    return true;
+  } catch (error: unknown) {
+    console.warn(`Failed to pre-warm checkout for price ${priceId}:`, error);
+    return false;
+  }
+}
@@ -0,0 +1,2 @@
+/** Cache tag for data read from the Stripe catalog mirror. */
+export const STRIPE_CATALOG_TAG = "stripe-catalog";
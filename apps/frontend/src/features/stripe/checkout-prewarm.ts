@@ -0,0 +1,151 @@
+import { stripe } from "@/lib/stripe/config";
+
+// Intent-based checkout pre-warming: hovering or focusing a plan resolves the
+// customer and, when CHECKOUT_PREWARM_SESSIONS=true, creates the session so
+// the click only has to redirect. State is per process; a click served by
+// another instance falls back to creating the session on demand.
+
+/** How long a pre-created session may wait for its click. */
+export const PREWARM_SESSION_TTL_MS = 60_000;
+/**
+ * Session `expires_at`, relative to now. Stripe rejects anything under 30
+ * minutes when the request arrives, so this keeps a margin for clock skew and
+ * latency; unused sessions are also expired early.
+ */
+export const PREWARM_SESSION_EXPIRY_SECONDS = 32 * 60;
+
+// Abuse limits: prewarm calls per user per window, unused sessions per user
+// and unused sessions per process.
+const PREWARM_WINDOW_MS = 60_000;
+const MAX_PREWARMS_PER_WINDOW = 10;
+const MAX_SESSIONS_PER_USER = 2;
+const MAX_SESSIONS = 1_000;
+
+export const isSessionPrewarmEnabled = () =>
+  process.env.CHECKOUT_PREWARM_SESSIONS === "true";
+
+interface PrewarmedSession {
+  userId: string;
+  /** Null while the session is still being created. */
+  ready: {
+    sessionId: string;
+    url: string;
+    timer: ReturnType<typeof setTimeout>;
+  } | null;
+}
+
+/** A slot held for one session while it is created. */
+export interface PrewarmReservation {
+  /** Stores the created session, or expires it if the slot was taken. */
+  fill: (session: { id: string; url: string }) => void;
+  /** Frees the slot when the session could not be created. */
+  release: () => void;
+}
+
+const sessions = new Map<string, PrewarmedSession>();
+const prewarmCalls = new Map<string, number[]>();
+
+const sessionKey = (userId: string, priceId: string, mode: string) =>
+  `${userId}:${priceId}:${mode}`;
+
+/**
+ * Records a prewarm call and reports whether the user is within the limit.
+ * @param userId The Supabase user id.
+ */
+export const allowPrewarm = (userId: string): boolean => {
+  const now = Date.now();
+  const recent = (prewarmCalls.get(userId) ?? []).filter(
+    (calledAt) => now - calledAt < PREWARM_WINDOW_MS,
+  );
+  if (recent.length >= MAX_PREWARMS_PER_WINDOW) {
+    prewarmCalls.set(userId, recent);
+    return false;
+  }
+  recent.push(now);
+  prewarmCalls.set(userId, recent);
+
+  // Keep the call log bounded: drop users whose window has passed.
+  if (prewarmCalls.size > MAX_SESSIONS * 10) {
+    for (const [id, calls] of prewarmCalls) {
+      if (calls.every((calledAt) => now - calledAt >= PREWARM_WINDOW_MS)) {
+        prewarmCalls.delete(id);
+      }
+    }
+  }
+  return true;
+};
+
+// Best effort: an expired session can no longer be paid, so a leaked URL is
+// harmless; failures are only logged.
+const expireSession = async (sessionId: string) => {
+  try {
+    await stripe.checkout.sessions.expire(sessionId);
+  } catch (error: unknown) {
+    console.warn(`Failed to expire pre-warmed session ${sessionId}:`, error);
+  }
+};
+
+/**
+ * Reserves the slot for a new pre-created session, checking and claiming it
+ * in one step so concurrent prewarms cannot both pass the caps: one session
+ * per user and price, `MAX_SESSIONS_PER_USER` per user and `MAX_SESSIONS` per
+ * process. A filled session is expired in Stripe if not taken within
+ * `PREWARM_SESSION_TTL_MS`.
+ * @returns The reservation, or null when no session may be pre-created.
+ */
+export const reservePrewarmedSession = (
+  userId: string,
+  priceId: string,
+  mode: string,
+): PrewarmReservation | null => {
+  const key = sessionKey(userId, priceId, mode);
+  if (sessions.has(key)) return null;
+  if (sessions.size >= MAX_SESSIONS) return null;
+  let userSessions = 0;
+  for (const session of sessions.values()) {
+    if (session.userId === userId) userSessions += 1;
+  }
+  if (userSessions >= MAX_SESSIONS_PER_USER) return null;
+
+  const slot: PrewarmedSession = { userId, ready: null };
+  sessions.set(key, slot);
+  return {
+    fill: (session) => {
+      // Taken by a click while it was being created: nobody will use it.
+      if (sessions.get(key) !== slot) {
+        void expireSession(session.id);
+        return;
+      }
+      const timer = setTimeout(() => {
+        if (sessions.get(key) !== slot) return;
+        sessions.delete(key);
+        void expireSession(session.id);
+      }, PREWARM_SESSION_TTL_MS);
+      timer.unref?.();
+      slot.ready = { sessionId: session.id, url: session.url, timer };
+    },
+    release: () => {
+      if (sessions.get(key) === slot) sessions.delete(key);
+    },
+  };
+};
+
+/**
+ * Removes and returns the waiting session for this user and price, if any.
+ * Sessions are single use: each click takes at most one.
+ */
+export const takePrewarmedSession = (
+  userId: string,
+  priceId: string,
+  mode: string,
+): { sessionId: string; url: string } | null => {
+  const key = sessionKey(userId, priceId, mode);
+  const session = sessions.get(key);
+  if (!session) return null;
+  sessions.delete(key);
+  // Still being created: the click creates its own and the pre-created one
+  // is expired when it arrives.
+  if (!session.ready) return null;
+  clearTimeout(session.ready.timer);
+  return { sessionId: session.ready.sessionId, url: session.ready.url };
+};
@@ -1,10 +1,21 @@
 import { cache } from "react";
+import { headers } from "next/headers";
 import { redirect } from "next/navigation";
+import {
+  type AuthUser,
+  FORWARDED_USER_HEADER,
+  readForwardedUser,
+  toUser,
+} from "./supabase/forwarded-user";
 import { createSupabaseServerClient } from "./supabase/server";
-import type { User } from "@supabase/supabase-js";
+
+export type { AuthUser };
 
 /**
  * Get the current authenticated user session
+ * Uses the user the middleware verified and forwarded when available (see
+ * SUPABASE_AUTH_VERIFICATION in lib/supabase/middleware.ts), so no further
+ * call to Supabase auth is made; otherwise asks Supabase.
  * @example
  * ```ts
  * const user = await auth()
@@ -14,9 +25,14 @@ import type { User } from "@supabase/supabase-js";
  *   console.log('Not authenticated')
  * }
  * ```
- * @returns {Promise<User | null>} The authenticated user or null
+ * @returns {Promise<AuthUser | null>} The authenticated user or null
  */
-export const auth = cache(async (): Promise<User | null> => {
+export const auth = cache(async (): Promise<AuthUser | null> => {
+  const forwarded = await readForwardedUser(
+    (await headers()).get(FORWARDED_USER_HEADER),
+  );
+  if (forwarded) return toUser(forwarded);
+
   const supabase = await createSupabaseServerClient();
   try {
     const {
@@ -47,10 +63,12 @@ export const auth = cache(async (): Promise<User | null> => {
  * console.log('Authenticated user:', user)
  * ```
  * @param {string} [redirectTo='/login'] - The path to redirect to if not authenticated.
- * @returns {Promise<User>} The authenticated user
+ * @returns {Promise<AuthUser>} The authenticated user
  * @throws {Redirect} Redirects if not authenticated
  */
-export const protectedRoute = async (redirectTo = "/login"): Promise<User> => {
+export const protectedRoute = async (
+  redirectTo = "/login",
+): Promise<AuthUser> => {
   const user = await auth();
 
   if (!user) {
@@ -0,0 +1,14 @@
+import { STRIPE_CATALOG_TAG } from "@/features/stripe/cache-tags";
+
+/** Cache tag for a user's profile (see `getProfile`). */
+export const profileTag = (userId: string) => `profile:${userId}`;
+
+/** Cache tag for a user's entitlements (see `getEntitlements`). */
+export const entitlementsTag = (userId: string) => `entitlements:${userId}`;
+
+const SHARED_TAGS = new Set([STRIPE_CATALOG_TAG]);
+const USER_TAG = /^(profile|entitlements):[0-9a-f-]{36}$/;
+
+/** Whether the revalidation endpoint may invalidate a tag. */
+export const isRevalidatableTag = (tag: string) =>
+  SHARED_TAGS.has(tag) || USER_TAG.test(tag);
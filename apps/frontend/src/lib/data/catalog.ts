@@ -0,0 +1,71 @@
+import { cache } from "react";
+import { unstable_cache } from "next/cache";
+import { fetchStripeCatalog } from "@maestro/supabase";
+import { supabaseStatic } from "@/lib/supabase/static";
+import { STRIPE_CATALOG_TAG } from "@/features/stripe/cache-tags";
+
+/**
+ * A product with its default price, in the shape the pricing page renders.
+ * Field names follow the Stripe objects they are mirrored from.
+ */
+export interface ProductWithPrice {
+  id: string;
+  name: string;
+  description: string | null;
+  metadata: Record<string, string>;
+  default_price: {
+    id: string;
+    currency: string;
+    unit_amount: number | null;
+    recurring: { interval: string; interval_count: number | null } | null;
+  };
+}
+
+// Catalog reads come from the local mirror (kept current by the backend's
+// product.*/price.* webhooks) and are cached in-process. Webhooks revalidate
+// the tag via /api/revalidate; the hourly expiry is only a safety net.
+const getCachedProducts = unstable_cache(
+  async (): Promise<ProductWithPrice[]> => {
+    const { data, error } = await fetchStripeCatalog({
+      supabase: supabaseStatic,
+    });
+    if (error) throw new Error(error.message);
+
+    return data.flatMap((product) => {
+      // Products without an active default price are not offered.
+      const price = product.prices.find(
+        (p) => p.id === product.default_price_id,
+      );
+      if (!price) return [];
+      return [
+        {
+          id: product.id,
+          name: product.name,
+          description: product.description,
+          metadata: product.metadata as Record<string, string>,
+          default_price: {
+            id: price.id,
+            currency: price.currency,
+            unit_amount: price.unit_amount,
+            recurring: price.recurring_interval
+              ? {
+                  interval: price.recurring_interval,
+                  interval_count: price.recurring_interval_count,
+                }
+              : null,
+          },
+        },
+      ];
+    });
+  },
+  [STRIPE_CATALOG_TAG],
+  { tags: [STRIPE_CATALOG_TAG], revalidate: 3600 },
+);
+
+/**
+ * The products offered on the pricing page, shared by every user (cached
+ * under `STRIPE_CATALOG_TAG`) and read at most once per request.
+ */
+export const getCatalogProducts = cache(
+  (): Promise<ProductWithPrice[]> => getCachedProducts(),
+);
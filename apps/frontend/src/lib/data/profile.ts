@@ -0,0 +1,30 @@
+import { fetchProfileById, type Profile } from "@maestro/supabase";
+import { profileTag } from "./cache-tags";
+import { createUserDataReader } from "./user-data";
+
+// The realtime listener revalidates the tag when the profile row changes
+// (see useServerDataRevalidation); the expiry is a safety net.
+const PROFILE_REVALIDATE_SECONDS = 300;
+
+/**
+ * Get a user's profile, cached per user under `profileTag(userId)` (see
+ * `createUserDataReader`).
+ * @example
+ * ```ts
+ * const user = await protectedRoute()
+ * const profile = await getProfile(user.id)
+ * ```
+ * @returns {Promise<Profile | null>} The profile, or null if there is none
+ */
+export const getProfile = createUserDataReader<Profile | null>({
+  name: "profile",
+  tag: profileTag,
+  revalidate: PROFILE_REVALIDATE_SECONDS,
+  read: async (supabase, userId) => {
+    const { data, error } = await fetchProfileById({ supabase, id: userId });
+    // PGRST116: no row, which is cached like any other answer
+    if (error && error.code !== "PGRST116") throw new Error(error.message);
+    return data ?? null;
+  },
+  fallback: () => null,
+});
@@ -0,0 +1,45 @@
+import { cache } from "react";
+import { unstable_cache } from "next/cache";
+import type { Database } from "@maestro/supabase";
+import type { SupabaseClient } from "@supabase/supabase-js";
+import { getSupabaseAdmin } from "@/lib/supabase/admin";
+
+interface UserDataReaderOptions<T> {
+  /** Cache key prefix and name in error logs, e.g. "profile". */
+  name: string;
+  /** The user's cache tag; revalidating it drops their cached copy. */
+  tag: (userId: string) => string;
+  /** Seconds before a cached copy expires without being revalidated. */
+  revalidate: number;
+  /** Reads the user's data; throwing skips the cache for this call. */
+  read: (supabase: SupabaseClient<Database>, userId: string) => Promise<T>;
+  /** Returned, uncached, when the read fails. */
+  fallback: (userId: string) => T;
+}
+
+/**
+ * Creates a reader of one user's server data, cached across requests per
+ * user under `tag(userId)` and deduplicated within a request. The cache
+ * cannot read request cookies, so reads use the service role and bypass
+ * RLS: only call the reader with the id of the authenticated user (from
+ * `auth()` or `protectedRoute()`), never with an id from the request.
+ */
+export const createUserDataReader = <T>({
+  name,
+  tag,
+  revalidate,
+  read,
+  fallback,
+}: UserDataReaderOptions<T>) =>
+  cache(async (userId: string): Promise<T> => {
+    try {
+      return await unstable_cache(
+        () => read(getSupabaseAdmin(), userId),
+        [name, userId],
+        { tags: [tag(userId)], revalidate },
+      )();
+    } catch (error) {
+      console.error(`Error fetching ${name}:`, error);
+      return fallback(userId);
+    }
+  });
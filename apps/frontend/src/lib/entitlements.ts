@@ -0,0 +1,38 @@
+import {
+  EntitlementSet,
+  fetchEntitlements,
+  toEntitlementSet,
+} from "@maestro/supabase";
+import { entitlementsTag } from "./data/cache-tags";
+import { createUserDataReader } from "./data/user-data";
+
+// Subscription webhooks revalidate the tag (via the backend); the short expiry
+// bounds staleness for changes without one, such as joining an organization.
+const ENTITLEMENTS_REVALIDATE_SECONDS = 60;
+
+/**
+ * Get the plans and features a user is entitled to, cached per user under
+ * `entitlementsTag(userId)` (see `createUserDataReader`). Layouts, pages and
+ * server actions rendering the same request share one lookup.
+ * @example
+ * ```ts
+ * const user = await protectedRoute()
+ * const entitlements = await getEntitlements(user.id)
+ * if (!hasFeature(entitlements, 'exports')) redirect('/pricing')
+ * ```
+ * @returns {Promise<EntitlementSet>} The user's entitlement set
+ */
+export const getEntitlements = createUserDataReader<EntitlementSet>({
+  name: "entitlements",
+  tag: entitlementsTag,
+  revalidate: ENTITLEMENTS_REVALIDATE_SECONDS,
+  read: async (supabase, userId) => {
+    const { data, error } = await fetchEntitlements({
+      supabase,
+      profileId: userId,
+    });
+    if (error) throw new Error(error.message);
+    return toEntitlementSet(userId, data ?? []);
+  },
+  fallback: (userId) => toEntitlementSet(userId, []),
+});
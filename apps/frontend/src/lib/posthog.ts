@@ -1,10 +1,238 @@
+import { after } from "next/server";
 import { PostHog } from "posthog-node";
 
-export default function PostHogClient() {
-  const posthogClient = new PostHog(process.env.NEXT_PUBLIC_POSTHOG_KEY!, {
-    host: "https://eu.i.posthog.com",
-    flushAt: 1,
+// Server-side analytics are buffered in-process and sent in batches, so a
+// capture never waits on the network. Batches go to PostHog, or through the
+// analytics gateway (POST /v1/events/batch, which forwards them to PostHog)
+// when ANALYTICS_GATEWAY_URL is set.
+const POSTHOG_HOST = "https://eu.i.posthog.com";
+// Flush once this many events are buffered...
+const FLUSH_AT = parseInt(process.env.POSTHOG_FLUSH_AT || "20", 10);
+// ...or the oldest buffered event is this old
+const FLUSH_INTERVAL_MS = parseInt(
+  process.env.POSTHOG_FLUSH_INTERVAL_MS || "10000",
+  10,
+);
+// Events buffered at most; the oldest are dropped (and counted) beyond it
+const BUFFER_LIMIT = parseInt(process.env.POSTHOG_BUFFER_LIMIT || "1000", 10);
+// Events per request (the gateway's BATCH_MAX_EVENTS default)
+const MAX_BATCH_SIZE = 100;
+// Longest wait for PostHog to accept a batch
+const SHUTDOWN_TIMEOUT_MS = 10000;
+
+export interface ServerAnalyticsEvent {
+  /** The user id, or another stable id for anonymous events. */
+  distinctId: string;
+  event: string;
+  properties?: Record<string, unknown>;
+}
+
+type BufferedEvent = ServerAnalyticsEvent & { id: string; timestamp: Date };
+
+export interface ServerAnalyticsStats {
+  buffered: number;
+  sent: number;
+  /** Dropped because the buffer was full. */
+  dropped: number;
+  /** Lost because a batch could not be sent. */
+  failed: number;
+}
+
+type Send = (batch: BufferedEvent[]) => Promise<void>;
+
+const sendToGateway =
+  (gatewayUrl: string): Send =>
+  async (batch) => {
+    const response = await fetch(`${gatewayUrl}/v1/events/batch`, {
+      method: "POST",
+      headers: { "Content-Type": "application/json" },
+      body: JSON.stringify({
+        events: batch.map((event) => ({
+          id: event.id,
+          payload: {
+            event: event.event,
+            distinct_id: event.distinctId,
+            properties: event.properties,
+          },
+          timestamp: event.timestamp.toISOString(),
+        })),
+      }),
+    });
+    if (!response.ok) {
+      throw new Error(`Analytics gateway returned ${response.status}`);
+    }
+  };
+
+// A client per batch, shut down once captured: `shutdown()` waits for every
+// queued and in-flight request, where `flush()` can miss captures the client
+// is still enqueueing. Runs inside `after()`, so it never delays a response.
+const sendToPostHog: Send = async (batch) => {
+  const client = new PostHog(process.env.NEXT_PUBLIC_POSTHOG_KEY!, {
+    host: POSTHOG_HOST,
+    flushAt: MAX_BATCH_SIZE + 1,
     flushInterval: 0,
   });
-  return posthogClient;
+  batch.forEach(({ id, distinctId, event, properties, timestamp }) =>
+    client.capture({ uuid: id, distinctId, event, properties, timestamp }),
+  );
+  await client.shutdown(SHUTDOWN_TIMEOUT_MS);
+};
+
+class ServerAnalytics {
+  private buffer: BufferedEvent[] = [];
+  private flushing: Promise<void> | null = null;
+  private timer: ReturnType<typeof setInterval> | null = null;
+  private stats = { sent: 0, dropped: 0, failed: 0 };
+
+  constructor(private readonly send: Send) {}
+
+  capture(event: ServerAnalyticsEvent) {
+    if (this.buffer.length >= BUFFER_LIMIT) {
+      this.buffer.shift();
+      this.stats.dropped += 1;
+    }
+    this.buffer.push({
+      ...event,
+      id: crypto.randomUUID(),
+      timestamp: new Date(),
+    });
+    if (!this.timer) {
+      // Backstop for long-lived servers; unref'd so it never holds the process
+      this.timer = setInterval(() => void this.flushIfDue(), FLUSH_INTERVAL_MS);
+      this.timer.unref?.();
+    }
+  }
+
+  isDue() {
+    const oldest = this.buffer[0];
+    if (!oldest) return false;
+    return (
+      this.buffer.length >= FLUSH_AT ||
+      Date.now() - oldest.timestamp.getTime() >= FLUSH_INTERVAL_MS
+    );
+  }
+
+  flushIfDue(): Promise<void> {
+    return this.isDue() ? this.flush() : Promise.resolve();
+  }
+
+  /** Sends everything buffered; concurrent calls share one flush. */
+  flush(): Promise<void> {
+    this.flushing ??= this.drain().finally(() => {
+      this.flushing = null;
+    });
+    return this.flushing;
+  }
+
+  getStats(): ServerAnalyticsStats {
+    return { buffered: this.buffer.length, ...this.stats };
+  }
+
+  private async drain() {
+    const droppedBefore = this.stats.dropped;
+    while (this.buffer.length > 0) {
+      const batch = this.buffer.splice(0, MAX_BATCH_SIZE);
+      try {
+        await this.send(batch);
+        this.stats.sent += batch.length;
+      } catch (error) {
+        this.stats.failed += batch.length;
+        console.error(
+          `Failed to send ${batch.length} analytics events:`,
+          error,
+        );
+      }
+    }
+    if (this.stats.dropped > droppedBefore) {
+      console.warn(
+        `Analytics buffer full: dropped ${this.stats.dropped - droppedBefore} events (${this.stats.dropped} in total)`,
+      );
+    }
+  }
+}
+
+// One instance per process; kept on globalThis so dev reloads reuse it
+const globalForAnalytics = globalThis as typeof globalThis & {
+  serverAnalytics?: ServerAnalytics;
+};
+
+const getServerAnalytics = (): ServerAnalytics => {
+  if (!globalForAnalytics.serverAnalytics) {
+    const gatewayUrl = process.env.ANALYTICS_GATEWAY_URL;
+    globalForAnalytics.serverAnalytics = new ServerAnalytics(
+      gatewayUrl ? sendToGateway(gatewayUrl) : sendToPostHog,
+    );
+  }
+  return globalForAnalytics.serverAnalytics;
+};
+
+/**
+ * Records a server-side analytics event without waiting on the network. The
+ * event is buffered and sent in a batch once enough have accumulated or the
+ * oldest is FLUSH_INTERVAL_MS old, checked after the current response is
+ * sent (`after()`) and on an interval.
+ * @example
+ * ```ts
+ * captureServerEvent({
+ *   distinctId: user.id,
+ *   event: "checkout_session_created",
+ *   properties: { price_id: priceId },
+ * })
+ * ```
+ */
+export const captureServerEvent = (event: ServerAnalyticsEvent): void => {
+  const analytics = getServerAnalytics();
+  analytics.capture(event);
+  try {
+    after(() => analytics.flushIfDue());
+  } catch {
+    // Outside a request (e.g. at startup): the interval flushes instead
+  }
+};
+
+/** Sends every buffered event now, e.g. before the process exits. */
+export const flushServerAnalytics = (): Promise<void> =>
+  getServerAnalytics().flush();
+
+/** Counts of buffered, sent and lost events since the process started. */
+export const getServerAnalyticsStats = (): ServerAnalyticsStats =>
+  getServerAnalytics().getStats();
+
+/**
+ * Flushes buffered events when the process exits or is asked to stop. Call
+ * once at startup (see instrumentation.ts); best effort, as the server may
+ * exit before a flush started by a signal completes.
+ */
+export const registerServerAnalyticsShutdown = () => {
+  const flush = () =>
+    globalForAnalytics.serverAnalytics
+      ? flushServerAnalytics().catch((error) =>
+          console.error("Failed to flush analytics on shutdown:", error),
+        )
+      : Promise.resolve();
+  const onSignal = (signal: NodeJS.Signals) => {
+    void flush().then(() => {
+      // Nothing else handles the signal: exit as Node would have
+      if (process.listenerCount(signal) === 0) {
+        process.kill(process.pid, signal);
+      }
+    });
+  };
+
+  process.once("beforeExit", () => void flush());
+  process.once("SIGTERM", onSignal);
+  process.once("SIGINT", onSignal);
+};
+
+let sharedClient: PostHog | null = null;
+
+/**
+ * The process-wide PostHog client, for calls other than captures (e.g.
+ * feature flags). Use `captureServerEvent` for events so they are batched.
+ */
+export default function PostHogClient() {
+  sharedClient ??= new PostHog(process.env.NEXT_PUBLIC_POSTHOG_KEY!, {
+    host: POSTHOG_HOST,
+  });
+  return sharedClient;
 }
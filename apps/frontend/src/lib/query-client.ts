@@ -0,0 +1,39 @@
+import { cache } from "react";
+import { isServer, QueryClient } from "@tanstack/react-query";
+
+const makeQueryClient = () =>
+  new QueryClient({
+    defaultOptions: {
+      queries: {
+        // Data prefetched on the server is fresh when it reaches the browser,
+        // so hydrated queries do not refetch immediately on mount.
+        staleTime: 60 * 1000,
+      },
+    },
+  });
+
+// One client per server request; never shared between users.
+const getServerQueryClient = cache(makeQueryClient);
+
+let browserQueryClient: QueryClient | undefined;
+
+/**
+ * Returns the QueryClient for the current context: a request-scoped client on
+ * the server (for `prefetch*` helpers and `dehydrate`), and a singleton in the
+ * browser so suspending during the initial render does not drop the cache.
+ * @example
+ * ```tsx
+ * const queryClient = getQueryClient();
+ * await prefetchInfiniteProjects(queryClient, { organization_id }, { supabase });
+ * return (
+ *   <HydrationBoundary state={dehydrate(queryClient)}>
+ *     <ProjectList organizationId={organization_id} />
+ *   </HydrationBoundary>
+ * );
+ * ```
+ */
+export const getQueryClient = (): QueryClient => {
+  if (isServer) return getServerQueryClient();
+  if (!browserQueryClient) browserQueryClient = makeQueryClient();
+  return browserQueryClient;
+};
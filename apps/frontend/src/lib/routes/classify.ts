@@ -0,0 +1,46 @@
+import { ROUTE_TRIE } from "./manifest.generated";
+
+/**
+ * How the middleware treats a path (see routes.config.mjs):
+ * - `excluded` and `public`: no session check
+ * - `auth-only`: public, but signed-in users are redirected away
+ * - `protected`: requires a signed-in user
+ */
+export type RouteKind = "excluded" | "public" | "auth-only" | "protected";
+
+/** A node of the generated route trie, keyed by path segment. */
+export interface RouteTrieNode {
+  /** Applies to this path and every path below it. */
+  subtree?: RouteKind;
+  /** Applies to this path only; wins over `subtree`. */
+  exact?: RouteKind;
+  children?: Record<string, RouteTrieNode>;
+}
+
+/**
+ * Classifies a pathname in one pass over its segments: the most specific
+ * matching rule wins and unmatched paths are protected.
+ * @param pathname A URL pathname, e.g. "/dashboard/analytics".
+ */
+export const classifyRoute = (
+  pathname: string,
+  trie: RouteTrieNode = ROUTE_TRIE,
+): RouteKind => {
+  let node: RouteTrieNode = trie;
+  let inherited: RouteKind = trie.subtree ?? "protected";
+  let start = 1;
+
+  while (start <= pathname.length) {
+    let end = pathname.indexOf("/", start);
+    if (end === -1) end = pathname.length;
+    // Empty segments ("//", trailing "/") are skipped like the trie's keys
+    if (end > start) {
+      const child = node.children?.[pathname.slice(start, end)];
+      if (!child) return inherited;
+      node = child;
+      if (node.subtree) inherited = node.subtree;
+    }
+    start = end + 1;
+  }
+  return node.exact ?? node.subtree ?? inherited;
+};
@@ -0,0 +1,72 @@
+// Generated by scripts/generate-route-manifest.mjs from routes.config.mjs.
+// Do not edit; change routes.config.mjs and run `pnpm routes:generate`.
+import type { RouteTrieNode } from "./classify";
+
+export const ROUTE_TRIE: RouteTrieNode = {
+  "children": {
+    "ingest": {
+      "subtree": "excluded"
+    },
+    "_next": {
+      "children": {
+        "static": {
+          "subtree": "excluded"
+        },
+        "image": {
+          "subtree": "excluded"
+        }
+      }
+    },
+    "favicon.ico": {
+      "exact": "excluded"
+    },
+    "api": {
+      "children": {
+        "revalidate": {
+          "subtree": "excluded"
+        }
+      }
+    },
+    "auth": {
+      "children": {
+        "update-password": {
+          "subtree": "public"
+        },
+        "verify-request": {
+          "subtree": "public"
+        },
+        "verify-otp": {
+          "subtree": "public"
+        },
+        "callback": {
+          "subtree": "public"
+        },
+        "auth-error": {
+          "subtree": "public"
+        },
+        "login": {
+          "subtree": "auth-only"
+        },
+        "register": {
+          "subtree": "auth-only"
+        },
+        "forgot-password": {
+          "subtree": "auth-only"
+        }
+      }
+    },
+    "login": {
+      "subtree": "public"
+    },
+    "register": {
+      "subtree": "public"
+    },
+    "forgot-password": {
+      "subtree": "public"
+    },
+    "update-password": {
+      "subtree": "public"
+    }
+  },
+  "exact": "public"
+};
@@ -1,10 +1,13 @@
-import Stripe from "stripe";
+import { getStripeClient } from "@maestro/stripe";
 
 if (!process.env.STRIPE_SECRET_KEY) {
   throw new Error("STRIPE_SECRET_KEY environment variable is not set.");
 }
 
-export const stripe = new Stripe(process.env.STRIPE_SECRET_KEY, {
+// Pooled client: reuses keep-alive connections across requests
+export const stripe = getStripeClient({
+  apiKey: process.env.STRIPE_SECRET_KEY,
   apiVersion: "2025-03-31.basil", // Use the latest API version
-  typescript: true,
+  lane: "interactive",
+  apiBase: process.env.STRIPE_API_BASE, // e.g. the local stand-in
 });
@@ -0,0 +1,31 @@
+import { Database } from "@maestro/supabase";
+import { createClient, SupabaseClient } from "@supabase/supabase-js";
+
+let adminClient: SupabaseClient<Database> | null = null;
+
+/**
+ * Service-role client for server-side writes that RLS does not allow users to
+ * make (e.g. linking a Stripe customer). Bypasses RLS entirely: only use it
+ * in server actions and route handlers, after authenticating the user, and
+ * never pass its results to the client unfiltered.
+ */
+export const getSupabaseAdmin = (): SupabaseClient<Database> => {
+  if (!process.env.SUPABASE_SERVICE_ROLE_KEY) {
+    throw new Error(
+      "SUPABASE_SERVICE_ROLE_KEY environment variable is not set.",
+    );
+  }
+  if (!adminClient) {
+    adminClient = createClient<Database>(
+      process.env.NEXT_PUBLIC_SUPABASE_URL!,
+      process.env.SUPABASE_SERVICE_ROLE_KEY,
+      {
+        auth: {
+          autoRefreshToken: false,
+          persistSession: false,
+        },
+      },
+    );
+  }
+  return adminClient;
+};
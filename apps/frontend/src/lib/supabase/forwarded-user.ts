@@ -0,0 +1,125 @@
+import type { User } from "@supabase/supabase-js";
+import { bytesToBase64Url, base64UrlToBytes } from "./jwt";
+import type { SupabaseAccessTokenClaims } from "./jwt";
+
+// The middleware verifies the session once and forwards the user to server
+// components in a request header, signed with AUTH_FORWARD_SECRET so it
+// cannot be forged by a client (the middleware also strips any incoming
+// copy). Without the secret nothing is forwarded and `auth()` asks Supabase.
+
+export const FORWARDED_USER_HEADER = "x-auth-user";
+
+/** The verified identity the middleware forwards. */
+export interface ForwardedUser {
+  id: string;
+  email?: string;
+  phone?: string;
+  app_metadata: Record<string, any>;
+  user_metadata: Record<string, any>;
+  is_anonymous: boolean;
+  /** Access token expiry (Unix seconds); the header is void after it. */
+  exp: number;
+}
+
+/**
+ * The user `auth()` returns: a Supabase `User`, without `created_at` when it
+ * was forwarded by the middleware (the access token does not carry it).
+ */
+export type AuthUser = Omit<User, "created_at"> & { created_at?: string };
+
+const encoder = new TextEncoder();
+let signingKey: { secret: string; key: Promise<CryptoKey> } | null = null;
+
+const getSigningKey = (): Promise<CryptoKey> | null => {
+  const secret = process.env.AUTH_FORWARD_SECRET;
+  if (!secret) return null;
+  if (signingKey?.secret !== secret) {
+    signingKey = {
+      secret,
+      key: crypto.subtle.importKey(
+        "raw",
+        encoder.encode(secret),
+        { name: "HMAC", hash: "SHA-256" },
+        false,
+        ["sign", "verify"],
+      ),
+    };
+  }
+  return signingKey.key;
+};
+
+export const toForwardedUser = (
+  claims: SupabaseAccessTokenClaims,
+): ForwardedUser => ({
+  id: claims.sub,
+  email: claims.email,
+  phone: claims.phone,
+  app_metadata: claims.app_metadata ?? {},
+  user_metadata: claims.user_metadata ?? {},
+  is_anonymous: claims.is_anonymous ?? false,
+  exp: claims.exp,
+});
+
+/**
+ * Builds a user from forwarded claims. Fields that are not in the access
+ * token (identities, `created_at` and other timestamps) are absent; load the
+ * full user with `supabase.auth.getUser()` where those are needed.
+ */
+export const toUser = (forwarded: ForwardedUser): AuthUser => ({
+  id: forwarded.id,
+  aud: "authenticated",
+  role: "authenticated",
+  email: forwarded.email,
+  phone: forwarded.phone,
+  app_metadata: forwarded.app_metadata,
+  user_metadata: forwarded.user_metadata,
+  is_anonymous: forwarded.is_anonymous,
+});
+
+/**
+ * Serializes and signs a verified user for `FORWARDED_USER_HEADER`.
+ * @returns The header value, or null when AUTH_FORWARD_SECRET is not set.
+ */
+export const signForwardedUser = async (
+  user: ForwardedUser,
+): Promise<string | null> => {
+  const key = getSigningKey();
+  if (!key) return null;
+  const payload = bytesToBase64Url(encoder.encode(JSON.stringify(user)));
+  const signature = await crypto.subtle.sign(
+    "HMAC",
+    await key,
+    encoder.encode(payload),
+  );
+  return `${payload}.${bytesToBase64Url(new Uint8Array(signature))}`;
+};
+
+/**
+ * Verifies a `FORWARDED_USER_HEADER` value.
+ * @returns The forwarded user, or null if the header is missing, forged or
+ * its token has expired.
+ */
+export const readForwardedUser = async (
+  value: string | null,
+): Promise<ForwardedUser | null> => {
+  const key = getSigningKey();
+  if (!value || !key) return null;
+  const [payload, signature] = value.split(".");
+  if (!payload || !signature) return null;
+
+  try {
+    const valid = await crypto.subtle.verify(
+      "HMAC",
+      await key,
+      base64UrlToBytes(signature),
+      encoder.encode(payload),
+    );
+    if (!valid) return null;
+    const user = JSON.parse(
+      new TextDecoder().decode(base64UrlToBytes(payload)),
+    ) as ForwardedUser;
+    return user.exp > Date.now() / 1000 ? user : null;
+  } catch {
+    return null;
+  }
+};
@@ -0,0 +1,161 @@
+// Local verification of Supabase access tokens with Web Crypto, so it runs in
+// the Edge middleware without a dependency or a call to Supabase auth.
+// HS256 tokens are checked with SUPABASE_JWT_SECRET; ES256/RS256 tokens
+// (asymmetric signing keys) with the project's published JWKS.
+
+/** Claims Supabase puts in a user's access token. */
+export interface SupabaseAccessTokenClaims {
+  sub: string;
+  exp: number;
+  iat?: number;
+  iss?: string;
+  aud: string | string[];
+  role: string;
+  email?: string;
+  phone?: string;
+  app_metadata?: Record<string, any>;
+  user_metadata?: Record<string, any>;
+  is_anonymous?: boolean;
+  aal?: string;
+  session_id?: string;
+}
+
+/** Allowed clock difference between Supabase and this server, in seconds. */
+const CLOCK_SKEW_SECONDS = 30;
+const JWKS_TTL_MS = 10 * 60 * 1000;
+// A token with an unknown key id refetches the JWKS at most this often.
+const JWKS_MIN_REFETCH_MS = 30 * 1000;
+
+const encoder = new TextEncoder();
+
+export const base64UrlToBytes = (value: string): Uint8Array => {
+  const base64 = value.replace(/-/g, "+").replace(/_/g, "/");
+  const padded = base64 + "=".repeat((4 - (base64.length % 4)) % 4);
+  return Uint8Array.from(atob(padded), (char) => char.charCodeAt(0));
+};
+
+export const bytesToBase64Url = (bytes: Uint8Array): string =>
+  btoa(String.fromCharCode(...bytes))
+    .replace(/\+/g, "-")
+    .replace(/\//g, "_")
+    .replace(/=+$/, "");
+
+const decodeJson = <T>(segment: string): T =>
+  JSON.parse(new TextDecoder().decode(base64UrlToBytes(segment))) as T;
+
+const ALGORITHMS = {
+  ES256: { name: "ECDSA", namedCurve: "P-256", hash: "SHA-256" },
+  RS256: { name: "RSASSA-PKCS1-v1_5", hash: "SHA-256" },
+} as const;
+
+type AsymmetricAlgorithm = keyof typeof ALGORITHMS;
+
+let hmacKey: Promise<CryptoKey> | null = null;
+let jwks: { keys: Map<string, CryptoKey>; fetchedAt: number } | null = null;
+let jwksRequest: Promise<void> | null = null;
+
+const getHmacKey = (): Promise<CryptoKey> | null => {
+  const secret = process.env.SUPABASE_JWT_SECRET;
+  if (!secret) return null;
+  hmacKey ??= crypto.subtle.importKey(
+    "raw",
+    encoder.encode(secret),
+    { name: "HMAC", hash: "SHA-256" },
+    false,
+    ["verify"],
+  );
+  return hmacKey;
+};
+
+const refreshJwks = async () => {
+  const response = await fetch(
+    `${process.env.NEXT_PUBLIC_SUPABASE_URL}/auth/v1/.well-known/jwks.json`,
+  );
+  if (!response.ok) throw new Error(`JWKS request failed: ${response.status}`);
+  const { keys = [] } = (await response.json()) as { keys?: JsonWebKey[] };
+
+  const imported = new Map<string, CryptoKey>();
+  for (const jwk of keys as (JsonWebKey & { kid?: string })[]) {
+    const algorithm = ALGORITHMS[jwk.alg as AsymmetricAlgorithm];
+    if (!jwk.kid || !algorithm) continue;
+    imported.set(
+      jwk.kid,
+      await crypto.subtle.importKey("jwk", jwk, algorithm, false, ["verify"]),
+    );
+  }
+  jwks = { keys: imported, fetchedAt: Date.now() };
+};
+
+const getPublicKey = async (kid: string): Promise<CryptoKey | null> => {
+  const age = jwks ? Date.now() - jwks.fetchedAt : Infinity;
+  const known = jwks?.keys.get(kid);
+  if (known && age < JWKS_TTL_MS) return known;
+  // Refetch when stale, or when the key id is new (key rotation)
+  if (age >= JWKS_MIN_REFETCH_MS) {
+    jwksRequest ??= refreshJwks().finally(() => {
+      jwksRequest = null;
+    });
+    await jwksRequest;
+  }
+  return jwks?.keys.get(kid) ?? null;
+};
+
+/**
+ * Verifies a Supabase access token's signature, expiry, issuer and audience.
+ * @param token The session's `access_token`.
+ * @returns The token's claims, or null if it is invalid or expired.
+ * @throws If no key is available to check the token's algorithm, so the
+ * caller can fall back to asking Supabase.
+ */
+export const verifySupabaseAccessToken = async (
+  token: string,
+): Promise<SupabaseAccessTokenClaims | null> => {
+  const [headerSegment, payloadSegment, signatureSegment] = token.split(".");
+  if (!headerSegment || !payloadSegment || !signatureSegment) return null;
+
+  let header: { alg?: string; kid?: string };
+  let claims: SupabaseAccessTokenClaims;
+  try {
+    header = decodeJson(headerSegment);
+    claims = decodeJson(payloadSegment);
+  } catch {
+    return null;
+  }
+
+  const signed = encoder.encode(`${headerSegment}.${payloadSegment}`);
+  const signature = base64UrlToBytes(signatureSegment);
+  let valid: boolean;
+  if (header.alg === "HS256") {
+    const key = getHmacKey();
+    if (!key) throw new Error("SUPABASE_JWT_SECRET is needed for HS256");
+    valid = await crypto.subtle.verify("HMAC", await key, signature, signed);
+  } else if (header.alg && header.alg in ALGORITHMS && header.kid) {
+    const key = await getPublicKey(header.kid);
+    if (!key) return null;
+    valid = await crypto.subtle.verify(
+      ALGORITHMS[header.alg as AsymmetricAlgorithm],
+      key,
+      signature,
+      signed,
+    );
+  } else {
+    return null;
+  }
+  if (!valid) return null;
+
+  const now = Math.floor(Date.now() / 1000);
+  const audiences = Array.isArray(claims.aud) ? claims.aud : [claims.aud];
+  const issuer = `${process.env.NEXT_PUBLIC_SUPABASE_URL}/auth/v1`;
+  if (
+    typeof claims.sub !== "string" ||
+    typeof claims.exp !== "number" ||
+    claims.exp + CLOCK_SKEW_SECONDS <= now ||
+    (claims.iat !== undefined && claims.iat - CLOCK_SKEW_SECONDS > now) ||
+    (claims.iss !== undefined && claims.iss !== issuer) ||
+    !audiences.includes("authenticated") ||
+    claims.role !== "authenticated"
+  ) {
+    return null;
+  }
+  return claims;
+};
@@ -1,71 +1,113 @@
-import { createServerClient } from "@supabase/ssr";
+import { createServerClient, type CookieOptions } from "@supabase/ssr";
+import type { SupabaseClient } from "@supabase/supabase-js";
 import { NextResponse, type NextRequest } from "next/server";
+import { classifyRoute } from "@/lib/routes/classify";
+import {
+  FORWARDED_USER_HEADER,
+  type ForwardedUser,
+  signForwardedUser,
+  toForwardedUser,
+} from "./forwarded-user";
+import { verifySupabaseAccessToken } from "./jwt";
+import { readSessionCookie } from "./session-cookie";
 
-// Define paths that don't require authentication
-const publicPaths = [
-  "/", // Allow access to the home page
-  "/auth/login",
-  "/auth/register",
-  "/auth/forgot-password",
-  "/auth/update-password",
-  "/auth/verify-request",
-  "/auth/verify-otp",
-  "/auth/callback", // Supabase auth callback
-  "/auth/auth-error", // Auth error page,
-  "/login",
-  "/register",
-  "/forgot-password",
-  "/update-password",
-  // Add any other public paths, like API routes if needed
-];
+// SUPABASE_AUTH_VERIFICATION=local checks the access token in the middleware
+// (signature, expiry, claims) and only calls Supabase to refresh it; the
+// default, "remote", asks Supabase auth on every request. Local mode needs
+// SUPABASE_JWT_SECRET for HS256 projects (asymmetric keys come from the
+// project's JWKS) and forwards the user to `auth()` when AUTH_FORWARD_SECRET
+// is set.
+const verifyLocally = process.env.SUPABASE_AUTH_VERIFICATION === "local";
 
-// Define paths that authenticated users should NOT be able to access (e.g., login page)
-const authOnlyPaths = [
-  "/auth/login",
-  "/auth/register",
-  "/auth/forgot-password",
-];
+// Refresh this long before the access token expires, like supabase-js.
+const REFRESH_MARGIN_SECONDS = 90;
 
-export async function updateSession(request: NextRequest) {
-  let supabaseResponse = NextResponse.next({
-    request,
-  });
+// Why local verification fell back to Supabase, reported once per reason: a
+// missing key would otherwise log on every request.
+const reportedFallbacks = new Set<string>();
 
-  const supabase = createServerClient(
-    process.env.NEXT_PUBLIC_SUPABASE_URL!,
-    process.env.NEXT_PUBLIC_SUPABASE_ANON_KEY!,
-    {
-      cookies: {
-        getAll() {
-          return request.cookies.getAll();
-        },
-        setAll(cookiesToSet) {
-          cookiesToSet.forEach(({ name, value, options }) =>
-            request.cookies.set(name, value),
-          );
-          supabaseResponse = NextResponse.next({
-            request,
-          });
-          cookiesToSet.forEach(({ name, value, options }) =>
-            supabaseResponse.cookies.set(name, value, options),
-          );
-        },
-      },
-    },
-  );
+type CookieToSet = { name: string; value: string; options: CookieOptions };
 
+/**
+ * Verifies the session cookie without Supabase unless the access token is
+ * about to expire, in which case the client refreshes it (and the cookies).
+ * @returns The verified user, null when signed out or invalid, or undefined
+ * when no verification key is available and Supabase must be asked.
+ */
+async function verifySessionLocally(
+  request: NextRequest,
+  getClient: () => SupabaseClient,
+): Promise<ForwardedUser | null | undefined> {
+  let session = readSessionCookie(request.cookies.getAll());
+  if (!session) return null;
+
+  const now = Math.floor(Date.now() / 1000);
+  if ((session.expires_at ?? 0) - now < REFRESH_MARGIN_SECONDS) {
+    const { data, error } = await getClient().auth.getSession();
+    if (error || !data.session) return null;
+    session = data.session;
+  }
+
+  try {
+    const claims = await verifySupabaseAccessToken(session.access_token);
+    return claims ? toForwardedUser(claims) : null;
+  } catch (error) {
+    const reason = error instanceof Error ? error.message : String(error);
+    if (!reportedFallbacks.has(reason)) {
+      reportedFallbacks.add(reason);
+      console.warn(
+        "Local session verification unavailable, asking Supabase:",
+        error,
+      );
+    }
+    return undefined;
+  }
+}
+
+export async function updateSession(request: NextRequest) {
+  // Route rules come from routes.config.mjs (see lib/routes)
   const { pathname } = request.nextUrl;
+  const routeKind = classifyRoute(pathname);
 
-  const {
-    data: { user },
-  } = await supabase.auth.getUser();
+  // Excluded and public routes need no session: skip the Supabase client,
+  // but never pass on a client-sent identity header
+  if (routeKind === "excluded" || routeKind === "public") {
+    const requestHeaders = new Headers(request.headers);
+    requestHeaders.delete(FORWARDED_USER_HEADER);
+    return NextResponse.next({ request: { headers: requestHeaders } });
+  }
 
-  // Check if the current path is public
-  const isPublicPath = publicPaths.some(
-    (path) => pathname === path || (path !== "/" && pathname.startsWith(path)),
-  );
+  const cookiesToForward: CookieToSet[] = [];
+  let supabase: SupabaseClient | null = null;
+  // Created on demand: local verification only needs it to refresh tokens
+  const getClient = () =>
+    (supabase ??= createServerClient(
+      process.env.NEXT_PUBLIC_SUPABASE_URL!,
+      process.env.NEXT_PUBLIC_SUPABASE_ANON_KEY!,
+      {
+        cookies: {
+          getAll() {
+            return request.cookies.getAll();
+          },
+          setAll(cookiesToSet) {
+            cookiesToSet.forEach(({ name, value }) =>
+              request.cookies.set(name, value),
+            );
+            cookiesToForward.push(...cookiesToSet);
+          },
+        },
+      },
+    ));
+
+  const forwardedUser = verifyLocally
+    ? await verifySessionLocally(request, getClient)
+    : undefined;
+  const user =
+    forwardedUser !== undefined
+      ? forwardedUser
+      : (await getClient().auth.getUser()).data.user;
 
-  if (!user && !isPublicPath) {
+  if (!user && routeKind === "protected") {
     // Not logged in and trying to access a protected path
     const url = request.nextUrl.clone();
     url.pathname = "/login";
@@ -73,7 +115,7 @@ export async function updateSession(request: NextRequest) {
     return NextResponse.redirect(url);
   }
 
-  if (user && authOnlyPaths.some((path) => pathname.startsWith(path))) {
+  if (user && routeKind === "auth-only") {
     // Logged in user trying to access login/register/forgot-password pages
     const url = request.nextUrl.clone();
     url.pathname = "/dashboard"; // Redirect to dashboard
@@ -83,6 +125,19 @@ export async function updateSession(request: NextRequest) {
     return NextResponse.redirect(url);
   }
 
+  // Forward the verified user to server components; a client-sent copy of
+  // the header is always dropped
+  const requestHeaders = new Headers(request.headers);
+  requestHeaders.delete(FORWARDED_USER_HEADER);
+  const signedUser = forwardedUser && (await signForwardedUser(forwardedUser));
+  if (signedUser) requestHeaders.set(FORWARDED_USER_HEADER, signedUser);
+
   // Refresh session and allow access
+  const supabaseResponse = NextResponse.next({
+    request: { headers: requestHeaders },
+  });
+  cookiesToForward.forEach(({ name, value, options }) =>
+    supabaseResponse.cookies.set(name, value, options),
+  );
   return supabaseResponse;
 }
@@ -0,0 +1,54 @@
+import { base64UrlToBytes } from "./jwt";
+
+/** The parts of a stored Supabase session the middleware needs. */
+export interface StoredSession {
+  access_token: string;
+  refresh_token: string;
+  expires_at?: number;
+}
+
+const BASE64_PREFIX = "base64-";
+
+/** Cookie name @supabase/ssr stores the session under for this project. */
+export const sessionCookieName = (): string => {
+  const hostname = new URL(process.env.NEXT_PUBLIC_SUPABASE_URL!).hostname;
+  return `sb-${hostname.split(".")[0]}-auth-token`;
+};
+
+/**
+ * Reads the session @supabase/ssr keeps in cookies, without a Supabase
+ * client: joins chunked cookies (`name.0`, `name.1`, ...) and decodes the
+ * `base64-` encoding. The contents are unverified; check the access token
+ * before trusting anything in it.
+ * @param cookies The request's cookies.
+ * @returns The stored session, or null if there is none or it is malformed.
+ */
+export const readSessionCookie = (
+  cookies: { name: string; value: string }[],
+): StoredSession | null => {
+  const name = sessionCookieName();
+  const byName = new Map(cookies.map((cookie) => [cookie.name, cookie.value]));
+
+  let raw = byName.get(name);
+  if (raw === undefined) {
+    const chunks: string[] = [];
+    for (let index = 0; byName.has(`${name}.${index}`); index += 1) {
+      chunks.push(byName.get(`${name}.${index}`)!);
+    }
+    if (chunks.length === 0) return null;
+    raw = chunks.join("");
+  }
+
+  try {
+    const json = raw.startsWith(BASE64_PREFIX)
+      ? new TextDecoder().decode(
+          base64UrlToBytes(raw.slice(BASE64_PREFIX.length)),
+        )
+      : raw;
+    const session = JSON.parse(json) as Partial<StoredSession>;
+    if (!session.access_token || !session.refresh_token) return null;
+    return session as StoredSession;
+  } catch {
+    return null;
+  }
+};
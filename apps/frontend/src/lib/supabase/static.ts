@@ -0,0 +1,19 @@
+import { Database } from "@maestro/supabase";
+import { createClient } from "@supabase/supabase-js";
+
+/**
+ * Cookie-less anonymous client for public data (e.g. the Stripe catalog).
+ * Unlike `createSupabaseServerClient` it does not read request cookies, so it
+ * can be used inside `unstable_cache` and shared across requests. Never use it
+ * for user data: it only sees what RLS allows the `anon` role.
+ */
+export const supabaseStatic = createClient<Database>(
+  process.env.NEXT_PUBLIC_SUPABASE_URL!,
+  process.env.NEXT_PUBLIC_SUPABASE_ANON_KEY!,
+  {
+    auth: {
+      autoRefreshToken: false,
+      persistSession: false,
+    },
+  },
+);
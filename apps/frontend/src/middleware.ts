@@ -6,14 +6,11 @@ export async function middleware(request: NextRequest) {
 }
 
 export const config = {
+  // Excludes proxied, static and public routes (routes.config.mjs), so
+  // middleware only runs where a session is checked.
   matcher: [
-    /*
-     * Match all request paths except for the ones starting with:
-     * - _next/static (static files)
-     * - _next/image (image optimization files)
-     * - favicon.ico (favicon file)
-     * Feel free to modify this pattern to include more paths.
-     */
-    "/((?!_next/static|_next/image|favicon.ico|.*\\.(?:svg|png|jpg|jpeg|gif|webp)$).*)",
+    // <route-matcher> generated by pnpm routes:generate
+    "/((?!ingest(?:/|$)|_next/static(?:/|$)|_next/image(?:/|$)|favicon\\.ico$|api/revalidate(?:/|$)|$|auth/update-password(?:/|$)|auth/verify-request(?:/|$)|auth/verify-otp(?:/|$)|auth/callback(?:/|$)|auth/auth-error(?:/|$)|login(?:/|$)|register(?:/|$)|forgot-password(?:/|$)|update-password(?:/|$)|.*\\.(?:svg|png|jpg|jpeg|gif|webp)$).*)",
+    // </route-matcher>
   ],
 };
@@ -1,5 +1,5 @@
 import Stripe from "stripe";
-import { initStripe, StripeOptions } from "../utils"; // Import shared utility
+import { resolveStripe, StripeOptions } from "../utils"; // Import shared utility
 
 /**
  * Creates a new Stripe Checkout Session.
@@ -36,7 +36,7 @@ export const createCheckoutSession = async ({
   params: Stripe.Checkout.SessionCreateParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.Checkout.Session> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
 
   // Basic validation for required fields
   if (!params.line_items || params.line_items.length === 0) {
@@ -6,7 +6,14 @@ import {
   UseMutationResult,
 } from "@tanstack/react-query";
 import Stripe from "stripe";
-import { StripeOptions } from "../utils"; // Import shared options type
+import {
+  applyStripeOptimisticUpdate,
+  reconcileStripeObject,
+  rollbackStripeOptimisticUpdate,
+  stripeUpdateMutationKey,
+  StripeOptions,
+  StripeOptimisticSnapshot,
+} from "../utils"; // Import shared options type
 import {
   createCustomer,
   fetchCustomerById,
@@ -132,18 +139,28 @@ export const useUpdateStripeCustomer = (): UseMutationResult<
       id: string;
       params: Stripe.CustomerUpdateParams;
       options?: Stripe.RequestOptions;
-    }
+    },
+    StripeOptimisticSnapshot
   >({
+    mutationKey: stripeUpdateMutationKey("stripeCustomers"),
     mutationFn: async ({ stripe, id, params, options }) => {
       if (!stripe) throw new Error("Stripe client or options are required.");
       return updateCustomer({ stripe, id, params, options });
     },
-    onSuccess: (data, variables) => {
-      queryClient.invalidateQueries({ queryKey: ["stripeCustomers"] });
-      queryClient.invalidateQueries({
-        queryKey: ["stripeCustomers", variables.id],
-      });
-      queryClient.setQueryData(["stripeCustomers", variables.id], data);
+    // Show the edit immediately in the detail cache and every list holding it.
+    // Only params that map 1:1 onto customer fields are patched.
+    onMutate: ({ id, params }) =>
+      applyStripeOptimisticUpdate(queryClient, "stripeCustomers", id, {
+        name: params.name,
+        email: params.email,
+        phone: params.phone,
+        description: params.description,
+        metadata: params.metadata,
+      }),
+    onError: (_error, _variables, snapshot) =>
+      rollbackStripeOptimisticUpdate(queryClient, "stripeCustomers", snapshot),
+    onSettled: (data) => {
+      if (data) reconcileStripeObject(queryClient, "stripeCustomers", data);
     },
   });
 };
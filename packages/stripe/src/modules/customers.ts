@@ -1,5 +1,10 @@
 import Stripe from "stripe";
-import { initStripe, StripeOptions } from "../utils";
+import {
+  paginateStripe,
+  PaginateOptions,
+  resolveStripe,
+  StripeOptions,
+} from "../utils";
 
 /**
  * Creates a new Stripe customer.
@@ -18,7 +23,7 @@ export const createCustomer = async ({
   params: Stripe.CustomerCreateParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.Customer> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.customers.create(params, options);
 };
 
@@ -42,7 +47,7 @@ export const fetchCustomerById = async ({
   params?: Stripe.CustomerRetrieveParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.Customer | Stripe.DeletedCustomer> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.customers.retrieve(id, params, options);
 };
 
@@ -66,7 +71,7 @@ export const updateCustomer = async ({
   params: Stripe.CustomerUpdateParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.Customer> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.customers.update(id, params, options);
 };
 
@@ -88,7 +93,7 @@ export const deleteCustomer = async ({
   id: string;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.DeletedCustomer> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.customers.del(id, options);
 };
 
@@ -109,6 +114,43 @@ export const listCustomers = async ({
   params?: Stripe.CustomerListParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.ApiList<Stripe.Customer>> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.customers.list(params, options);
 };
+
+/**
+ * Streams every Stripe customer matching the filters, fetching pages of up to
+ * 100 lazily (the next page is prefetched while the current one is consumed).
+ * Memory stays bounded regardless of how many customers exist.
+ * @param args Object containing stripe client/options, list filters and pagination options.
+ * @param args.stripe - Initialized Stripe client instance or StripeOptions.
+ * @param args.params - Filters for listing customers, without cursor fields. See Stripe.CustomerListParams.
+ * @param args.options - Optional Stripe request options.
+ * @param args.pageSize - Objects per request (default: 100).
+ * @param args.maxItems - Stop after this many customers.
+ * @param args.prefetch - Prefetch the next page (default: true).
+ * @returns An async iterator over Stripe.Customer objects.
+ * @example
+ * for await (const customer of iterateCustomers({ stripe, maxItems: 10_000 })) {
+ *   await exportCustomer(customer);
+ * }
+ */
+export const iterateCustomers = ({
+  stripe,
+  params,
+  options,
+  ...paginate
+}: {
+  stripe: Stripe | StripeOptions;
+  params?: Omit<
+    Stripe.CustomerListParams,
+    "limit" | "starting_after" | "ending_before"
+  >;
+  options?: Stripe.RequestOptions;
+} & PaginateOptions): AsyncGenerator<Stripe.Customer, void, undefined> => {
+  const stripeClient = resolveStripe(stripe);
+  return paginateStripe(
+    (cursor) => stripeClient.customers.list({ ...params, ...cursor }, options),
+    paginate,
+  );
+};
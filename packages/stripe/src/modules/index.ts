@@ -6,4 +6,6 @@ export * from "./customers";
 export * from "./customers.react";
 export * from "./subscriptions";
 export * from "./subscriptions.react";
+export * from "./usage";
 export * from "./webhooks";
+export * from "./webhook-bus";
@@ -13,7 +13,14 @@ import {
   deleteProduct,
   listProducts,
 } from "./products"; // Assuming products.ts is in the same directory
-import { StripeOptions } from "../utils"; // Import shared options type
+import {
+  applyStripeOptimisticUpdate,
+  reconcileStripeObject,
+  rollbackStripeOptimisticUpdate,
+  stripeUpdateMutationKey,
+  StripeOptions,
+  StripeOptimisticSnapshot,
+} from "../utils"; // Import shared options type
 
 // Define a type for the options object to pass the Stripe client/options
 interface StripeHookOptions {
@@ -134,20 +141,27 @@ export const useUpdateStripeProduct = (): UseMutationResult<
       id: string;
       params: Stripe.ProductUpdateParams;
       options?: Stripe.RequestOptions;
-    }
+    },
+    StripeOptimisticSnapshot
   >({
+    mutationKey: stripeUpdateMutationKey("stripeProducts"),
     mutationFn: async ({ stripe, id, params, options }) => {
       if (!stripe) throw new Error("Stripe client or options are required.");
       return updateProduct({ stripe, id, params, options });
     },
-    onSuccess: (data, variables) => {
-      // Invalidate the list and the specific item query
-      queryClient.invalidateQueries({ queryKey: ["stripeProducts"] });
-      queryClient.invalidateQueries({
-        queryKey: ["stripeProducts", variables.id],
-      });
-      // Update the cache for the updated item
-      queryClient.setQueryData(["stripeProducts", variables.id], data);
+    // Show the edit immediately in the detail cache and every list holding it.
+    // Only params that map 1:1 onto product fields are patched.
+    onMutate: ({ id, params }) =>
+      applyStripeOptimisticUpdate(queryClient, "stripeProducts", id, {
+        name: params.name,
+        description: params.description,
+        active: params.active,
+        metadata: params.metadata,
+      }),
+    onError: (_error, _variables, snapshot) =>
+      rollbackStripeOptimisticUpdate(queryClient, "stripeProducts", snapshot),
+    onSettled: (data) => {
+      if (data) reconcileStripeObject(queryClient, "stripeProducts", data);
     },
   });
 };
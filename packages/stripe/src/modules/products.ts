@@ -1,5 +1,10 @@
 import Stripe from "stripe";
-import { initStripe, StripeOptions } from "../utils"; // Import shared utility
+import {
+  paginateStripe,
+  PaginateOptions,
+  resolveStripe,
+  StripeOptions,
+} from "../utils"; // Import shared utility
 
 /**
  * Creates a new Stripe product.
@@ -21,7 +26,7 @@ export const createProduct = async ({
   params: Stripe.ProductCreateParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.Product> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.products.create(params, options);
 };
 
@@ -48,7 +53,7 @@ export const fetchProductById = async ({
   params?: Stripe.ProductRetrieveParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.Product | Stripe.DeletedProduct> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.products.retrieve(id, params, options);
 };
 
@@ -75,7 +80,7 @@ export const updateProduct = async ({
   params: Stripe.ProductUpdateParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.Product> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.products.update(id, params, options);
 };
 
@@ -99,7 +104,7 @@ export const deleteProduct = async ({
   id: string;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.DeletedProduct> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.products.del(id, options);
 };
 
@@ -123,6 +128,44 @@ export const listProducts = async ({
   params?: Stripe.ProductListParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.ApiList<Stripe.Product>> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.products.list(params, options);
 };
+
+/**
+ * Streams every Stripe product matching the filters, fetching pages of up to
+ * 100 lazily (the next page is prefetched while the current one is consumed).
+ * Memory stays bounded regardless of how many products exist.
+ * @param args Object containing stripe client/options, list filters and pagination options.
+ * @param args.stripe - Initialized Stripe client instance or StripeOptions.
+ * @param args.params - Filters for listing products, without cursor fields. See Stripe.ProductListParams.
+ * @param args.options - Optional Stripe request options.
+ * @param args.pageSize - Objects per request (default: 100).
+ * @param args.maxItems - Stop after this many products.
+ * @param args.prefetch - Prefetch the next page (default: true).
+ * @returns An async iterator over Stripe.Product objects.
+ * @example
+ * const stripe = initStripe({ apiKey: 'sk_test_...' });
+ * for await (const product of iterateProducts({ stripe, params: { active: true } })) {
+ *   console.log(product.name);
+ * }
+ */
+export const iterateProducts = ({
+  stripe,
+  params,
+  options,
+  ...paginate
+}: {
+  stripe: Stripe | StripeOptions;
+  params?: Omit<
+    Stripe.ProductListParams,
+    "limit" | "starting_after" | "ending_before"
+  >;
+  options?: Stripe.RequestOptions;
+} & PaginateOptions): AsyncGenerator<Stripe.Product, void, undefined> => {
+  const stripeClient = resolveStripe(stripe);
+  return paginateStripe(
+    (cursor) => stripeClient.products.list({ ...params, ...cursor }, options),
+    paginate,
+  );
+};
@@ -6,7 +6,14 @@ import {
   UseMutationResult,
 } from "@tanstack/react-query";
 import Stripe from "stripe";
-import { StripeOptions } from "../utils";
+import {
+  applyStripeOptimisticUpdate,
+  reconcileStripeObject,
+  rollbackStripeOptimisticUpdate,
+  stripeUpdateMutationKey,
+  StripeOptions,
+  StripeOptimisticSnapshot,
+} from "../utils";
 import {
   createSubscription,
   fetchSubscriptionById,
@@ -143,26 +150,30 @@ export const useUpdateStripeSubscription = (): UseMutationResult<
       id: string;
       params: Stripe.SubscriptionUpdateParams;
       options?: Stripe.RequestOptions;
-    }
+    },
+    StripeOptimisticSnapshot
   >({
+    mutationKey: stripeUpdateMutationKey("stripeSubscriptions"),
     mutationFn: async ({ stripe, id, params, options }) => {
       if (!stripe) throw new Error("Stripe client or options are required.");
       return updateSubscription({ stripe, id, params, options });
     },
-    onSuccess: (data, variables) => {
-      queryClient.invalidateQueries({ queryKey: ["stripeSubscriptions"] });
-      queryClient.invalidateQueries({
-        queryKey: ["stripeSubscriptions", variables.id],
-      });
-      queryClient.setQueryData(["stripeSubscriptions", variables.id], data);
-      // Invalidate customer-specific subscription lists if applicable
-      if (data.customer) {
-        const customerId =
-          typeof data.customer === "string" ? data.customer : data.customer.id;
-        queryClient.invalidateQueries({
-          queryKey: ["stripeSubscriptions", { customer: customerId }],
-        });
-      }
+    // Show the edit immediately in the detail cache and every list holding it.
+    // Only params that map 1:1 onto subscription fields are patched.
+    onMutate: ({ id, params }) =>
+      applyStripeOptimisticUpdate(queryClient, "stripeSubscriptions", id, {
+        description: params.description,
+        cancel_at_period_end: params.cancel_at_period_end,
+        metadata: params.metadata,
+      }),
+    onError: (_error, _variables, snapshot) =>
+      rollbackStripeOptimisticUpdate(
+        queryClient,
+        "stripeSubscriptions",
+        snapshot,
+      ),
+    onSettled: (data) => {
+      if (data) reconcileStripeObject(queryClient, "stripeSubscriptions", data);
     },
   });
 };
@@ -1,5 +1,10 @@
 import Stripe from "stripe";
-import { initStripe, StripeOptions } from "../utils";
+import {
+  paginateStripe,
+  PaginateOptions,
+  resolveStripe,
+  StripeOptions,
+} from "../utils";
 
 /**
  * Creates a new Stripe subscription.
@@ -19,7 +24,7 @@ export const createSubscription = async ({
   params: Stripe.SubscriptionCreateParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.Subscription> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   if (!params.customer) {
     throw new Error("Subscription creation requires a customer ID.");
   }
@@ -49,7 +54,7 @@ export const fetchSubscriptionById = async ({
   params?: Stripe.SubscriptionRetrieveParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.Subscription> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.subscriptions.retrieve(id, params, options);
 };
 
@@ -74,7 +79,7 @@ export const updateSubscription = async ({
   params: Stripe.SubscriptionUpdateParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.Subscription> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.subscriptions.update(id, params, options);
 };
 
@@ -99,7 +104,7 @@ export const cancelSubscription = async ({
   params?: Stripe.SubscriptionCancelParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.Subscription> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   // The SDK method was 'del', now it's 'cancel'
   return stripeClient.subscriptions.cancel(id, params, options);
 };
@@ -122,6 +127,47 @@ export const listSubscriptions = async ({
   params?: Stripe.SubscriptionListParams;
   options?: Stripe.RequestOptions;
 }): Promise<Stripe.ApiList<Stripe.Subscription>> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
   return stripeClient.subscriptions.list(params, options);
 };
+
+/**
+ * Streams every Stripe subscription matching the filters, fetching pages of up to
+ * 100 lazily (the next page is prefetched while the current one is consumed).
+ * Memory stays bounded regardless of how many subscriptions exist.
+ * @param args Object containing stripe client/options, list filters and pagination options.
+ * @param args.stripe - Initialized Stripe client instance or StripeOptions.
+ * @param args.params - Filters for listing subscriptions, without cursor fields. See Stripe.SubscriptionListParams.
+ * @param args.options - Optional Stripe request options.
+ * @param args.pageSize - Objects per request (default: 100).
+ * @param args.maxItems - Stop after this many subscriptions.
+ * @param args.prefetch - Prefetch the next page (default: true).
+ * @returns An async iterator over Stripe.Subscription objects.
+ * @example
+ * for await (const subscription of iterateSubscriptions({
+ *   stripe,
+ *   params: { status: "all" },
+ * })) {
+ *   await checkSubscription(subscription);
+ * }
+ */
+export const iterateSubscriptions = ({
+  stripe,
+  params,
+  options,
+  ...paginate
+}: {
+  stripe: Stripe | StripeOptions;
+  params?: Omit<
+    Stripe.SubscriptionListParams,
+    "limit" | "starting_after" | "ending_before"
+  >;
+  options?: Stripe.RequestOptions;
+} & PaginateOptions): AsyncGenerator<Stripe.Subscription, void, undefined> => {
+  const stripeClient = resolveStripe(stripe);
+  return paginateStripe(
+    (cursor) =>
+      stripeClient.subscriptions.list({ ...params, ...cursor }, options),
+    paginate,
+  );
+};
@@ -0,0 +1,347 @@
+import { mapWithConcurrency } from "@maestro/utils";
+import Stripe from "stripe";
+import { resolveStripe, StripeOptions } from "../utils";
+
+/**
+ * Reports usage to a Stripe billing meter. API version 2025-03-31.basil
+ * removed usage records on subscription items; metered prices bill from
+ * meter events, which are attributed to a customer.
+ * @param args.stripe - Initialized Stripe client instance or StripeOptions.
+ * @param args.eventName - The meter's `event_name`.
+ * @param args.customerId - The Stripe customer the usage belongs to.
+ * @param args.value - Usage quantity (a positive integer).
+ * @param args.identifier - Unique id; Stripe ignores repeats of it for at
+ * least 24 hours, which makes retries safe.
+ * @param args.timestamp - When the usage happened, in Unix seconds.
+ * @returns A promise that resolves to the created meter event.
+ */
+export const reportMeterEvent = async ({
+  stripe,
+  eventName,
+  customerId,
+  value,
+  identifier,
+  timestamp,
+}: {
+  stripe: Stripe | StripeOptions;
+  eventName: string;
+  customerId: string;
+  value: number;
+  identifier?: string;
+  timestamp?: number;
+}): Promise<Stripe.Billing.MeterEvent> => {
+  const stripeClient = resolveStripe(stripe);
+  return stripeClient.billing.meterEvents.create({
+    event_name: eventName,
+    payload: { stripe_customer_id: customerId, value: String(value) },
+    identifier,
+    timestamp,
+  });
+};
+
+/**
+ * Usage drained from a store for reporting: totals per Stripe customer. The
+ * batch id is part of every meter event identifier, so a batch resent after a
+ * crash is not counted twice.
+ */
+export interface UsageBatch {
+  id: string;
+  /** Epoch ms when the batch was drained; reported as the event time. */
+  createdAt: number;
+  totals: Record<string, number>;
+}
+
+/**
+ * Where a `UsageAggregator` keeps pending usage and unreported batches. A
+ * store must persist a drained batch before returning it, and keep it until
+ * every customer in it is acknowledged.
+ */
+export interface UsageStore {
+  /** Adds to a customer's pending total. */
+  increment(customerId: string, value: number): Promise<void> | void;
+  /**
+   * Moves all pending totals into a new batch, atomically with respect to
+   * `increment`, or returns null when nothing is pending.
+   */
+  drain(): Promise<UsageBatch | null>;
+  /** Batches drained but not fully reported, oldest first. */
+  unacknowledged(): Promise<UsageBatch[]>;
+  /** Marks customers of a batch as reported; drops the batch when empty. */
+  acknowledge(batchId: string, customerIds: string[]): Promise<void>;
+  /**
+   * Claims a batch for reporting, so instances sharing a store do not send
+   * it concurrently. Stores used by one process can omit this.
+   */
+  claim?(batchId: string, ttlMs: number): Promise<boolean>;
+  /** Persists pending totals; called on the aggregator's checkpoint timer. */
+  checkpoint?(): Promise<void>;
+}
+
+/** Serialized state of a `MemoryUsageStore`. */
+export interface UsageCheckpointState {
+  pending: Record<string, number>;
+  batches: UsageBatch[];
+}
+
+/** Durable storage for a `MemoryUsageStore`, e.g. a local file. */
+export interface UsageCheckpoint {
+  load(): Promise<UsageCheckpointState | null>;
+  save(state: UsageCheckpointState): Promise<void>;
+}
+
+export const createUsageBatchId = (): string =>
+  `ub_${Date.now().toString(36)}${Math.random().toString(36).slice(2, 10)}`;
+
+/**
+ * In-process usage store for a single instance. With a checkpoint, drained
+ * batches are saved before they are reported and pending totals on every
+ * `checkpoint()`, so a crash loses at most the usage recorded since the last
+ * checkpoint and never reports a batch twice.
+ */
+export class MemoryUsageStore implements UsageStore {
+  private pending = new Map<string, number>();
+  private batches: UsageBatch[] = [];
+  private loaded: Promise<void> | null = null;
+
+  constructor(private readonly storage?: UsageCheckpoint) {}
+
+  increment(customerId: string, value: number): void {
+    this.pending.set(customerId, (this.pending.get(customerId) ?? 0) + value);
+  }
+
+  async drain(): Promise<UsageBatch | null> {
+    await this.load();
+    if (this.pending.size === 0) return null;
+    const batch: UsageBatch = {
+      id: createUsageBatchId(),
+      createdAt: Date.now(),
+      totals: Object.fromEntries(this.pending),
+    };
+    this.pending = new Map();
+    this.batches.push(batch);
+    await this.save();
+    return batch;
+  }
+
+  async unacknowledged(): Promise<UsageBatch[]> {
+    await this.load();
+    return this.batches.map((batch) => ({
+      ...batch,
+      totals: { ...batch.totals },
+    }));
+  }
+
+  async acknowledge(batchId: string, customerIds: string[]): Promise<void> {
+    const batch = this.batches.find(({ id }) => id === batchId);
+    if (!batch) return;
+    for (const customerId of customerIds) delete batch.totals[customerId];
+    if (Object.keys(batch.totals).length === 0) {
+      this.batches = this.batches.filter(({ id }) => id !== batchId);
+    }
+    await this.save();
+  }
+
+  async checkpoint(): Promise<void> {
+    await this.load();
+    await this.save();
+  }
+
+  // Restores a previous run's state once, merging usage recorded since.
+  private load(): Promise<void> {
+    if (!this.loaded) {
+      this.loaded = (async () => {
+        const state = await this.storage?.load();
+        if (!state) return;
+        for (const [customerId, value] of Object.entries(state.pending)) {
+          this.increment(customerId, value);
+        }
+        this.batches = [...state.batches, ...this.batches];
+      })();
+    }
+    return this.loaded;
+  }
+
+  private async save(): Promise<void> {
+    await this.storage?.save({
+      pending: Object.fromEntries(this.pending),
+      batches: this.batches,
+    });
+  }
+}
+
+export interface UsageAggregatorOptions {
+  stripe: Stripe | StripeOptions;
+  /** The billing meter's `event_name`. */
+  eventName: string;
+  /** Pending usage and unreported batches (default: in memory). */
+  store?: UsageStore;
+  /** Flush interval for `start()` in ms (default: 10000). */
+  flushIntervalMs?: number;
+  /** Checkpoint interval for `start()` in ms (default: 1000). */
+  checkpointIntervalMs?: number;
+  /** Meter events sent concurrently during a flush (default: 4). */
+  concurrency?: number;
+  /** Called for each customer total that failed to report. */
+  onError?: (error: unknown, customerId: string, batchId: string) => void;
+}
+
+export interface UsageFlushResult {
+  /** Meter events accepted by Stripe. */
+  reported: number;
+  /** Totals Stripe rejected permanently (e.g. unknown customer); dropped. */
+  rejected: number;
+  /** Totals that failed transiently; retried on the next flush. */
+  failed: number;
+  /** Sum of the usage values accepted. */
+  usage: number;
+}
+
+// 4xx errors other than rate limiting will not succeed on retry. That
+// includes a repeated identifier, i.e. the total was already reported.
+const isPermanentError = (error: unknown) =>
+  error instanceof Stripe.errors.StripeError &&
+  typeof error.statusCode === "number" &&
+  error.statusCode >= 400 &&
+  error.statusCode < 500 &&
+  error.statusCode !== 409 &&
+  error.statusCode !== 429;
+
+/**
+ * Aggregates metered usage and reports it to Stripe in batches: one meter
+ * event per customer per flush instead of one per increment. Each event's
+ * identifier is derived from its batch, so retries after a failed request
+ * or a crash are idempotent.
+ * @example
+ * const usage = new UsageAggregator({
+ *   stripe,
+ *   eventName: "analytics_events",
+ * });
+ * usage.start();
+ * usage.record(customerId, events.length);
+ * // On shutdown
+ * await usage.stop();
+ */
+export class UsageAggregator {
+  private readonly stripe: Stripe | StripeOptions;
+  private readonly eventName: string;
+  private readonly store: UsageStore;
+  private readonly flushIntervalMs: number;
+  private readonly checkpointIntervalMs: number;
+  private readonly concurrency: number;
+  private readonly onError?: UsageAggregatorOptions["onError"];
+
+  private flushing: Promise<UsageFlushResult> | null = null;
+  private timers: ReturnType<typeof setInterval>[] = [];
+
+  constructor(options: UsageAggregatorOptions) {
+    this.stripe = options.stripe;
+    this.eventName = options.eventName;
+    this.store = options.store ?? new MemoryUsageStore();
+    this.flushIntervalMs = options.flushIntervalMs ?? 10_000;
+    this.checkpointIntervalMs = options.checkpointIntervalMs ?? 1_000;
+    this.concurrency = options.concurrency ?? 4;
+    this.onError = options.onError;
+  }
+
+  /**
+   * Adds usage for a customer. Cheap: it only touches the store.
+   * @param customerId The Stripe customer id.
+   * @param value Usage quantity, a positive integer (default: 1).
+   */
+  record(customerId: string, value = 1): Promise<void> | void {
+    if (!Number.isInteger(value) || value <= 0) {
+      throw new Error(`Usage must be a positive integer, got ${value}`);
+    }
+    return this.store.increment(customerId, value);
+  }
+
+  /**
+   * Reports pending usage and retries unreported batches. Concurrent calls
+   * share one flush.
+   */
+  flush(): Promise<UsageFlushResult> {
+    if (!this.flushing) {
+      this.flushing = this.runFlush().finally(() => {
+        this.flushing = null;
+      });
+    }
+    return this.flushing;
+  }
+
+  /** Starts the periodic flush and checkpoint timers. */
+  start(): void {
+    if (this.timers.length > 0) return;
+    const flush = setInterval(() => {
+      this.flush().catch((error) => this.onError?.(error, "*", "*"));
+    }, this.flushIntervalMs);
+    this.timers.push(flush);
+    if (this.store.checkpoint) {
+      const checkpoint = setInterval(() => {
+        this.store.checkpoint!().catch((error) =>
+          this.onError?.(error, "*", "checkpoint"),
+        );
+      }, this.checkpointIntervalMs);
+      this.timers.push(checkpoint);
+    }
+    for (const timer of this.timers) timer.unref?.();
+  }
+
+  /** Stops the timers and reports what is pending. */
+  async stop(): Promise<UsageFlushResult> {
+    for (const timer of this.timers) clearInterval(timer);
+    this.timers = [];
+    return this.flush();
+  }
+
+  private async runFlush(): Promise<UsageFlushResult> {
+    const result: UsageFlushResult = {
+      reported: 0,
+      rejected: 0,
+      failed: 0,
+      usage: 0,
+    };
+    // Older batches first: a batch is drained before it is reported, so the
+    // new one also appears in `unacknowledged`.
+    await this.store.drain();
+    const batches = await this.store.unacknowledged();
+
+    for (const batch of batches) {
+      const claimTtlMs = Math.max(this.flushIntervalMs, 30_000);
+      if (this.store.claim && !(await this.store.claim(batch.id, claimTtlMs))) {
+        continue;
+      }
+
+      const outcomes = mapWithConcurrency(
+        Object.entries(batch.totals),
+        this.concurrency,
+        async ([customerId, value]) => {
+          try {
+            await reportMeterEvent({
+              stripe: this.stripe,
+              eventName: this.eventName,
+              customerId,
+              value,
+              identifier: `${batch.id}-${customerId}`,
+              timestamp: Math.floor(batch.createdAt / 1000),
+            });
+            return { customerId, value, status: "reported" as const };
+          } catch (error: unknown) {
+            this.onError?.(error, customerId, batch.id);
+            const status = isPermanentError(error) ? "rejected" : "failed";
+            return { customerId, value, status };
+          }
+        },
+      );
+
+      const done: string[] = [];
+      for await (const { customerId, value, status } of outcomes) {
+        result[status] += 1;
+        if (status === "failed") continue;
+        if (status === "reported") result.usage += value;
+        done.push(customerId);
+      }
+      await this.store.acknowledge(batch.id, done);
+    }
+    return result;
+  }
+}
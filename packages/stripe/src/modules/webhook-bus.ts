@@ -0,0 +1,276 @@
+import Stripe from "stripe";
+
+/** A Stripe event narrowed to one type, e.g. `StripeEventOf<"invoice.paid">` */
+export type StripeEventOf<T extends Stripe.Event["type"]> = Extract<
+  Stripe.Event,
+  { type: T }
+>;
+
+/**
+ * Context passed to every subscriber call. `signal` aborts when the
+ * subscriber's timeout elapses; long-running work should observe it.
+ */
+export interface WebhookSubscriberContext {
+  signal: AbortSignal;
+  /** Delivery attempt, 1 for inline dispatch; set by the queue on retries. */
+  attempt: number;
+}
+
+export type WebhookSubscriber<E extends Stripe.Event = Stripe.Event> = (
+  event: E,
+  context: WebhookSubscriberContext,
+) => Promise<void> | void;
+
+export interface WebhookSubscriberOptions {
+  /** Unique name; identifies the subscriber in results, logs and queue jobs. */
+  name: string;
+  /** Time limit per call in ms (default: the bus's `defaultTimeoutMs`). */
+  timeoutMs?: number;
+  /**
+   * Hand the event to the bus's queue instead of running it inline, so it
+   * survives restarts and is retried by the queue. Runs inline when the bus
+   * has no queue.
+   */
+  durable?: boolean;
+}
+
+/** A subscriber call handed to a queue for durable dispatch. */
+export interface WebhookQueueJob {
+  subscriber: string;
+  event: Stripe.Event;
+}
+
+/**
+ * Queue used for durable subscribers (e.g. a BullMQ queue). The queue's
+ * worker runs each job with `StripeWebhookBus.runSubscriber`, which throws on
+ * failure so the queue can retry.
+ */
+export interface WebhookQueueAdapter {
+  enqueue(job: WebhookQueueJob): Promise<void>;
+}
+
+export interface WebhookDispatchResult {
+  subscriber: string;
+  /**
+   * Whether the subscriber is durable. A durable failure (inline or while
+   * enqueuing) must not be acknowledged, so Stripe redelivers the event.
+   */
+  durable: boolean;
+  status: "succeeded" | "failed" | "timed_out" | "queued";
+  durationMs: number;
+  error?: Error;
+}
+
+export interface StripeWebhookBusOptions {
+  /** Time limit for subscribers without their own, in ms (default: 10000). */
+  defaultTimeoutMs?: number;
+  /** Queue for durable subscribers; without one they run inline. */
+  queue?: WebhookQueueAdapter;
+}
+
+interface Registration {
+  types: Set<string> | "*";
+  handler: WebhookSubscriber<any>;
+  options: Required<Omit<WebhookSubscriberOptions, "durable">> & {
+    durable: boolean;
+  };
+}
+
+class WebhookTimeoutError extends Error {
+  constructor(subscriber: string, timeoutMs: number) {
+    super(`Subscriber ${subscriber} timed out after ${timeoutMs}ms`);
+    this.name = "WebhookTimeoutError";
+  }
+}
+
+/**
+ * Fans verified Stripe events out to any number of typed subscribers. Unlike
+ * `handleWebhookEvent`, every matching subscriber runs (wildcards included),
+ * inline subscribers run in parallel, each with its own timeout, and one
+ * subscriber failing does not affect the others. Durable subscribers are
+ * enqueued and run by a worker instead.
+ * @example
+ * const bus = new StripeWebhookBus({ defaultTimeoutMs: 5000 });
+ * bus.on("checkout.session.completed", fulfilOrder, { name: "fulfilment" });
+ * bus.on("checkout.session.completed", sendReceipt, {
+ *   name: "receipt-email",
+ *   durable: true,
+ * });
+ * bus.onAny(trackEvent, { name: "analytics", timeoutMs: 1000 });
+ *
+ * const event = await constructWebhookEvent({ ... });
+ * const results = await bus.publish(event);
+ */
+export class StripeWebhookBus {
+  private readonly registrations = new Map<string, Registration>();
+  private readonly defaultTimeoutMs: number;
+  private readonly queue?: WebhookQueueAdapter;
+
+  constructor(options: StripeWebhookBusOptions = {}) {
+    this.defaultTimeoutMs = options.defaultTimeoutMs ?? 10_000;
+    this.queue = options.queue;
+  }
+
+  /**
+   * Subscribes to one or more event types.
+   * @returns A function that removes the subscriber.
+   */
+  on<T extends Stripe.Event["type"]>(
+    types: T | T[],
+    handler: WebhookSubscriber<StripeEventOf<T>>,
+    options: WebhookSubscriberOptions,
+  ): () => void {
+    const list = Array.isArray(types) ? types : [types];
+    return this.register(new Set<string>(list), handler, options);
+  }
+
+  /**
+   * Subscribes to every event the bus publishes.
+   * @returns A function that removes the subscriber.
+   */
+  onAny(
+    handler: WebhookSubscriber,
+    options: WebhookSubscriberOptions,
+  ): () => void {
+    return this.register("*", handler, options);
+  }
+
+  /** Whether any subscriber listens to this event type. */
+  handles(type: string): boolean {
+    for (const { types } of this.registrations.values()) {
+      if (types === "*" || types.has(type)) return true;
+    }
+    return false;
+  }
+
+  /**
+   * Dispatches an event to every matching subscriber. Inline subscribers run
+   * concurrently; durable ones are enqueued. Never throws: failures and
+   * timeouts are reported per subscriber in the results.
+   * @param event A verified Stripe event.
+   * @returns One result per matching subscriber.
+   */
+  async publish(event: Stripe.Event): Promise<WebhookDispatchResult[]> {
+    const matching = Array.from(this.registrations.values()).filter(
+      ({ types }) => types === "*" || types.has(event.type),
+    );
+    return Promise.all(
+      matching.map((registration) =>
+        registration.options.durable && this.queue
+          ? this.enqueue(registration, event)
+          : this.invoke(registration, event, 1),
+      ),
+    );
+  }
+
+  /**
+   * Runs one named subscriber for an event, e.g. from a queue worker.
+   * @param subscriber The subscriber's name.
+   * @param event The event from the queue job.
+   * @param attempt The queue's delivery attempt (default: 1).
+   * @throws If the subscriber is unknown, fails or times out.
+   */
+  async runSubscriber(
+    subscriber: string,
+    event: Stripe.Event,
+    attempt = 1,
+  ): Promise<void> {
+    const registration = this.registrations.get(subscriber);
+    if (!registration) {
+      throw new Error(`Unknown webhook subscriber: ${subscriber}`);
+    }
+    const result = await this.invoke(registration, event, attempt);
+    if (result.error) throw result.error;
+  }
+
+  private register(
+    types: Set<string> | "*",
+    handler: WebhookSubscriber<any>,
+    options: WebhookSubscriberOptions,
+  ): () => void {
+    if (this.registrations.has(options.name)) {
+      throw new Error(`Webhook subscriber ${options.name} already exists`);
+    }
+    const registration: Registration = {
+      types,
+      handler,
+      options: {
+        name: options.name,
+        timeoutMs: options.timeoutMs ?? this.defaultTimeoutMs,
+        durable: options.durable ?? false,
+      },
+    };
+    this.registrations.set(options.name, registration);
+    return () => {
+      if (this.registrations.get(options.name) === registration) {
+        this.registrations.delete(options.name);
+      }
+    };
+  }
+
+  private async enqueue(
+    { options }: Registration,
+    event: Stripe.Event,
+  ): Promise<WebhookDispatchResult> {
+    const startedAt = Date.now();
+    try {
+      await this.queue!.enqueue({ subscriber: options.name, event });
+      return {
+        subscriber: options.name,
+        durable: options.durable,
+        status: "queued",
+        durationMs: Date.now() - startedAt,
+      };
+    } catch (error: unknown) {
+      return {
+        subscriber: options.name,
+        durable: options.durable,
+        status: "failed",
+        durationMs: Date.now() - startedAt,
+        error: error instanceof Error ? error : new Error(String(error)),
+      };
+    }
+  }
+
+  private async invoke(
+    { handler, options }: Registration,
+    event: Stripe.Event,
+    attempt: number,
+  ): Promise<WebhookDispatchResult> {
+    const startedAt = Date.now();
+    const controller = new AbortController();
+    let timer: ReturnType<typeof setTimeout> | undefined;
+    const timeout = new Promise<never>((_, reject) => {
+      timer = setTimeout(() => {
+        const error = new WebhookTimeoutError(options.name, options.timeoutMs);
+        controller.abort(error);
+        reject(error);
+      }, options.timeoutMs);
+    });
+
+    try {
+      await Promise.race([
+        Promise.resolve().then(() =>
+          handler(event, { signal: controller.signal, attempt }),
+        ),
+        timeout,
+      ]);
+      return {
+        subscriber: options.name,
+        durable: options.durable,
+        status: "succeeded",
+        durationMs: Date.now() - startedAt,
+      };
+    } catch (error: unknown) {
+      return {
+        subscriber: options.name,
+        durable: options.durable,
+        status: error instanceof WebhookTimeoutError ? "timed_out" : "failed",
+        durationMs: Date.now() - startedAt,
+        error: error instanceof Error ? error : new Error(String(error)),
+      };
+    } finally {
+      clearTimeout(timer);
+    }
+  }
+}
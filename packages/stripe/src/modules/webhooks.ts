@@ -1,5 +1,5 @@
 import Stripe from "stripe";
-import { initStripe, StripeOptions } from "../utils";
+import { resolveStripe, StripeOptions } from "../utils";
 
 /**
  * Verifies the Stripe webhook signature and constructs the event object.
@@ -48,7 +48,7 @@ export const constructWebhookEvent = async ({
   signature: string | string[];
   secret: string;
 }): Promise<Stripe.Event> => {
-  const stripeClient = stripe instanceof Stripe ? stripe : initStripe(stripe);
+  const stripeClient = resolveStripe(stripe);
 
   if (!signature) {
     throw new Error("Missing 'Stripe-Signature' header.");
@@ -88,6 +88,7 @@ export type StripeWebhookHandlerMap = {
 
 /**
  * Dispatches a verified Stripe event to the appropriate handler function.
+ * For several independent handlers per event type, use `StripeWebhookBus`.
  *
  * @param args Object containing the verified event and the handlers map.
  * @param args.event - The verified Stripe.Event object (returned from constructWebhookEvent).
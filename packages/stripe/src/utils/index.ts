@@ -1 +1,6 @@
 export * from "./stripe";
+export * from "./objects";
+export * from "./optimistic";
+export * from "./pagination";
+export * from "./reconcile";
+export * from "./scheduler";
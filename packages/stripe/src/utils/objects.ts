@@ -0,0 +1,22 @@
+/**
+ * Converts a Stripe timestamp (Unix seconds) to an ISO string.
+ * @param unixSeconds A Stripe `created`, `current_period_end`, ... value.
+ */
+export const fromStripeTimestamp = (unixSeconds: number): string =>
+  new Date(unixSeconds * 1000).toISOString();
+
+/**
+ * Returns the id of an expandable Stripe field, which holds either the id or
+ * the expanded object.
+ * @example
+ * stripeId(subscription.customer) // "cus_123"
+ */
+export function stripeId(value: string | { id: string }): string;
+export function stripeId(
+  value: string | { id: string } | null | undefined,
+): string | null;
+export function stripeId(
+  value: string | { id: string } | null | undefined,
+): string | null {
+  return typeof value === "string" ? value : (value?.id ?? null);
+}
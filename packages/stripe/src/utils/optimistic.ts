@@ -0,0 +1,221 @@
+import { isListQueryKey, isNewerVersion } from "@maestro/utils";
+import { QueryClient } from "@tanstack/react-query";
+
+/**
+ * Minimal shape of a Stripe object held in React Query caches.
+ */
+type CachedObject = { id: string } & Record<string, unknown>;
+
+/**
+ * What `applyStripeOptimisticUpdate` replaced, passed back as mutation context
+ * so a failed update can be rolled back.
+ */
+export interface StripeOptimisticSnapshot {
+  id: string;
+  /** Previous values of the patched fields, or null when they were not cached. */
+  previous: Record<string, unknown> | null;
+}
+
+/**
+ * Mutation key used by the optimistic update hooks of a resource. Lets
+ * `reconcileStripeObject` detect overlapping updates to the same object.
+ * @param resource The first query key element, e.g. "stripeProducts".
+ * @returns The mutation key, e.g. `["stripeProducts", "update"]`.
+ */
+export const stripeUpdateMutationKey = (resource: string) =>
+  [resource, "update"] as const;
+
+/**
+ * Applies `update` to the object with the given id in a detail value or in the
+ * `data` array of a `Stripe.ApiList`. Returns the input unchanged when absent.
+ */
+const updateCachedObject = (
+  data: unknown,
+  id: string,
+  update: (cached: CachedObject) => CachedObject,
+): unknown => {
+  if (typeof data !== "object" || data === null) return data;
+  const list = (data as { data?: unknown }).data;
+  if (Array.isArray(list)) {
+    if (!list.some((item: CachedObject) => item?.id === id)) return data;
+    return {
+      ...data,
+      data: list.map((item: CachedObject) =>
+        item?.id === id ? update(item) : item,
+      ),
+    };
+  }
+  return (data as CachedObject).id === id
+    ? update(data as CachedObject)
+    : data;
+};
+
+const findCachedObject = (
+  queryClient: QueryClient,
+  resource: string,
+  id: string,
+): CachedObject | undefined => {
+  const detail = queryClient.getQueryData<CachedObject>([resource, id]);
+  if (detail) return detail;
+  for (const [, data] of queryClient.getQueriesData({ queryKey: [resource] })) {
+    const list = (data as { data?: unknown } | undefined)?.data;
+    if (!Array.isArray(list)) continue;
+    const match = list.find((item: CachedObject) => item?.id === id);
+    if (match) return match;
+  }
+  return undefined;
+};
+
+const writeToCaches = (
+  queryClient: QueryClient,
+  resource: string,
+  id: string,
+  update: (cached: CachedObject) => CachedObject,
+) => {
+  queryClient
+    .getQueriesData({ queryKey: [resource] })
+    .forEach(([queryKey, data]) => {
+      const next = updateCachedObject(data, id, update);
+      if (next !== data) queryClient.setQueryData(queryKey, next);
+    });
+};
+
+/**
+ * Converts update params into the fields they change on the object, following
+ * Stripe's update semantics: metadata is merged key by key and an empty string
+ * clears a value (or, for `metadata`, every key).
+ */
+const toObjectFields = (
+  cached: CachedObject | undefined,
+  params: Record<string, unknown>,
+): Record<string, unknown> =>
+  Object.fromEntries(
+    Object.entries(params)
+      .filter(([, value]) => value !== undefined)
+      .map(([key, value]) => {
+        if (key === "metadata") {
+          if (value === "" || value === null) return [key, {}];
+          const merged: Record<string, unknown> = {
+            ...((cached?.metadata as Record<string, unknown>) ?? {}),
+            ...(value as Record<string, unknown>),
+          };
+          Object.keys(merged).forEach((field) => {
+            if (merged[field] === "") delete merged[field];
+          });
+          return [key, merged];
+        }
+        return [key, value === "" ? null : value];
+      }),
+  );
+
+/**
+ * Applies an update to cached Stripe objects before the API confirms it.
+ * In-flight fetches for the resource are cancelled so they cannot overwrite
+ * the optimistic values, then the changed fields are written into the detail
+ * cache and every cached list holding the object. Call from `onMutate`.
+ * @param queryClient The React Query client.
+ * @param resource The first query key element, e.g. "stripeProducts".
+ * @param id The id of the object being updated.
+ * @param params The subset of update params that map 1:1 onto object fields.
+ * @returns A snapshot to pass to `rollbackStripeOptimisticUpdate` on error.
+ * @example
+ * onMutate: ({ id, params }) =>
+ *   applyStripeOptimisticUpdate(queryClient, "stripeProducts", id, {
+ *     name: params.name,
+ *     metadata: params.metadata,
+ *   }),
+ */
+export const applyStripeOptimisticUpdate = async (
+  queryClient: QueryClient,
+  resource: string,
+  id: string,
+  params: Record<string, unknown>,
+): Promise<StripeOptimisticSnapshot> => {
+  await queryClient.cancelQueries({ queryKey: [resource] });
+
+  const cached = findCachedObject(queryClient, resource, id);
+  const fields = toObjectFields(cached, params);
+  const keys = Object.keys(fields);
+  const previous = cached
+    ? Object.fromEntries(keys.map((key) => [key, cached[key] ?? null]))
+    : null;
+
+  writeToCaches(queryClient, resource, id, (object) => ({
+    ...object,
+    ...fields,
+  }));
+  return { id, previous };
+};
+
+/**
+ * Reverts an optimistic update after the mutation failed, restoring only the
+ * patched fields. When the previous values were unknown, the resource's
+ * queries are refetched instead. Call from `onError`.
+ * @param queryClient The React Query client.
+ * @param resource The first query key element, e.g. "stripeProducts".
+ * @param snapshot The snapshot returned by `applyStripeOptimisticUpdate`.
+ */
+export const rollbackStripeOptimisticUpdate = (
+  queryClient: QueryClient,
+  resource: string,
+  snapshot: StripeOptimisticSnapshot | undefined,
+): void => {
+  if (!snapshot) return;
+  const { id, previous } = snapshot;
+  if (previous) {
+    writeToCaches(queryClient, resource, id, (object) => ({
+      ...object,
+      ...previous,
+    }));
+    return;
+  }
+  void queryClient.invalidateQueries({ queryKey: [resource] });
+};
+
+/**
+ * Writes the object returned by the API into the caches once an update has
+ * settled. Conflicts are resolved the same way for every resource:
+ * - while a later update to the same object is still pending, its optimistic
+ *   values are kept and that mutation reconciles when it settles;
+ * - if the cache already holds a newer version of the object (by `updated`,
+ *   e.g. refetched after another client's change), it is kept;
+ * - otherwise the server object wins.
+ * This is the rule `reconcileServerRow` applies to Supabase rows; objects
+ * without an `updated` field (e.g. customers) skip the version check.
+ * Lists are marked stale without refetching, so filters affected by the change
+ * (e.g. `active`) are re-evaluated the next time a list is used.
+ * @param queryClient The React Query client.
+ * @param resource The first query key element, e.g. "stripeProducts".
+ * @param object The object returned by the update.
+ * @example
+ * onSettled: (data) => {
+ *   if (data) reconcileStripeObject(queryClient, "stripeProducts", data);
+ * },
+ */
+export const reconcileStripeObject = (
+  queryClient: QueryClient,
+  resource: string,
+  object: { id: string },
+): void => {
+  // The settling mutation still counts as pending while its callbacks run.
+  const pending = queryClient.isMutating({
+    mutationKey: stripeUpdateMutationKey(resource),
+    predicate: (mutation) =>
+      (mutation.state.variables as { id?: string } | undefined)?.id ===
+      object.id,
+  });
+  if (pending > 1) return;
+
+  const cached = findCachedObject(queryClient, resource, object.id);
+  if (isNewerVersion(cached, object as CachedObject, "updated")) return;
+
+  writeToCaches(queryClient, resource, object.id, () => ({
+    ...(object as CachedObject),
+  }));
+  queryClient.setQueryData([resource, object.id], object);
+  void queryClient.invalidateQueries({
+    queryKey: [resource],
+    predicate: (query) => isListQueryKey(query.queryKey),
+    refetchType: "none",
+  });
+};
@@ -0,0 +1,98 @@
+import Stripe from "stripe";
+
+// Streams mapped objects with bounded fan-out; re-exported so callers that
+// page through Stripe need only this package.
+export { mapWithConcurrency } from "@maestro/utils";
+
+/** Largest page Stripe's list endpoints return. */
+export const STRIPE_MAX_PAGE_SIZE = 100;
+
+/**
+ * Options shared by the streaming `iterate*` helpers.
+ */
+export interface PaginateOptions {
+  /** Objects per API request, 1-100 (default: 100). */
+  pageSize?: number;
+  /** Stop after this many objects in total (default: no limit). */
+  maxItems?: number;
+  /** Fetch the next page while the current one is consumed (default: true). */
+  prefetch?: boolean;
+}
+
+/**
+ * Fetches one page of a Stripe list endpoint. `starting_after` is the id of
+ * the last object of the previous page (undefined for the first page).
+ */
+export type StripePageFetcher<T> = (cursor: {
+  limit: number;
+  starting_after?: string;
+}) => Promise<Stripe.ApiList<T>>;
+
+/**
+ * Streams a Stripe list endpoint page by page, holding at most two pages in
+ * memory: with `prefetch` the next page is requested as soon as the current
+ * one arrives, so network time overlaps with the consumer's work. Breaking
+ * out of the loop stops the pagination.
+ * @param fetchPage Fetches one page for the given cursor.
+ * @param options Page size, item limit and prefetching.
+ * @returns An async iterator over non-empty pages.
+ * @example
+ * for await (const page of paginateStripePages(
+ *   (cursor) => stripe.invoices.list({ ...cursor, status: "open" }),
+ * )) {
+ *   await saveInvoices(page);
+ * }
+ */
+export async function* paginateStripePages<T extends { id: string }>(
+  fetchPage: StripePageFetcher<T>,
+  options: PaginateOptions = {},
+): AsyncGenerator<T[], void, undefined> {
+  const pageSize = Math.min(
+    Math.max(options.pageSize ?? STRIPE_MAX_PAGE_SIZE, 1),
+    STRIPE_MAX_PAGE_SIZE,
+  );
+  const prefetch = options.prefetch ?? true;
+  let remaining = options.maxItems ?? Infinity;
+  if (remaining <= 0) return;
+
+  const request = (startingAfter?: string) => {
+    const pending = fetchPage({
+      limit: Math.min(pageSize, remaining),
+      starting_after: startingAfter,
+    });
+    // A prefetched page may fail while the consumer is still busy; the error
+    // is rethrown when the page is awaited, not reported as unhandled.
+    pending.catch(() => undefined);
+    return pending;
+  };
+
+  let pending: Promise<Stripe.ApiList<T>> | null = request();
+  while (pending) {
+    const page: Stripe.ApiList<T> = await pending;
+    const items = page.data.slice(0, remaining);
+    remaining -= items.length;
+
+    const last = page.data[page.data.length - 1];
+    const next =
+      page.has_more && remaining > 0 && last ? () => request(last.id) : null;
+    pending = prefetch && next ? next() : null;
+
+    if (items.length > 0) yield items;
+    if (!prefetch && next) pending = next();
+  }
+}
+
+/**
+ * Streams a Stripe list endpoint object by object. See `paginateStripePages`.
+ * @param fetchPage Fetches one page for the given cursor.
+ * @param options Page size, item limit and prefetching.
+ * @returns An async iterator over the listed objects.
+ */
+export async function* paginateStripe<T extends { id: string }>(
+  fetchPage: StripePageFetcher<T>,
+  options: PaginateOptions = {},
+): AsyncGenerator<T, void, undefined> {
+  for await (const page of paginateStripePages(fetchPage, options)) {
+    yield* page;
+  }
+}
@@ -0,0 +1,56 @@
+/**
+ * A difference between Stripe and a local mirror, found by
+ * `reconcileStripeList`.
+ */
+export type StripeMirrorDiff<R, L> =
+  | { kind: "missing"; remote: R }
+  | { kind: "changed"; remote: R; local: L };
+
+/**
+ * Diffs Stripe objects against a local mirror one page at a time, so memory
+ * stays constant however large the account is: only the current Stripe page
+ * and the local rows with the same ids are held. Rows that exist only in the
+ * mirror are not reported; detect them by stamping rows during the run (see
+ * the catalog sync's `last_event_at` sweep).
+ * @param args.remote Pages of Stripe objects, e.g. from `paginateStripePages`.
+ * @param args.fetchLocal Loads the mirror rows for a page's ids.
+ * @param args.localId Returns the Stripe id a mirror row belongs to.
+ * @param args.isEqual Whether a mirror row is up to date with its object.
+ * @returns An async iterator over missing and outdated mirror rows.
+ * @example
+ * const pages = paginateStripePages((cursor) =>
+ *   stripe.subscriptions.list({ ...cursor, status: "all" }),
+ * );
+ * for await (const diff of reconcileStripeList({
+ *   remote: pages,
+ *   fetchLocal: (ids) => loadEntitlements(ids),
+ *   localId: (row) => row.stripe_subscription_id,
+ *   isEqual: (subscription, row) => subscription.status === row.status,
+ * })) {
+ *   await repair(diff.remote);
+ * }
+ */
+export async function* reconcileStripeList<R extends { id: string }, L>({
+  remote,
+  fetchLocal,
+  localId,
+  isEqual,
+}: {
+  remote: AsyncIterable<R[]>;
+  fetchLocal: (ids: string[]) => Promise<L[]>;
+  localId: (row: L) => string;
+  isEqual: (remote: R, local: L) => boolean;
+}): AsyncGenerator<StripeMirrorDiff<R, L>, void, undefined> {
+  for await (const page of remote) {
+    const rows = await fetchLocal(page.map((object) => object.id));
+    const byId = new Map(rows.map((row) => [localId(row), row]));
+    for (const object of page) {
+      const local = byId.get(object.id);
+      if (!local) {
+        yield { kind: "missing", remote: object };
+      } else if (!isEqual(object, local)) {
+        yield { kind: "changed", remote: object, local };
+      }
+    }
+  }
+}
@@ -0,0 +1,274 @@
+/**
+ * Priority lane of a scheduled Stripe request. `interactive` requests (e.g.
+ * checkout) are always dequeued first; `batch` requests (backfills, syncs,
+ * reconciliation) only use capacity above the interactive reserve.
+ */
+export type StripeLane = "interactive" | "batch";
+
+/** Stripe's documented per-account limits, in requests per second. */
+export const STRIPE_LIVE_RATE_LIMIT = 100;
+export const STRIPE_TEST_RATE_LIMIT = 25;
+
+export interface StripeSchedulerOptions {
+  /** Sustained request rate (default: the account's live/test limit). */
+  ratePerSecond?: number;
+  /** Bucket capacity, i.e. the largest burst (default: `ratePerSecond`). */
+  burst?: number;
+  /** Share of the bucket batch requests cannot touch (default: 0.25). */
+  interactiveReserve?: number;
+  /** Maximum concurrent requests across both lanes (default: 25). */
+  maxConcurrency?: number;
+}
+
+export interface StripeSchedulerMetrics {
+  queued: Record<StripeLane, number>;
+  inFlight: number;
+  completed: Record<StripeLane, number>;
+  /** Requests rejected because they waited longer than their deadline. */
+  expired: Record<StripeLane, number>;
+  /** Moving average of the time requests waited in the queue, in ms. */
+  averageWaitMs: Record<StripeLane, number>;
+  /** Current (adaptive) rate; drops after 429s and recovers on success. */
+  ratePerSecond: number;
+  /** Number of 429 responses seen. */
+  rateLimited: number;
+  /** Epoch ms until which dispatch is paused after a 429, or null. */
+  pausedUntil: number | null;
+}
+
+interface QueuedRequest {
+  run: () => void;
+}
+
+// Each success raises the adaptive rate by this many requests per second.
+const RATE_RECOVERY_STEP = 0.5;
+const MIN_RATE = 1;
+const MAX_BACKOFF_MS = 30_000;
+const WAIT_AVERAGE_WEIGHT = 0.1;
+
+const emptyLanes = (): Record<StripeLane, number> => ({
+  interactive: 0,
+  batch: 0,
+});
+
+/**
+ * Rejection of a scheduled request that was still queued at its deadline.
+ * The request was never sent.
+ */
+export class StripeQueueTimeoutError extends Error {
+  constructor(lane: StripeLane, maxWaitMs: number) {
+    super(`Stripe request waited over ${maxWaitMs}ms in the ${lane} queue`);
+    this.name = "StripeQueueTimeoutError";
+  }
+}
+
+/**
+ * Token-bucket scheduler for Stripe requests with two priority lanes and
+ * AIMD rate adaptation: a 429 halves the rate and pauses dispatch for the
+ * `Retry-After` period (or an exponential backoff); successes restore it
+ * gradually. Limits apply per process, so size `ratePerSecond` to this
+ * process's share when several instances call the same account.
+ */
+export class StripeScheduler {
+  private readonly maxRate: number;
+  private readonly burst: number;
+  private readonly reserve: number;
+  private readonly maxConcurrency: number;
+
+  private rate: number;
+  private tokens: number;
+  private refilledAt = Date.now();
+  private pausedUntil = 0;
+  private consecutiveLimits = 0;
+  private timer: ReturnType<typeof setTimeout> | null = null;
+  private inFlight = 0;
+
+  private readonly queues: Record<StripeLane, QueuedRequest[]> = {
+    interactive: [],
+    batch: [],
+  };
+  private readonly completed = emptyLanes();
+  private readonly expired = emptyLanes();
+  private readonly averageWaitMs = emptyLanes();
+  private rateLimited = 0;
+
+  constructor(options: StripeSchedulerOptions = {}) {
+    this.maxRate = options.ratePerSecond ?? STRIPE_TEST_RATE_LIMIT;
+    this.burst = options.burst ?? this.maxRate;
+    this.reserve = this.burst * (options.interactiveReserve ?? 0.25);
+    this.maxConcurrency = options.maxConcurrency ?? 25;
+    this.rate = this.maxRate;
+    this.tokens = this.burst;
+  }
+
+  /**
+   * Runs `request` once the lane's turn comes and a token is available.
+   * @param request Starts the request with the time it spent queued, in ms;
+   * the scheduler counts it in flight until the returned promise settles.
+   * @param lane Priority lane (default: "interactive").
+   * @param maxWaitMs Longest the request may stay queued; past it, it is
+   * dropped and the promise rejects with `StripeQueueTimeoutError`.
+   * @returns The request's result.
+   */
+  schedule<T>(
+    request: (waitedMs: number) => Promise<T>,
+    lane: StripeLane = "interactive",
+    maxWaitMs?: number,
+  ): Promise<T> {
+    return new Promise<T>((resolve, reject) => {
+      const enqueuedAt = Date.now();
+      const queue = this.queues[lane];
+      const expiry =
+        maxWaitMs === undefined
+          ? null
+          : setTimeout(() => {
+              const index = queue.indexOf(queued);
+              if (index === -1) return;
+              queue.splice(index, 1);
+              this.expired[lane] += 1;
+              reject(new StripeQueueTimeoutError(lane, maxWaitMs));
+            }, maxWaitMs);
+      const queued: QueuedRequest = {
+        run: () => {
+          if (expiry) clearTimeout(expiry);
+          const waitedMs = Date.now() - enqueuedAt;
+          this.recordWait(lane, waitedMs);
+          this.inFlight += 1;
+          Promise.resolve()
+            .then(() => request(waitedMs))
+            .then(resolve, reject)
+            .finally(() => {
+              this.inFlight -= 1;
+              this.completed[lane] += 1;
+              this.pump();
+            });
+        },
+      };
+      queue.push(queued);
+      this.pump();
+    });
+  }
+
+  /**
+   * Reports a 429: halves the rate, drains the bucket and pauses dispatch.
+   * @param retryAfterSeconds The `Retry-After` header value, if present.
+   */
+  onRateLimited(retryAfterSeconds?: number): void {
+    this.rateLimited += 1;
+    this.consecutiveLimits += 1;
+    this.rate = Math.max(MIN_RATE, this.rate / 2);
+    this.tokens = 0;
+    const backoffMs =
+      retryAfterSeconds !== undefined && retryAfterSeconds > 0
+        ? retryAfterSeconds * 1000
+        : Math.min(MAX_BACKOFF_MS, 500 * 2 ** this.consecutiveLimits);
+    this.pausedUntil = Math.max(this.pausedUntil, Date.now() + backoffMs);
+    this.pump();
+  }
+
+  /** Reports a response that was not rate limited. */
+  onSuccess(): void {
+    this.consecutiveLimits = 0;
+    this.rate = Math.min(this.maxRate, this.rate + RATE_RECOVERY_STEP);
+  }
+
+  /** Returns a snapshot of queue depths, throughput and the current rate. */
+  getMetrics(): StripeSchedulerMetrics {
+    return {
+      queued: {
+        interactive: this.queues.interactive.length,
+        batch: this.queues.batch.length,
+      },
+      inFlight: this.inFlight,
+      completed: { ...this.completed },
+      expired: { ...this.expired },
+      averageWaitMs: { ...this.averageWaitMs },
+      ratePerSecond: this.rate,
+      rateLimited: this.rateLimited,
+      pausedUntil: this.pausedUntil > Date.now() ? this.pausedUntil : null,
+    };
+  }
+
+  private recordWait(lane: StripeLane, waitMs: number) {
+    this.averageWaitMs[lane] +=
+      (waitMs - this.averageWaitMs[lane]) * WAIT_AVERAGE_WEIGHT;
+  }
+
+  private refill(now: number) {
+    this.tokens = Math.min(
+      this.burst,
+      this.tokens + ((now - this.refilledAt) / 1000) * this.rate,
+    );
+    this.refilledAt = now;
+  }
+
+  private wakeIn(delayMs: number) {
+    if (this.timer) clearTimeout(this.timer);
+    this.timer = setTimeout(
+      () => {
+        this.timer = null;
+        this.pump();
+      },
+      Math.max(1, Math.ceil(delayMs)),
+    );
+  }
+
+  private pump() {
+    const now = Date.now();
+    this.refill(now);
+    if (now < this.pausedUntil) {
+      this.wakeIn(this.pausedUntil - now);
+      return;
+    }
+
+    while (this.inFlight < this.maxConcurrency) {
+      const lane: StripeLane | null =
+        this.queues.interactive.length > 0
+          ? "interactive"
+          : this.queues.batch.length > 0
+            ? "batch"
+            : null;
+      if (!lane) return;
+
+      // Batch requests leave `reserve` tokens for interactive bursts.
+      const needed =
+        lane === "batch" ? Math.min(1 + this.reserve, this.burst) : 1;
+      if (this.tokens < needed) {
+        this.wakeIn(((needed - this.tokens) / this.rate) * 1000);
+        return;
+      }
+
+      this.tokens -= 1;
+      this.queues[lane].shift()!.run();
+    }
+  }
+}
+
+const schedulers = new Map<string, StripeScheduler>();
+
+/**
+ * Returns the shared scheduler for an API key, creating it on first use.
+ * Defaults to Stripe's live or test limit depending on the key. Options only
+ * apply when the scheduler is created; call this before the first scheduled
+ * request to customise them.
+ * @param apiKey The Stripe secret or restricted key.
+ * @param options Rate, burst, reserve and concurrency settings.
+ * @example
+ * const scheduler = getStripeScheduler(process.env.STRIPE_SECRET_KEY!);
+ * logger.info("Stripe queue", scheduler.getMetrics());
+ */
+export const getStripeScheduler = (
+  apiKey: string,
+  options: StripeSchedulerOptions = {},
+): StripeScheduler => {
+  let scheduler = schedulers.get(apiKey);
+  if (!scheduler) {
+    const isLive = /^(sk|rk)_live_/.test(apiKey);
+    scheduler = new StripeScheduler({
+      ratePerSecond: isLive ? STRIPE_LIVE_RATE_LIMIT : STRIPE_TEST_RATE_LIMIT,
+      ...options,
+    });
+    schedulers.set(apiKey, scheduler);
+  }
+  return scheduler;
+};
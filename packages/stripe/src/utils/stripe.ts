@@ -1,4 +1,11 @@
+import { Agent } from "https";
 import Stripe from "stripe";
+import { getStripeScheduler, StripeLane, StripeScheduler } from "./scheduler";
+
+/** Retries on network errors and 409/429/5xx (Stripe's default is 1). */
+export const DEFAULT_MAX_NETWORK_RETRIES = 2;
+/** Per-request timeout in milliseconds (Stripe's default is 80 seconds). */
+export const DEFAULT_STRIPE_TIMEOUT_MS = 30_000;
 
 /**
  * Interface for Stripe client initialization options.
@@ -6,20 +13,222 @@ import Stripe from "stripe";
 export interface StripeOptions {
   apiKey: string;
   apiVersion?: Stripe.LatestApiVersion;
+  /** Automatic retries with backoff (default: 2). */
+  maxNetworkRetries?: number;
+  /**
+   * Request timeout in milliseconds (default: 30000). With a `lane`, it
+   * includes the time the request waits in the scheduler's queue.
+   */
+  timeout?: number;
+  /**
+   * Route requests through the API key's shared rate-limit scheduler in this
+   * priority lane (see `getStripeScheduler`). Unscheduled when omitted.
+   */
+  lane?: StripeLane;
+  /**
+   * API origin override, e.g. "http://localhost:12111" for the backend's
+   * local Stripe stand-in. Defaults to https://api.stripe.com.
+   */
+  apiBase?: string;
 }
 
 /**
- * Initializes the Stripe client.
- * @param options - The Stripe API key and optional API version.
- * @returns The initialized Stripe instance.
+ * Latency and outcome of one Stripe API call, emitted after every response.
+ */
+export interface StripeTelemetryEvent {
+  method: string;
+  path: string;
+  status: number;
+  /** Round-trip time in milliseconds, including retries. */
+  elapsedMs: number;
+  requestId: string;
+  apiVersion: string;
+}
+
+export type StripeTelemetryListener = (event: StripeTelemetryEvent) => void;
+
+// One keep-alive agent for every pooled client, so TLS connections to
+// api.stripe.com are reused across calls and across clients.
+const sharedAgent = new Agent({ keepAlive: true, maxSockets: 50 });
+
+const clients = new Map<string, Stripe>();
+
+// Wraps Stripe's Node HTTP client so each request waits for a scheduler
+// token; 429 responses feed the scheduler's backoff before the SDK retries.
+// The time spent queued counts toward the request's timeout: a request still
+// queued when it expires is rejected unsent, and a dequeued one only gets the
+// remainder. Like the timeout itself, this applies to each attempt.
+const createScheduledHttpClient = (
+  scheduler: StripeScheduler,
+  lane: StripeLane,
+  agent: Agent | null,
+): Stripe.HttpClient => {
+  const inner = Stripe.createNodeHttpClient(agent);
+  return {
+    getClientName: () => inner.getClientName(),
+    makeRequest: (
+      host,
+      port,
+      path,
+      method,
+      headers,
+      requestData,
+      protocol,
+      timeout,
+    ) =>
+      scheduler.schedule(
+        async (waitedMs) => {
+          const response = await inner.makeRequest(
+            host,
+            port,
+            path,
+            method,
+            headers,
+            requestData,
+            protocol,
+            Math.max(1, timeout - waitedMs),
+          );
+          if (response.getStatusCode() === 429) {
+            const retryAfter = Number(response.getHeaders()["retry-after"]);
+            scheduler.onRateLimited(
+              Number.isFinite(retryAfter) ? retryAfter : undefined,
+            );
+          } else {
+            scheduler.onSuccess();
+          }
+          return response;
+        },
+        lane,
+        timeout,
+      ),
+  };
+};
+
+const telemetryListeners = new Set<StripeTelemetryListener>();
+
+const emitTelemetry = (event: Stripe.ResponseEvent) => {
+  if (telemetryListeners.size === 0) return;
+  const payload: StripeTelemetryEvent = {
+    method: event.method,
+    path: event.path,
+    status: event.status,
+    elapsedMs: event.elapsed,
+    requestId: event.request_id,
+    apiVersion: event.api_version,
+  };
+  telemetryListeners.forEach((listener) => {
+    try {
+      listener(payload);
+    } catch (error) {
+      console.error("Stripe telemetry listener failed:", error);
+    }
+  });
+};
+
+/**
+ * Returns a pooled Stripe client for the given options. Clients are cached by
+ * API key, API version, retries, timeout and lane, and share one keep-alive
+ * HTTP agent, so repeated calls reuse connections instead of opening new ones.
+ * With a `lane`, requests are rate limited by the key's shared scheduler.
+ * @param options - The Stripe API key and optional client settings.
+ * @returns The cached Stripe instance for these options.
  * @throws Error if apiKey is missing.
+ * @example
+ * const stripe = getStripeClient({ apiKey: process.env.STRIPE_SECRET_KEY! });
+ * const batch = getStripeClient({ apiKey: process.env.STRIPE_SECRET_KEY!, lane: "batch" });
  */
-export const initStripe = (options: StripeOptions): Stripe => {
+export const getStripeClient = (options: StripeOptions): Stripe => {
   if (!options.apiKey) {
     throw new Error("Stripe API key is required.");
   }
-  return new Stripe(options.apiKey, {
-    apiVersion: options.apiVersion, // Pass provided version or undefined (Stripe uses latest by default)
-    typescript: true,
-  });
+  const maxNetworkRetries =
+    options.maxNetworkRetries ?? DEFAULT_MAX_NETWORK_RETRIES;
+  const timeout = options.timeout ?? DEFAULT_STRIPE_TIMEOUT_MS;
+  const key = [
+    options.apiKey,
+    options.apiVersion ?? "default",
+    maxNetworkRetries,
+    timeout,
+    options.lane ?? "unscheduled",
+    options.apiBase ?? "",
+  ].join("|");
+
+  let client = clients.get(key);
+  if (!client) {
+    const apiBase = options.apiBase ? new URL(options.apiBase) : null;
+    const protocol = apiBase?.protocol === "http:" ? "http" : "https";
+    // The keep-alive agent is HTTPS-only; plain HTTP uses Node's global agent.
+    const agent = protocol === "https" ? sharedAgent : null;
+    client = new Stripe(options.apiKey, {
+      apiVersion: options.apiVersion, // Pass provided version or undefined (Stripe uses latest by default)
+      typescript: true,
+      maxNetworkRetries,
+      timeout,
+      ...(apiBase && {
+        host: apiBase.hostname,
+        port: Number(apiBase.port) || undefined,
+        protocol,
+      }),
+      ...(options.lane
+        ? {
+            httpClient: createScheduledHttpClient(
+              getStripeScheduler(options.apiKey),
+              options.lane,
+              agent,
+            ),
+          }
+        : { httpAgent: agent ?? undefined }),
+    });
+    client.on("response", emitTelemetry);
+    clients.set(key, client);
+  }
+  return client;
+};
+
+/**
+ * Initializes the Stripe client. Returns the pooled client for these options,
+ * see `getStripeClient`.
+ * @param options - The Stripe API key and optional API version.
+ * @returns The initialized Stripe instance.
+ * @throws Error if apiKey is missing.
+ */
+export const initStripe = (options: StripeOptions): Stripe =>
+  getStripeClient(options);
+
+/**
+ * Resolves the `stripe` argument accepted by every helper: a client instance
+ * is used as is, options are resolved to the pooled client.
+ * @param stripe - Initialized Stripe client instance or StripeOptions.
+ * @returns A Stripe instance.
+ */
+export const resolveStripe = (stripe: Stripe | StripeOptions): Stripe =>
+  stripe instanceof Stripe ? stripe : getStripeClient(stripe);
+
+/**
+ * Subscribes to per-call telemetry from every pooled client (e.g. to record
+ * latency metrics). Instances created with `new Stripe()` are not covered.
+ * @param listener - Called after each Stripe API response.
+ * @returns A function that removes the listener.
+ * @example
+ * const stop = addStripeTelemetryListener(({ method, path, elapsedMs }) =>
+ *   metrics.histogram("stripe.latency", elapsedMs, { method, path }),
+ * );
+ */
+export const addStripeTelemetryListener = (
+  listener: StripeTelemetryListener,
+): (() => void) => {
+  telemetryListeners.add(listener);
+  return () => {
+    telemetryListeners.delete(listener);
+  };
+};
+
+/**
+ * Drops every pooled client, e.g. after rotating API keys. Existing
+ * references keep working (without telemetry); later calls create fresh
+ * clients.
+ */
+export const clearStripeClientCache = (): void => {
+  clients.forEach((client) => client.off("response", emitTelemetry));
+  clients.clear();
 };
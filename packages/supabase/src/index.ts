@@ -2,4 +2,9 @@ import { createClient, SupabaseClient } from "@supabase/supabase-js";
 
 export * from "./types";
 export * from "./modules/";
+export * from "./utils/pagination";
+export * from "./utils/batch-loader";
+export * from "./utils/bulk";
+export * from "./utils/query-cache";
+export * from "./utils/optimistic";
 export { createClient, SupabaseClient };
@@ -0,0 +1,119 @@
+import {
+  SupabaseClient,
+  PostgrestSingleResponse,
+} from "@supabase/supabase-js";
+import { Database, Json, Tables } from "../types/database.types";
+
+// Define table-specific types
+export type Entitlement = Tables<"entitlements">;
+export type EntitlementSync = Omit<Entitlement, "updated_at">;
+
+/** Subscription statuses that grant access (`past_due` keeps it during dunning). */
+export const ACTIVE_SUBSCRIPTION_STATUSES: ReadonlySet<string> = new Set([
+  "active",
+  "trialing",
+  "past_due",
+]);
+
+/**
+ * Everything a user is entitled to, through their own subscriptions and
+ * those of their organizations.
+ */
+export interface EntitlementSet {
+  profileId: string;
+  /** Plans of the active subscriptions, deduplicated. */
+  plans: string[];
+  /** Features granted by the active subscriptions, deduplicated. */
+  features: string[];
+  /** Organizations whose subscriptions contributed to this set. */
+  organizationIds: string[];
+  /** Active subscriptions backing the set. */
+  subscriptions: Entitlement[];
+}
+
+/**
+ * Fetches a profile's own entitlements plus those of every organization it
+ * belongs to, in one call. With a user-scoped client RLS limits the result to
+ * the signed-in user; a service-role client can read any profile.
+ * @param supabase The Supabase client instance.
+ * @param profileId The profile whose entitlements to fetch.
+ * @returns A promise that resolves to the entitlement rows (any status).
+ * @example
+ * const { data, error } = await fetchEntitlements({ supabase, profileId: user.id });
+ */
+export const fetchEntitlements = async ({
+  supabase,
+  profileId,
+}: {
+  supabase: SupabaseClient<Database>;
+  profileId: string;
+}): Promise<PostgrestSingleResponse<Entitlement[]>> => {
+  return supabase.rpc("entitlements_for", { profile: profileId });
+};
+
+/**
+ * Writes an entitlement projected from a subscription event, unless a later
+ * event is already stored. Requires a service-role client.
+ * @param supabase A Supabase client authenticated with the service role key.
+ * @param entitlement The entitlement to write.
+ * @returns A promise that resolves to the stored row.
+ */
+export const upsertEntitlement = async ({
+  supabase,
+  entitlement,
+}: {
+  supabase: SupabaseClient<Database>;
+  entitlement: EntitlementSync;
+}): Promise<PostgrestSingleResponse<Entitlement>> => {
+  return supabase.rpc("upsert_entitlement", {
+    entitlement: entitlement as unknown as Json,
+  });
+};
+
+/**
+ * Reduces entitlement rows to the set of plans and features currently granted.
+ * @param profileId The profile the rows belong to.
+ * @param rows The rows returned by `fetchEntitlements`.
+ * @param now Reference time for period checks (default: now).
+ * @returns The user's entitlement set.
+ */
+export const toEntitlementSet = (
+  profileId: string,
+  rows: readonly Entitlement[],
+  now: Date = new Date(),
+): EntitlementSet => {
+  const subscriptions = rows.filter(
+    (row) =>
+      ACTIVE_SUBSCRIPTION_STATUSES.has(row.status) &&
+      (!row.current_period_end || new Date(row.current_period_end) > now),
+  );
+  return {
+    profileId,
+    plans: Array.from(new Set(subscriptions.flatMap((row) => row.plans))),
+    features: Array.from(
+      new Set(subscriptions.flatMap((row) => row.features)),
+    ),
+    organizationIds: Array.from(
+      new Set(
+        subscriptions.flatMap((row) =>
+          row.organization_id ? [row.organization_id] : [],
+        ),
+      ),
+    ),
+    subscriptions,
+  };
+};
+
+/**
+ * Returns true when the entitlement set grants the feature.
+ * @param entitlements The user's entitlement set.
+ * @param feature The feature flag to check.
+ * @example
+ * if (!hasFeature(entitlements, "exports")) {
+ *   return c.json({ error: "Upgrade required" }, 402);
+ * }
+ */
+export const hasFeature = (
+  entitlements: EntitlementSet,
+  feature: string,
+): boolean => entitlements.features.includes(feature);
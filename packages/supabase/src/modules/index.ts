@@ -1,7 +1,13 @@
 // packages/supabase/src/modules/index.ts
+export * from "./entitlements";
+export * from "./invitations";
 export * from "./organizations";
 export * from "./organizations.react";
 export * from "./profiles";
 export * from "./profiles.react";
 export * from "./projects";
 export * from "./projects.react";
+export * from "./realtime.react";
+export * from "./stripe-catalog";
+export * from "./stripe-customers";
+export * from "./user-access";
@@ -0,0 +1,148 @@
+import {
+  SupabaseClient,
+  PostgrestSingleResponse,
+} from "@supabase/supabase-js";
+import {
+  Database,
+  Enums,
+  Json,
+  Tables,
+  TablesInsert,
+} from "../types/database.types";
+import { BulkOptions, BulkResponse, runBulk } from "../utils/bulk";
+
+// Define table-specific types
+export type Invitation = Tables<"invitations">;
+export type InvitationStatus = Enums<"invitation_status">;
+export type InvitationTargetType = Enums<"invitation_target_type">;
+
+/**
+ * One entry of a bulk invite. The inviter is always the authenticated user.
+ */
+export type InvitationRequest = Pick<
+  TablesInsert<"invitations">,
+  "invitee_email" | "target_type" | "target_id" | "role" | "expires_at"
+>;
+
+/**
+ * Result of the set-based accept/decline RPCs. On failure nothing is applied
+ * and `status` is "error" with a `message`.
+ */
+export type AcceptAllInvitationsResult =
+  | {
+      status: "success";
+      accepted: number;
+      organizations_joined: number;
+      projects_joined: number;
+      expired: number;
+    }
+  | { status: "error"; message: string };
+
+export type DeclineAllInvitationsResult =
+  | { status: "success"; declined: number }
+  | { status: "error"; message: string };
+
+/**
+ * Fetches the pending invitations addressed to the authenticated user.
+ * @param supabase The Supabase client instance.
+ * @returns A promise that resolves to the pending invitations.
+ * @example
+ * const { data, error } = await fetchPendingInvitations({ supabase });
+ */
+export const fetchPendingInvitations = async ({
+  supabase,
+}: {
+  supabase: SupabaseClient<Database>;
+}): Promise<PostgrestSingleResponse<Invitation[]>> => {
+  return supabase.rpc("get_pending_invitations");
+};
+
+/**
+ * Accepts every pending, unexpired invitation addressed to the authenticated
+ * user in one transaction. Overdue invitations are expired first.
+ * @param supabase The Supabase client instance.
+ * @returns A promise that resolves to the accept summary.
+ * @example
+ * const { data } = await acceptAllInvitations({ supabase });
+ * if (data?.status === "success") console.log(data.accepted);
+ */
+export const acceptAllInvitations = async ({
+  supabase,
+}: {
+  supabase: SupabaseClient<Database>;
+}): Promise<PostgrestSingleResponse<AcceptAllInvitationsResult>> => {
+  return supabase.rpc("accept_all_invitations") as unknown as Promise<
+    PostgrestSingleResponse<AcceptAllInvitationsResult>
+  >;
+};
+
+/**
+ * Declines every pending invitation addressed to the authenticated user.
+ * @param supabase The Supabase client instance.
+ * @returns A promise that resolves to the decline summary.
+ * @example
+ * const { data } = await declineAllInvitations({ supabase });
+ */
+export const declineAllInvitations = async ({
+  supabase,
+}: {
+  supabase: SupabaseClient<Database>;
+}): Promise<PostgrestSingleResponse<DeclineAllInvitationsResult>> => {
+  return supabase.rpc("decline_all_invitations") as unknown as Promise<
+    PostgrestSingleResponse<DeclineAllInvitationsResult>
+  >;
+};
+
+/**
+ * Creates many invitations with one `create_invitations` call per chunk.
+ * Emails are normalised to lower case; emails that already have a pending
+ * invitation for the same target are skipped and absent from `data`.
+ * @param supabase The Supabase client instance.
+ * @param invitations The invitations to create.
+ * @param options Chunk size (default: 500) and concurrency (default: 4).
+ * @returns The created invitations and any failed chunks.
+ * @example
+ * const { data, error, failed } = await createInvitations({
+ *   supabase,
+ *   invitations: emails.map((invitee_email) => ({
+ *     invitee_email,
+ *     target_type: "organization",
+ *     target_id: orgId,
+ *     role: "member",
+ *   })),
+ * });
+ */
+export const createInvitations = async ({
+  supabase,
+  invitations,
+  options,
+}: {
+  supabase: SupabaseClient<Database>;
+  invitations: readonly InvitationRequest[];
+  options?: BulkOptions;
+}): Promise<BulkResponse<Invitation, InvitationRequest>> => {
+  return runBulk(
+    invitations,
+    (part) =>
+      supabase.rpc("create_invitations", {
+        invitations: part as unknown as Json,
+      }),
+    options,
+  );
+};
+
+/**
+ * Marks every overdue pending invitation as expired. Requires a service-role
+ * client; the backend runs this on a schedule.
+ * @param supabase A Supabase client authenticated with the service role key.
+ * @returns A promise that resolves to the number of invitations expired.
+ * @example
+ * const { data: expired } = await expireInvitations({ supabase: supabaseAdmin });
+ */
+export const expireInvitations = async ({
+  supabase,
+}: {
+  supabase: SupabaseClient<Database>;
+}): Promise<PostgrestSingleResponse<number>> => {
+  return supabase.rpc("expire_invitations");
+};
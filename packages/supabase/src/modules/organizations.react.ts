@@ -1,23 +1,88 @@
+import { useCallback } from "react";
 import {
+  infiniteQueryOptions,
+  keepPreviousData,
+  queryOptions,
+  useInfiniteQuery,
   useQuery,
   useMutation,
   useQueryClient,
+  InfiniteData,
+  QueryClient,
+  UseInfiniteQueryResult,
   UseQueryResult,
   UseMutationResult,
 } from "@tanstack/react-query";
 import { SupabaseClient } from "@supabase/supabase-js";
 import { Database } from "../types/database.types";
+import { BatchLoader } from "../utils/batch-loader";
+import {
+  applyOptimisticUpdate,
+  reconcileServerRow,
+  rollbackOptimisticUpdate,
+  updateMutationKey,
+  OptimisticSnapshot,
+} from "../utils/optimistic";
+import {
+  findRowInLists,
+  insertRowIntoCaches,
+  removeRowFromCaches,
+} from "../utils/query-cache";
 import {
   Organization,
   OrganizationInsert,
   OrganizationUpdate,
-  fetchOrganizationById,
+  fetchOrganizationsByIds,
+  createOrganizationLoader,
   createOrganization,
   updateOrganization,
   deleteOrganization,
   listOrganizations,
+  listOrganizationsByCursor,
 } from "./organizations"; // Adjusted path
 
+// One uncached loader per client: concurrent `useOrganization` queries issued in
+// the same tick share a single request, while React Query remains the cache.
+const organizationLoaders = new WeakMap<
+  SupabaseClient<Database>,
+  BatchLoader<Organization>
+>();
+
+const getOrganizationLoader = (
+  supabase: SupabaseClient<Database>,
+): BatchLoader<Organization> => {
+  let loader = organizationLoaders.get(supabase);
+  if (!loader) {
+    loader = createOrganizationLoader({ supabase, cache: false });
+    organizationLoaders.set(supabase, loader);
+  }
+  return loader;
+};
+
+/**
+ * Query options for a single organization, shared by `useOrganization` and `prefetchOrganization`.
+ * @param id The ID of the organization to fetch.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns Options for `useQuery`, `prefetchQuery` or `fetchQuery`.
+ */
+export const organizationQueryOptions = (
+  id: string,
+  options: { supabase: SupabaseClient<Database> },
+) => {
+  const { supabase } = options;
+
+  return queryOptions<Organization, Error>({
+    queryKey: ["organizations", id],
+    queryFn: async () => {
+      if (!supabase) throw new Error("Supabase client is required.");
+      const data = await getOrganizationLoader(supabase).load(id);
+      if (!data) throw new Error("Organization not found");
+      return data;
+    },
+  });
+};
+
 /**
  * Fetches a specific organization record by its ID using React Query.
  * @param id The ID of the organization to fetch.
@@ -33,17 +98,84 @@ export const useOrganization = (
   options: { supabase: SupabaseClient<Database> },
 ): UseQueryResult<Organization, Error> => {
   const { supabase } = options;
+  const queryClient = useQueryClient();
 
   return useQuery<Organization, Error>({
-    queryKey: ["organizations", id],
+    ...organizationQueryOptions(id, { supabase }),
+    // Render instantly from a cached list holding the row while it loads.
+    placeholderData: () =>
+      findRowInLists<Organization>(queryClient, "organizations", id),
+    enabled: !!id && !!supabase,
+  });
+};
+
+/**
+ * Fetches several organization records in one request and seeds the individual
+ * `["organizations", id]` cache entries from the result, so later `useOrganization(id)` calls
+ * render from cache instead of issuing one request each.
+ * @param ids The IDs of the organizations to fetch.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A UseQueryResult object for the organizations, in the order of `ids` (missing ids are skipped).
+ * @example
+ * const supabase = // ... get your Supabase client instance ...
+ * const { data: organizations } = useOrganizationsByIds(['org-uuid-1', 'org-uuid-2'], { supabase });
+ */
+export const useOrganizationsByIds = (
+  ids: readonly string[],
+  options: { supabase: SupabaseClient<Database> },
+): UseQueryResult<Organization[], Error> => {
+  const { supabase } = options;
+  const queryClient = useQueryClient();
+  const uniqueIds = Array.from(new Set(ids)).sort();
+
+  return useQuery<Organization[], Error>({
+    queryKey: ["organizations", { ids: uniqueIds }],
     queryFn: async () => {
       if (!supabase) throw new Error("Supabase client is required.");
-      const { data, error } = await fetchOrganizationById({ supabase, id });
+      const { data, error } = await fetchOrganizationsByIds({
+        supabase,
+        ids: uniqueIds,
+      });
       if (error) throw error;
-      if (!data) throw new Error("Organization not found");
-      return data;
+      const byId = new Map((data ?? []).map((row) => [row.id, row]));
+      byId.forEach((row, id) =>
+        queryClient.setQueryData(["organizations", id], row),
+      );
+      return ids
+        .map((id) => byId.get(id))
+        .filter((row): row is Organization => !!row);
+    },
+    enabled: uniqueIds.length > 0 && !!supabase,
+  });
+};
+
+/**
+ * Query options for a page of organizations, shared by `useOrganizations` and `prefetchOrganizations`.
+ * @param filters Filters for pagination (page, limit).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns Options for `useQuery`, `prefetchQuery` or `fetchQuery`.
+ */
+export const organizationsQueryOptions = (
+  filters: { page?: number; limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+) => {
+  const { supabase } = options;
+  const { page = 1, limit = 10 } = filters;
+
+  return queryOptions<Organization[], Error>({
+    queryKey: ["organizations", { page, limit }],
+    queryFn: async () => {
+      if (!supabase) throw new Error("Supabase client is required.");
+      const { data, error } = await listOrganizations({
+        supabase,
+        page,
+        limit,
+      });
+      if (error) throw error;
+      return data || []; // Return empty array if data is null
     },
-    enabled: !!id && !!supabase,
   });
 };
 
@@ -62,24 +194,166 @@ export const useOrganizations = (
   options: { supabase: SupabaseClient<Database> },
 ): UseQueryResult<Organization[], Error> => {
   const { supabase } = options;
-  const { page = 1, limit = 10 } = filters;
 
   return useQuery<Organization[], Error>({
-    queryKey: ["organizations", { page, limit }],
-    queryFn: async () => {
+    ...organizationsQueryOptions(filters, { supabase }),
+    // Keep showing the previous page while the next one loads.
+    placeholderData: keepPreviousData,
+    enabled: !!supabase,
+  });
+};
+
+/**
+ * A page of organizations as stored by `useInfiniteOrganizations`.
+ */
+export type OrganizationsPage = {
+  data: Organization[];
+  nextCursor: string | null;
+};
+
+/**
+ * Infinite query options for organizations, backed by `listOrganizationsByCursor`.
+ * Shared by `useInfiniteOrganizations` and `prefetchInfiniteOrganizations`.
+ * @param filters Optional `owner_id` filter and page size (limit, default: 10).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns Options for `useInfiniteQuery` or `prefetchInfiniteQuery`.
+ */
+export const infiniteOrganizationsQueryOptions = (
+  filters: { owner_id?: string; limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+) => {
+  const { supabase } = options;
+  const { limit = 10, ...otherFilters } = filters;
+
+  return infiniteQueryOptions({
+    queryKey: ["organizations", { infinite: true, limit, ...otherFilters }],
+    queryFn: async ({ pageParam }): Promise<OrganizationsPage> => {
       if (!supabase) throw new Error("Supabase client is required.");
-      const { data, error } = await listOrganizations({
+      const { data, error, nextCursor } = await listOrganizationsByCursor({
         supabase,
-        page,
+        ...otherFilters,
         limit,
+        cursor: pageParam,
       });
       if (error) throw error;
-      return data || []; // Return empty array if data is null
+      return { data: data ?? [], nextCursor };
     },
+    initialPageParam: null as string | null,
+    getNextPageParam: (lastPage) => lastPage.nextCursor,
+  });
+};
+
+/**
+ * Fetches organizations as an infinite list using cursor pagination, for infinite
+ * scrolling. Each page costs the same regardless of how deep the user scrolls.
+ * @param filters Optional `owner_id` filter and page size (limit, default: 10).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A UseInfiniteQueryResult; rows are in `data.pages[n].data`.
+ * @example
+ * const supabase = // ... get your Supabase client instance ...
+ * const { data, fetchNextPage, hasNextPage } = useInfiniteOrganizations({ owner_id: 'profile-uuid' }, { supabase });
+ * const organizations = data?.pages.flatMap((page) => page.data) ?? [];
+ */
+export const useInfiniteOrganizations = (
+  filters: { owner_id?: string; limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+): UseInfiniteQueryResult<
+  InfiniteData<OrganizationsPage, string | null>,
+  Error
+> => {
+  const { supabase } = options;
+
+  return useInfiniteQuery({
+    ...infiniteOrganizationsQueryOptions(filters, { supabase }),
     enabled: !!supabase,
   });
 };
 
+/**
+ * Prefetches a organization into a QueryClient, e.g. in a server component before
+ * dehydrating the client into a `HydrationBoundary`.
+ * @param queryClient The QueryClient to fill.
+ * @param id The ID of the organization to prefetch.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A promise that resolves once the query has settled.
+ * @example
+ * const queryClient = getQueryClient();
+ * await prefetchOrganization(queryClient, 'org-uuid', { supabase });
+ * return <HydrationBoundary state={dehydrate(queryClient)}>...</HydrationBoundary>;
+ */
+export const prefetchOrganization = (
+  queryClient: QueryClient,
+  id: string,
+  options: { supabase: SupabaseClient<Database> },
+): Promise<void> =>
+  queryClient.prefetchQuery(organizationQueryOptions(id, options));
+
+/**
+ * Prefetches a page of organizations (see `useOrganizations`) into a QueryClient.
+ * @param queryClient The QueryClient to fill.
+ * @param filters Filters for pagination (page, limit).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A promise that resolves once the query has settled.
+ */
+export const prefetchOrganizations = (
+  queryClient: QueryClient,
+  filters: { page?: number; limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+): Promise<void> =>
+  queryClient.prefetchQuery(organizationsQueryOptions(filters, options));
+
+/**
+ * Prefetches the first page of an infinite organization list (see `useInfiniteOrganizations`).
+ * @param queryClient The QueryClient to fill.
+ * @param filters Optional `owner_id` filter and page size (limit, default: 10).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A promise that resolves once the query has settled.
+ */
+export const prefetchInfiniteOrganizations = (
+  queryClient: QueryClient,
+  filters: { owner_id?: string; limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+): Promise<void> =>
+  queryClient.prefetchInfiniteQuery(
+    infiniteOrganizationsQueryOptions(filters, options),
+  );
+
+/**
+ * Returns a callback that warms the `["organizations", id]` cache, for `onMouseEnter` /
+ * `onFocus` handlers or when a row scrolls into view. Fresh entries are not
+ * refetched, and concurrent calls are batched into one request.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @param options.staleTime How long a prefetched organization counts as fresh in ms (default: 30000).
+ * @returns A function taking the ID of the organization to prefetch.
+ * @example
+ * const prefetch = usePrefetchOrganization({ supabase });
+ * <Link href={`/organizations/${id}`} onMouseEnter={() => prefetch(id)}>...</Link>
+ */
+export const usePrefetchOrganization = (options: {
+  supabase: SupabaseClient<Database>;
+  staleTime?: number;
+}): ((id: string) => void) => {
+  const { supabase, staleTime = 30_000 } = options;
+  const queryClient = useQueryClient();
+
+  return useCallback(
+    (id: string) => {
+      if (!id || !supabase) return;
+      void queryClient.prefetchQuery({
+        ...organizationQueryOptions(id, { supabase }),
+        staleTime,
+      });
+    },
+    [queryClient, supabase, staleTime],
+  );
+};
+
 /**
  * Creates a new organization record.
  * @returns A UseMutationResult object. Call mutate with { supabase, insertData }.
@@ -112,14 +386,15 @@ export const useCreateOrganization = (): UseMutationResult<
       return data;
     },
     onSuccess: (data) => {
-      queryClient.invalidateQueries({ queryKey: ["organizations"] });
-      queryClient.setQueryData(["organizations", data.id], data);
+      // Seed the new row and refetch only the lists whose filters it matches.
+      insertRowIntoCaches(queryClient, "organizations", data);
     },
   });
 };
 
 /**
  * Updates an existing organization record.
+ * The change is applied to cached data immediately and rolled back if the request fails.
  * @returns A UseMutationResult object. Call mutate with { supabase, id, updateData }.
  * @example
  * const supabase = // ... get your Supabase client instance ...
@@ -144,8 +419,10 @@ export const useUpdateOrganization = (): UseMutationResult<
       supabase: SupabaseClient<Database>;
       id: string;
       updateData: OrganizationUpdate;
-    }
+    },
+    OptimisticSnapshot
   >({
+    mutationKey: updateMutationKey("organizations"),
     mutationFn: async ({ supabase, id, updateData }) => {
       if (!supabase) throw new Error("Supabase client is required.");
       const { data, error } = await updateOrganization({
@@ -158,12 +435,13 @@ export const useUpdateOrganization = (): UseMutationResult<
         throw new Error("Failed to update Organization, no data returned.");
       return data;
     },
-    onSuccess: (data, variables) => {
-      queryClient.invalidateQueries({ queryKey: ["organizations"] });
-      queryClient.invalidateQueries({
-        queryKey: ["organizations", variables.id],
-      });
-      queryClient.setQueryData(["organizations", variables.id], data);
+    // Show the edit immediately in the detail cache and every list holding it.
+    onMutate: ({ id, updateData }) =>
+      applyOptimisticUpdate(queryClient, "organizations", id, updateData),
+    onError: (_error, _variables, snapshot) =>
+      rollbackOptimisticUpdate(queryClient, "organizations", snapshot),
+    onSettled: (data) => {
+      if (data) reconcileServerRow(queryClient, "organizations", data);
     },
   });
 };
@@ -195,8 +473,8 @@ export const useDeleteOrganization = (): UseMutationResult<
       return null;
     },
     onSuccess: (data, variables) => {
-      queryClient.invalidateQueries({ queryKey: ["organizations"] });
-      queryClient.removeQueries({ queryKey: ["organizations", variables.id] });
+      // Drop the row from its detail cache and any list holding it.
+      removeRowFromCaches(queryClient, "organizations", variables.id);
     },
   });
 };
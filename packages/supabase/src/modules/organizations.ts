@@ -1,15 +1,38 @@
-import { SupabaseClient, PostgrestSingleResponse } from "@supabase/supabase-js";
+import {
+  SupabaseClient,
+  PostgrestSingleResponse,
+  PostgrestError,
+} from "@supabase/supabase-js";
 import {
   Database,
   Tables,
   TablesInsert,
   TablesUpdate,
 } from "../types/database.types";
+import {
+  CursorColumns,
+  CursorPageOptions,
+  CursorPageResponse,
+  buildKeysetFilter,
+  buildProjection,
+  clampLimit,
+  decodeCursor,
+  toCursorPage,
+} from "../utils/pagination";
+import { BatchLoader, createBatchLoader } from "../utils/batch-loader";
+import {
+  BulkOptions,
+  BulkResponse,
+  DEFAULT_BULK_IDS_PER_REQUEST,
+  mergePatchesById,
+  runBulk,
+} from "../utils/bulk";
 
 // Define table-specific types
 export type Organization = Tables<"organizations">;
 export type OrganizationInsert = TablesInsert<"organizations">;
 export type OrganizationUpdate = TablesUpdate<"organizations">;
+export type OrganizationPatch = OrganizationUpdate & { id: string };
 
 /**
  * Fetches an organizations record by its primary key (id).
@@ -29,6 +52,55 @@ export const fetchOrganizationById = async ({
   return supabase.from("organizations").select("*").eq("id", id).single();
 };
 
+/**
+ * Fetches several organizations records by primary key in a single request.
+ * Ids that do not exist (or are hidden by RLS) are simply absent from the result.
+ * @param supabase The Supabase client instance.
+ * @param ids The primary keys of the organizations to fetch.
+ * @returns A promise that resolves to the fetched organizations records.
+ * @example
+ * const { data, error } = await fetchOrganizationsByIds({ supabase, ids: ["uuid-1", "uuid-2"] });
+ */
+export const fetchOrganizationsByIds = async ({
+  supabase,
+  ids,
+}: {
+  supabase: SupabaseClient<Database>;
+  ids: readonly string[];
+}): Promise<PostgrestSingleResponse<Organization[]>> => {
+  return supabase
+    .from("organizations")
+    .select("*")
+    .in("id", Array.from(new Set(ids)));
+};
+
+/**
+ * Creates a batching loader for organizations records. Concurrent `load` calls made in
+ * the same tick are coalesced into one `fetchOrganizationsByIds` request.
+ * Create one loader per request scope; results are cached for its lifetime.
+ * @param supabase The Supabase client instance.
+ * @param cache Whether to cache results for the lifetime of the loader (default: true).
+ * @returns A BatchLoader for organizations records.
+ * @example
+ * const loader = createOrganizationLoader({ supabase });
+ * const organizations = await loader.loadMany(ids); // one PostgREST request
+ */
+export const createOrganizationLoader = ({
+  supabase,
+  cache = true,
+}: {
+  supabase: SupabaseClient<Database>;
+  cache?: boolean;
+}): BatchLoader<Organization> =>
+  createBatchLoader<Organization>({
+    cache,
+    batchFn: async (ids) => {
+      const { data, error } = await fetchOrganizationsByIds({ supabase, ids });
+      if (error) throw error;
+      return new Map((data ?? []).map((row) => [row.id, row]));
+    },
+  });
+
 /**
  * Creates a new organizations record.
  * @param supabase The Supabase client instance.
@@ -91,6 +163,120 @@ export const deleteOrganization = async ({
   return supabase.from("organizations").delete().eq("id", id);
 };
 
+/**
+ * Creates many organizations records with multi-row inserts. Rows are sent in chunks
+ * (default: 500 per request) with bounded concurrency (default: 4).
+ * @param supabase The Supabase client instance.
+ * @param rows The rows to insert.
+ * @param chunkSize Maximum rows per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the created records and the rows of any failed chunks.
+ * @example
+ * const { data, error, failed } = await createOrganizations({ supabase, rows: [{ name: 'Acme' }] });
+ */
+export const createOrganizations = async ({
+  supabase,
+  rows,
+  ...options
+}: {
+  supabase: SupabaseClient<Database>;
+  rows: readonly OrganizationInsert[];
+} & BulkOptions): Promise<BulkResponse<Organization, OrganizationInsert>> =>
+  runBulk(
+    rows,
+    (part) => supabase.from("organizations").insert(part).select(),
+    options,
+  );
+
+/**
+ * Inserts or updates many organizations records (`INSERT ... ON CONFLICT DO UPDATE`).
+ * Rows are sent in chunks (default: 500 per request) with bounded concurrency.
+ * @param supabase The Supabase client instance.
+ * @param rows The rows to upsert.
+ * @param onConflict Comma separated columns of the unique constraint to match on (default: "id").
+ * @param ignoreDuplicates Skip conflicting rows instead of updating them (default: false).
+ * @param chunkSize Maximum rows per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the written records and the rows of any failed chunks.
+ * @example
+ * const { data, error } = await upsertOrganizations({ supabase, rows: [{ name: 'Acme' }] });
+ */
+export const upsertOrganizations = async ({
+  supabase,
+  rows,
+  onConflict = "id",
+  ignoreDuplicates = false,
+  ...options
+}: {
+  supabase: SupabaseClient<Database>;
+  rows: readonly OrganizationInsert[];
+  onConflict?: string;
+  ignoreDuplicates?: boolean;
+} & BulkOptions): Promise<BulkResponse<Organization, OrganizationInsert>> =>
+  runBulk(
+    rows,
+    (part) =>
+      supabase
+        .from("organizations")
+        .upsert(part, { onConflict, ignoreDuplicates })
+        .select(),
+    options,
+  );
+
+/**
+ * Updates many organizations records through the `bulk_update_organizations` RPC, which applies
+ * each chunk of patches in a single UPDATE statement. Only keys present in a
+ * patch are changed; patches for the same id are merged first. A key that is not
+ * a patchable column makes the RPC raise, failing the whole chunk.
+ * @param supabase The Supabase client instance.
+ * @param patches The patches to apply, each with the id of the record to update.
+ * @param chunkSize Maximum patches per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the updated records and the patches of any failed chunks.
+ * @example
+ * const { data, error } = await updateOrganizations({ supabase, patches: [{ id: 'org-uuid', name: 'Renamed' }] });
+ */
+export const updateOrganizations = async ({
+  supabase,
+  patches,
+  ...options
+}: {
+  supabase: SupabaseClient<Database>;
+  patches: readonly OrganizationPatch[];
+} & BulkOptions): Promise<BulkResponse<Organization, OrganizationPatch>> =>
+  runBulk(
+    mergePatchesById(patches),
+    (part) => supabase.rpc("bulk_update_organizations", { patches: part }),
+    options,
+  );
+
+/**
+ * Deletes many organizations records by primary key using `.in("id", ids)`. Ids are sent
+ * in chunks (default: 150 per request, to stay within URL length limits).
+ * @param supabase The Supabase client instance.
+ * @param ids The primary keys of the organizations to delete.
+ * @param chunkSize Maximum ids per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the ids that were deleted and the ids of any failed chunks.
+ * @example
+ * const { data: deleted, error } = await deleteOrganizations({ supabase, ids: ["uuid-1", "uuid-2"] });
+ */
+export const deleteOrganizations = async ({
+  supabase,
+  ids,
+  chunkSize = DEFAULT_BULK_IDS_PER_REQUEST,
+  concurrency,
+}: {
+  supabase: SupabaseClient<Database>;
+  ids: readonly string[];
+} & BulkOptions): Promise<BulkResponse<{ id: string }, string>> =>
+  runBulk(
+    Array.from(new Set(ids)),
+    (part) =>
+      supabase.from("organizations").delete().in("id", part).select("id"),
+    { chunkSize, concurrency },
+  );
+
 /**
  * Lists organizations records with pagination.
  * @param supabase The Supabase client instance.
@@ -113,3 +299,57 @@ export const listOrganizations = async ({
   const rangeEnd = rangeStart + limit - 1;
   return supabase.from("organizations").select("*").range(rangeStart, rangeEnd);
 };
+
+/**
+ * Lists organizations records using keyset (cursor) pagination on `(created_at, id)`.
+ * Unlike `listOrganizations`, the cost of a page does not grow with its depth.
+ * @param supabase The Supabase client instance.
+ * @param owner_id Optional filter restricting results to a single owner.
+ * @param cursor The `nextCursor` returned by the previous page (omit for the first page).
+ * @param limit The number of records per page (default: 10).
+ * @param columns Optional column projection. `id` and `created_at` are always returned.
+ * @param count Pass "estimated" to include a planner-estimated total count.
+ * @returns A promise that resolves to the page of organizations records and the next cursor.
+ * @throws Error if the cursor is malformed.
+ * @example
+ * const { data, nextCursor, error } = await listOrganizationsByCursor({ supabase, limit: 20, count: 'estimated' });
+ * const nextPage = await listOrganizationsByCursor({ supabase, cursor: nextCursor });
+ */
+export const listOrganizationsByCursor = async <
+  K extends keyof Organization = keyof Organization,
+>({
+  supabase,
+  owner_id,
+  cursor,
+  limit,
+  columns,
+  count,
+}: {
+  supabase: SupabaseClient<Database>;
+  owner_id?: string;
+} & CursorPageOptions<K>): Promise<
+  CursorPageResponse<Pick<Organization, K | CursorColumns>>
+> => {
+  const pageSize = clampLimit(limit);
+  let query = supabase
+    .from("organizations")
+    .select(buildProjection(columns), { count });
+  if (owner_id) {
+    query = query.eq("owner_id", owner_id);
+  }
+  if (cursor) {
+    query = query.or(buildKeysetFilter(decodeCursor(cursor)));
+  }
+  const result = await query
+    .order("created_at", { ascending: false })
+    .order("id", { ascending: false })
+    .limit(pageSize + 1);
+  return toCursorPage(
+    result as unknown as {
+      data: Pick<Organization, K | CursorColumns>[] | null;
+      error: PostgrestError | null;
+      count: number | null;
+    },
+    pageSize,
+  );
+};
@@ -1,23 +1,88 @@
+import { useCallback } from "react";
 import {
+  infiniteQueryOptions,
+  keepPreviousData,
+  queryOptions,
+  useInfiniteQuery,
   useQuery,
   useMutation,
   useQueryClient,
+  InfiniteData,
+  QueryClient,
+  UseInfiniteQueryResult,
   UseQueryResult,
   UseMutationResult,
 } from "@tanstack/react-query";
 import { SupabaseClient } from "@supabase/supabase-js";
 import { Database } from "../types/database.types";
+import { BatchLoader } from "../utils/batch-loader";
+import {
+  applyOptimisticUpdate,
+  reconcileServerRow,
+  rollbackOptimisticUpdate,
+  updateMutationKey,
+  OptimisticSnapshot,
+} from "../utils/optimistic";
+import {
+  findRowInLists,
+  insertRowIntoCaches,
+  removeRowFromCaches,
+} from "../utils/query-cache";
 import {
   Profile,
   ProfileInsert,
   ProfileUpdate,
-  fetchProfileById,
+  fetchProfilesByIds,
+  createProfileLoader,
   createProfile, // Note: Cautious usage as per module docs
   updateProfile,
   deleteProfile,
   listProfiles,
+  listProfilesByCursor,
 } from "./profiles"; // Adjusted path
 
+// One uncached loader per client: concurrent `useProfile` queries issued in
+// the same tick share a single request, while React Query remains the cache.
+const profileLoaders = new WeakMap<
+  SupabaseClient<Database>,
+  BatchLoader<Profile>
+>();
+
+const getProfileLoader = (
+  supabase: SupabaseClient<Database>,
+): BatchLoader<Profile> => {
+  let loader = profileLoaders.get(supabase);
+  if (!loader) {
+    loader = createProfileLoader({ supabase, cache: false });
+    profileLoaders.set(supabase, loader);
+  }
+  return loader;
+};
+
+/**
+ * Query options for a single profile, shared by `useProfile` and `prefetchProfile`.
+ * @param id The ID of the profile to fetch.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns Options for `useQuery`, `prefetchQuery` or `fetchQuery`.
+ */
+export const profileQueryOptions = (
+  id: string,
+  options: { supabase: SupabaseClient<Database> },
+) => {
+  const { supabase } = options;
+
+  return queryOptions<Profile, Error>({
+    queryKey: ["profiles", id],
+    queryFn: async () => {
+      if (!supabase) throw new Error("Supabase client is required.");
+      const data = await getProfileLoader(supabase).load(id);
+      if (!data) throw new Error("Profile not found");
+      return data;
+    },
+  });
+};
+
 /**
  * Fetches a specific profile record by its ID using React Query.
  * @param id The ID of the profile to fetch.
@@ -33,17 +98,80 @@ export const useProfile = (
   options: { supabase: SupabaseClient<Database> },
 ): UseQueryResult<Profile, Error> => {
   const { supabase } = options;
+  const queryClient = useQueryClient();
 
   return useQuery<Profile, Error>({
-    queryKey: ["profiles", id],
+    ...profileQueryOptions(id, { supabase }),
+    // Render instantly from a cached list holding the row while it loads.
+    placeholderData: () =>
+      findRowInLists<Profile>(queryClient, "profiles", id),
+    enabled: !!id && !!supabase,
+  });
+};
+
+/**
+ * Fetches several profile records in one request and seeds the individual
+ * `["profiles", id]` cache entries from the result, so later `useProfile(id)` calls
+ * render from cache instead of issuing one request each.
+ * @param ids The IDs of the profiles to fetch.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A UseQueryResult object for the profiles, in the order of `ids` (missing ids are skipped).
+ * @example
+ * const supabase = // ... get your Supabase client instance ...
+ * const { data: profiles } = useProfilesByIds(['user-uuid-1', 'user-uuid-2'], { supabase });
+ */
+export const useProfilesByIds = (
+  ids: readonly string[],
+  options: { supabase: SupabaseClient<Database> },
+): UseQueryResult<Profile[], Error> => {
+  const { supabase } = options;
+  const queryClient = useQueryClient();
+  const uniqueIds = Array.from(new Set(ids)).sort();
+
+  return useQuery<Profile[], Error>({
+    queryKey: ["profiles", { ids: uniqueIds }],
     queryFn: async () => {
       if (!supabase) throw new Error("Supabase client is required.");
-      const { data, error } = await fetchProfileById({ supabase, id });
+      const { data, error } = await fetchProfilesByIds({
+        supabase,
+        ids: uniqueIds,
+      });
       if (error) throw error;
-      if (!data) throw new Error("Profile not found");
-      return data;
+      const byId = new Map((data ?? []).map((row) => [row.id, row]));
+      byId.forEach((row, id) =>
+        queryClient.setQueryData(["profiles", id], row),
+      );
+      return ids
+        .map((id) => byId.get(id))
+        .filter((row): row is Profile => !!row);
+    },
+    enabled: uniqueIds.length > 0 && !!supabase,
+  });
+};
+
+/**
+ * Query options for a page of profiles, shared by `useProfiles` and `prefetchProfiles`.
+ * @param filters Filters for pagination (page, limit).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns Options for `useQuery`, `prefetchQuery` or `fetchQuery`.
+ */
+export const profilesQueryOptions = (
+  filters: { page?: number; limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+) => {
+  const { supabase } = options;
+  const { page = 1, limit = 10 } = filters;
+
+  return queryOptions<Profile[], Error>({
+    queryKey: ["profiles", { page, limit }],
+    queryFn: async () => {
+      if (!supabase) throw new Error("Supabase client is required.");
+      const { data, error } = await listProfiles({ supabase, page, limit });
+      if (error) throw error;
+      return data || []; // Return empty array if data is null
     },
-    enabled: !!id && !!supabase,
   });
 };
 
@@ -62,20 +190,163 @@ export const useProfiles = (
   options: { supabase: SupabaseClient<Database> },
 ): UseQueryResult<Profile[], Error> => {
   const { supabase } = options;
-  const { page = 1, limit = 10 } = filters;
 
   return useQuery<Profile[], Error>({
-    queryKey: ["profiles", { page, limit }],
-    queryFn: async () => {
+    ...profilesQueryOptions(filters, { supabase }),
+    // Keep showing the previous page while the next one loads.
+    placeholderData: keepPreviousData,
+    enabled: !!supabase,
+  });
+};
+
+/**
+ * A page of profiles as stored by `useInfiniteProfiles`.
+ */
+export type ProfilesPage = { data: Profile[]; nextCursor: string | null };
+
+/**
+ * Infinite query options for profiles, backed by `listProfilesByCursor`.
+ * Shared by `useInfiniteProfiles` and `prefetchInfiniteProfiles`.
+ * @param filters Page size (limit, default: 10).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns Options for `useInfiniteQuery` or `prefetchInfiniteQuery`.
+ */
+export const infiniteProfilesQueryOptions = (
+  filters: { limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+) => {
+  const { supabase } = options;
+  const { limit = 10, ...otherFilters } = filters;
+
+  return infiniteQueryOptions({
+    queryKey: ["profiles", { infinite: true, limit, ...otherFilters }],
+    queryFn: async ({ pageParam }): Promise<ProfilesPage> => {
       if (!supabase) throw new Error("Supabase client is required.");
-      const { data, error } = await listProfiles({ supabase, page, limit });
+      const { data, error, nextCursor } = await listProfilesByCursor({
+        supabase,
+        ...otherFilters,
+        limit,
+        cursor: pageParam,
+      });
       if (error) throw error;
-      return data || []; // Return empty array if data is null
+      return { data: data ?? [], nextCursor };
     },
+    initialPageParam: null as string | null,
+    getNextPageParam: (lastPage) => lastPage.nextCursor,
+  });
+};
+
+/**
+ * Fetches profiles as an infinite list using cursor pagination, for infinite
+ * scrolling. Each page costs the same regardless of how deep the user scrolls.
+ * @param filters Page size (limit, default: 10).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A UseInfiniteQueryResult; rows are in `data.pages[n].data`.
+ * @example
+ * const supabase = // ... get your Supabase client instance ...
+ * const { data, fetchNextPage, hasNextPage } = useInfiniteProfiles({ limit: 20 }, { supabase });
+ * const profiles = data?.pages.flatMap((page) => page.data) ?? [];
+ */
+export const useInfiniteProfiles = (
+  filters: { limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+): UseInfiniteQueryResult<
+  InfiniteData<ProfilesPage, string | null>,
+  Error
+> => {
+  const { supabase } = options;
+
+  return useInfiniteQuery({
+    ...infiniteProfilesQueryOptions(filters, { supabase }),
     enabled: !!supabase,
   });
 };
 
+/**
+ * Prefetches a profile into a QueryClient, e.g. in a server component before
+ * dehydrating the client into a `HydrationBoundary`.
+ * @param queryClient The QueryClient to fill.
+ * @param id The ID of the profile to prefetch.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A promise that resolves once the query has settled.
+ * @example
+ * const queryClient = getQueryClient();
+ * await prefetchProfile(queryClient, 'profile-uuid', { supabase });
+ * return <HydrationBoundary state={dehydrate(queryClient)}>...</HydrationBoundary>;
+ */
+export const prefetchProfile = (
+  queryClient: QueryClient,
+  id: string,
+  options: { supabase: SupabaseClient<Database> },
+): Promise<void> =>
+  queryClient.prefetchQuery(profileQueryOptions(id, options));
+
+/**
+ * Prefetches a page of profiles (see `useProfiles`) into a QueryClient.
+ * @param queryClient The QueryClient to fill.
+ * @param filters Filters for pagination (page, limit).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A promise that resolves once the query has settled.
+ */
+export const prefetchProfiles = (
+  queryClient: QueryClient,
+  filters: { page?: number; limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+): Promise<void> =>
+  queryClient.prefetchQuery(profilesQueryOptions(filters, options));
+
+/**
+ * Prefetches the first page of an infinite profile list (see `useInfiniteProfiles`).
+ * @param queryClient The QueryClient to fill.
+ * @param filters Page size (limit, default: 10).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A promise that resolves once the query has settled.
+ */
+export const prefetchInfiniteProfiles = (
+  queryClient: QueryClient,
+  filters: { limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+): Promise<void> =>
+  queryClient.prefetchInfiniteQuery(
+    infiniteProfilesQueryOptions(filters, options),
+  );
+
+/**
+ * Returns a callback that warms the `["profiles", id]` cache, for `onMouseEnter` /
+ * `onFocus` handlers or when a row scrolls into view. Fresh entries are not
+ * refetched, and concurrent calls are batched into one request.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @param options.staleTime How long a prefetched profile counts as fresh in ms (default: 30000).
+ * @returns A function taking the ID of the profile to prefetch.
+ * @example
+ * const prefetch = usePrefetchProfile({ supabase });
+ * <Link href={`/profiles/${id}`} onMouseEnter={() => prefetch(id)}>...</Link>
+ */
+export const usePrefetchProfile = (options: {
+  supabase: SupabaseClient<Database>;
+  staleTime?: number;
+}): ((id: string) => void) => {
+  const { supabase, staleTime = 30_000 } = options;
+  const queryClient = useQueryClient();
+
+  return useCallback(
+    (id: string) => {
+      if (!id || !supabase) return;
+      void queryClient.prefetchQuery({
+        ...profileQueryOptions(id, { supabase }),
+        staleTime,
+      });
+    },
+    [queryClient, supabase, staleTime],
+  );
+};
+
 /**
  * Creates a new profile record.
  * Note: Typically, profiles are created via triggers. Use cautiously.
@@ -106,14 +377,15 @@ export const useCreateProfile = (): UseMutationResult<
       return data;
     },
     onSuccess: (data) => {
-      queryClient.invalidateQueries({ queryKey: ["profiles"] });
-      queryClient.setQueryData(["profiles", data.id], data);
+      // Seed the new row and refetch only the lists whose filters it matches.
+      insertRowIntoCaches(queryClient, "profiles", data);
     },
   });
 };
 
 /**
  * Updates an existing profile record.
+ * The change is applied to cached data immediately and rolled back if the request fails.
  * @returns A UseMutationResult object. Call mutate with { supabase, id, updateData }.
  * @example
  * const supabase = // ... get your Supabase client instance ...
@@ -134,8 +406,10 @@ export const useUpdateProfile = (): UseMutationResult<
       supabase: SupabaseClient<Database>;
       id: string;
       updateData: ProfileUpdate;
-    }
+    },
+    OptimisticSnapshot
   >({
+    mutationKey: updateMutationKey("profiles"),
     mutationFn: async ({ supabase, id, updateData }) => {
       if (!supabase) throw new Error("Supabase client is required.");
       const { data, error } = await updateProfile({ supabase, id, updateData });
@@ -143,10 +417,13 @@ export const useUpdateProfile = (): UseMutationResult<
       if (!data) throw new Error("Failed to update Profile, no data returned.");
       return data;
     },
-    onSuccess: (data, variables) => {
-      queryClient.invalidateQueries({ queryKey: ["profiles"] });
-      queryClient.invalidateQueries({ queryKey: ["profiles", variables.id] });
-      queryClient.setQueryData(["profiles", variables.id], data);
+    // Show the edit immediately in the detail cache and every list holding it.
+    onMutate: ({ id, updateData }) =>
+      applyOptimisticUpdate(queryClient, "profiles", id, updateData),
+    onError: (_error, _variables, snapshot) =>
+      rollbackOptimisticUpdate(queryClient, "profiles", snapshot),
+    onSettled: (data) => {
+      if (data) reconcileServerRow(queryClient, "profiles", data);
     },
   });
 };
@@ -179,8 +456,8 @@ export const useDeleteProfile = (): UseMutationResult<
       return null;
     },
     onSuccess: (data, variables) => {
-      queryClient.invalidateQueries({ queryKey: ["profiles"] });
-      queryClient.removeQueries({ queryKey: ["profiles", variables.id] });
+      // Drop the row from its detail cache and any list holding it.
+      removeRowFromCaches(queryClient, "profiles", variables.id);
     },
   });
 };
@@ -1,15 +1,38 @@
-import { SupabaseClient, PostgrestSingleResponse } from "@supabase/supabase-js";
+import {
+  SupabaseClient,
+  PostgrestSingleResponse,
+  PostgrestError,
+} from "@supabase/supabase-js";
 import {
   Database,
   Tables,
   TablesInsert,
   TablesUpdate,
 } from "../types/database.types";
+import {
+  CursorColumns,
+  CursorPageOptions,
+  CursorPageResponse,
+  buildKeysetFilter,
+  buildProjection,
+  clampLimit,
+  decodeCursor,
+  toCursorPage,
+} from "../utils/pagination";
+import { BatchLoader, createBatchLoader } from "../utils/batch-loader";
+import {
+  BulkOptions,
+  BulkResponse,
+  DEFAULT_BULK_IDS_PER_REQUEST,
+  mergePatchesById,
+  runBulk,
+} from "../utils/bulk";
 
 // Define table-specific types
 export type Profile = Tables<"profiles">;
 export type ProfileInsert = TablesInsert<"profiles">;
 export type ProfileUpdate = TablesUpdate<"profiles">;
+export type ProfilePatch = ProfileUpdate & { id: string };
 
 /**
  * Fetches a profiles record by its primary key (id).
@@ -29,6 +52,55 @@ export const fetchProfileById = async ({
   return supabase.from("profiles").select("*").eq("id", id).single();
 };
 
+/**
+ * Fetches several profiles records by primary key in a single request.
+ * Ids that do not exist (or are hidden by RLS) are simply absent from the result.
+ * @param supabase The Supabase client instance.
+ * @param ids The primary keys of the profiles to fetch.
+ * @returns A promise that resolves to the fetched profiles records.
+ * @example
+ * const { data, error } = await fetchProfilesByIds({ supabase, ids: ["user-uuid-1", "user-uuid-2"] });
+ */
+export const fetchProfilesByIds = async ({
+  supabase,
+  ids,
+}: {
+  supabase: SupabaseClient<Database>;
+  ids: readonly string[];
+}): Promise<PostgrestSingleResponse<Profile[]>> => {
+  return supabase
+    .from("profiles")
+    .select("*")
+    .in("id", Array.from(new Set(ids)));
+};
+
+/**
+ * Creates a batching loader for profiles records. Concurrent `load` calls made in
+ * the same tick are coalesced into one `fetchProfilesByIds` request.
+ * Create one loader per request scope; results are cached for its lifetime.
+ * @param supabase The Supabase client instance.
+ * @param cache Whether to cache results for the lifetime of the loader (default: true).
+ * @returns A BatchLoader for profiles records.
+ * @example
+ * const loader = createProfileLoader({ supabase });
+ * const profiles = await loader.loadMany(ids); // one PostgREST request
+ */
+export const createProfileLoader = ({
+  supabase,
+  cache = true,
+}: {
+  supabase: SupabaseClient<Database>;
+  cache?: boolean;
+}): BatchLoader<Profile> =>
+  createBatchLoader<Profile>({
+    cache,
+    batchFn: async (ids) => {
+      const { data, error } = await fetchProfilesByIds({ supabase, ids });
+      if (error) throw error;
+      return new Map((data ?? []).map((row) => [row.id, row]));
+    },
+  });
+
 /**
  * Creates a new profiles record.
  * Note: Typically, profiles are created via triggers on auth.users table.
@@ -107,6 +179,120 @@ export const deleteProfile = async ({
   return supabase.from("profiles").delete().eq("id", id);
 };
 
+/**
+ * Creates many profiles records with multi-row inserts. Rows are sent in chunks
+ * (default: 500 per request) with bounded concurrency (default: 4).
+ * @param supabase The Supabase client instance.
+ * @param rows The rows to insert.
+ * @param chunkSize Maximum rows per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the created records and the rows of any failed chunks.
+ * @example
+ * const { data, error, failed } = await createProfiles({ supabase, rows: [{ id: 'user-uuid', username: 'newuser' }] });
+ */
+export const createProfiles = async ({
+  supabase,
+  rows,
+  ...options
+}: {
+  supabase: SupabaseClient<Database>;
+  rows: readonly ProfileInsert[];
+} & BulkOptions): Promise<BulkResponse<Profile, ProfileInsert>> =>
+  runBulk(
+    rows,
+    (part) => supabase.from("profiles").insert(part).select(),
+    options,
+  );
+
+/**
+ * Inserts or updates many profiles records (`INSERT ... ON CONFLICT DO UPDATE`).
+ * Rows are sent in chunks (default: 500 per request) with bounded concurrency.
+ * @param supabase The Supabase client instance.
+ * @param rows The rows to upsert.
+ * @param onConflict Comma separated columns of the unique constraint to match on (default: "id").
+ * @param ignoreDuplicates Skip conflicting rows instead of updating them (default: false).
+ * @param chunkSize Maximum rows per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the written records and the rows of any failed chunks.
+ * @example
+ * const { data, error } = await upsertProfiles({ supabase, rows: [{ id: 'user-uuid', username: 'newuser' }] });
+ */
+export const upsertProfiles = async ({
+  supabase,
+  rows,
+  onConflict = "id",
+  ignoreDuplicates = false,
+  ...options
+}: {
+  supabase: SupabaseClient<Database>;
+  rows: readonly ProfileInsert[];
+  onConflict?: string;
+  ignoreDuplicates?: boolean;
+} & BulkOptions): Promise<BulkResponse<Profile, ProfileInsert>> =>
+  runBulk(
+    rows,
+    (part) =>
+      supabase
+        .from("profiles")
+        .upsert(part, { onConflict, ignoreDuplicates })
+        .select(),
+    options,
+  );
+
+/**
+ * Updates many profiles records through the `bulk_update_profiles` RPC, which applies
+ * each chunk of patches in a single UPDATE statement. Only keys present in a
+ * patch are changed; patches for the same id are merged first. A key that is not
+ * a patchable column makes the RPC raise, failing the whole chunk.
+ * @param supabase The Supabase client instance.
+ * @param patches The patches to apply, each with the id of the record to update.
+ * @param chunkSize Maximum patches per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the updated records and the patches of any failed chunks.
+ * @example
+ * const { data, error } = await updateProfiles({ supabase, patches: [{ id: 'profile-uuid', full_name: 'New Name' }] });
+ */
+export const updateProfiles = async ({
+  supabase,
+  patches,
+  ...options
+}: {
+  supabase: SupabaseClient<Database>;
+  patches: readonly ProfilePatch[];
+} & BulkOptions): Promise<BulkResponse<Profile, ProfilePatch>> =>
+  runBulk(
+    mergePatchesById(patches),
+    (part) => supabase.rpc("bulk_update_profiles", { patches: part }),
+    options,
+  );
+
+/**
+ * Deletes many profiles records by primary key using `.in("id", ids)`. Ids are sent
+ * in chunks (default: 150 per request, to stay within URL length limits).
+ * @param supabase The Supabase client instance.
+ * @param ids The primary keys of the profiles to delete.
+ * @param chunkSize Maximum ids per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the ids that were deleted and the ids of any failed chunks.
+ * @example
+ * const { data: deleted, error } = await deleteProfiles({ supabase, ids: ["uuid-1", "uuid-2"] });
+ */
+export const deleteProfiles = async ({
+  supabase,
+  ids,
+  chunkSize = DEFAULT_BULK_IDS_PER_REQUEST,
+  concurrency,
+}: {
+  supabase: SupabaseClient<Database>;
+  ids: readonly string[];
+} & BulkOptions): Promise<BulkResponse<{ id: string }, string>> =>
+  runBulk(
+    Array.from(new Set(ids)),
+    (part) =>
+      supabase.from("profiles").delete().in("id", part).select("id"),
+    { chunkSize, concurrency },
+  );
+
 /**
  * Lists profiles records with pagination.
  * @param supabase The Supabase client instance.
@@ -129,3 +315,51 @@ export const listProfiles = async ({
   const rangeEnd = rangeStart + limit - 1;
   return supabase.from("profiles").select("*").range(rangeStart, rangeEnd);
 };
+
+/**
+ * Lists profiles records using keyset (cursor) pagination on `(created_at, id)`.
+ * Unlike `listProfiles`, the cost of a page does not grow with its depth.
+ * @param supabase The Supabase client instance.
+ * @param cursor The `nextCursor` returned by the previous page (omit for the first page).
+ * @param limit The number of records per page (default: 10).
+ * @param columns Optional column projection. `id` and `created_at` are always returned.
+ * @param count Pass "estimated" to include a planner-estimated total count.
+ * @returns A promise that resolves to the page of profiles records and the next cursor.
+ * @throws Error if the cursor is malformed.
+ * @example
+ * const { data, nextCursor, error } = await listProfilesByCursor({ supabase, columns: ['username', 'avatar_url'], limit: 50 });
+ * const nextPage = await listProfilesByCursor({ supabase, cursor: nextCursor });
+ */
+export const listProfilesByCursor = async <
+  K extends keyof Profile = keyof Profile,
+>({
+  supabase,
+  cursor,
+  limit,
+  columns,
+  count,
+}: {
+  supabase: SupabaseClient<Database>;
+} & CursorPageOptions<K>): Promise<
+  CursorPageResponse<Pick<Profile, K | CursorColumns>>
+> => {
+  const pageSize = clampLimit(limit);
+  let query = supabase
+    .from("profiles")
+    .select(buildProjection(columns), { count });
+  if (cursor) {
+    query = query.or(buildKeysetFilter(decodeCursor(cursor)));
+  }
+  const result = await query
+    .order("created_at", { ascending: false })
+    .order("id", { ascending: false })
+    .limit(pageSize + 1);
+  return toCursorPage(
+    result as unknown as {
+      data: Pick<Profile, K | CursorColumns>[] | null;
+      error: PostgrestError | null;
+      count: number | null;
+    },
+    pageSize,
+  );
+};
@@ -1,23 +1,88 @@
+import { useCallback } from "react";
 import {
+  infiniteQueryOptions,
+  keepPreviousData,
+  queryOptions,
+  useInfiniteQuery,
   useQuery,
   useMutation,
   useQueryClient,
+  InfiniteData,
+  QueryClient,
+  UseInfiniteQueryResult,
   UseQueryResult,
   UseMutationResult,
 } from "@tanstack/react-query";
 import { SupabaseClient } from "@supabase/supabase-js";
 import { Database } from "../types/database.types";
+import { BatchLoader } from "../utils/batch-loader";
+import {
+  applyOptimisticUpdate,
+  reconcileServerRow,
+  rollbackOptimisticUpdate,
+  updateMutationKey,
+  OptimisticSnapshot,
+} from "../utils/optimistic";
+import {
+  findRowInLists,
+  insertRowIntoCaches,
+  removeRowFromCaches,
+} from "../utils/query-cache";
 import {
   Project,
   ProjectInsert,
   ProjectUpdate,
-  fetchProjectById,
+  fetchProjectsByIds,
+  createProjectLoader,
   createProject,
   updateProject,
   deleteProject,
   listProjects,
+  listProjectsByCursor,
 } from "./projects"; // Adjusted path
 
+// One uncached loader per client: concurrent `useProject` queries issued in
+// the same tick share a single request, while React Query remains the cache.
+const projectLoaders = new WeakMap<
+  SupabaseClient<Database>,
+  BatchLoader<Project>
+>();
+
+const getProjectLoader = (
+  supabase: SupabaseClient<Database>,
+): BatchLoader<Project> => {
+  let loader = projectLoaders.get(supabase);
+  if (!loader) {
+    loader = createProjectLoader({ supabase, cache: false });
+    projectLoaders.set(supabase, loader);
+  }
+  return loader;
+};
+
+/**
+ * Query options for a single project, shared by `useProject` and `prefetchProject`.
+ * @param id The ID of the project to fetch.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns Options for `useQuery`, `prefetchQuery` or `fetchQuery`.
+ */
+export const projectQueryOptions = (
+  id: string,
+  options: { supabase: SupabaseClient<Database> },
+) => {
+  const { supabase } = options;
+
+  return queryOptions<Project, Error>({
+    queryKey: ["projects", id],
+    queryFn: async () => {
+      if (!supabase) throw new Error("Supabase client is required.");
+      const data = await getProjectLoader(supabase).load(id);
+      if (!data) throw new Error("Project not found");
+      return data;
+    },
+  });
+};
+
 /**
  * Fetches a specific project record by its ID using React Query.
  * @param id The ID of the project to fetch.
@@ -33,17 +98,88 @@ export const useProject = (
   options: { supabase: SupabaseClient<Database> },
 ): UseQueryResult<Project, Error> => {
   const { supabase } = options;
+  const queryClient = useQueryClient();
 
   return useQuery<Project, Error>({
-    queryKey: ["projects", id],
+    ...projectQueryOptions(id, { supabase }),
+    // Render instantly from a cached list holding the row while it loads.
+    placeholderData: () =>
+      findRowInLists<Project>(queryClient, "projects", id),
+    enabled: !!id && !!supabase,
+  });
+};
+
+/**
+ * Fetches several project records in one request and seeds the individual
+ * `["projects", id]` cache entries from the result, so later `useProject(id)` calls
+ * render from cache instead of issuing one request each.
+ * @param ids The IDs of the projects to fetch.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A UseQueryResult object for the projects, in the order of `ids` (missing ids are skipped).
+ * @example
+ * const supabase = // ... get your Supabase client instance ...
+ * const { data: projects } = useProjectsByIds(['project-uuid-1', 'project-uuid-2'], { supabase });
+ */
+export const useProjectsByIds = (
+  ids: readonly string[],
+  options: { supabase: SupabaseClient<Database> },
+): UseQueryResult<Project[], Error> => {
+  const { supabase } = options;
+  const queryClient = useQueryClient();
+  const uniqueIds = Array.from(new Set(ids)).sort();
+
+  return useQuery<Project[], Error>({
+    queryKey: ["projects", { ids: uniqueIds }],
     queryFn: async () => {
       if (!supabase) throw new Error("Supabase client is required.");
-      const { data, error } = await fetchProjectById({ supabase, id });
+      const { data, error } = await fetchProjectsByIds({
+        supabase,
+        ids: uniqueIds,
+      });
       if (error) throw error;
-      if (!data) throw new Error("Project not found");
-      return data;
+      const byId = new Map((data ?? []).map((row) => [row.id, row]));
+      byId.forEach((row, id) =>
+        queryClient.setQueryData(["projects", id], row),
+      );
+      return ids
+        .map((id) => byId.get(id))
+        .filter((row): row is Project => !!row);
+    },
+    enabled: uniqueIds.length > 0 && !!supabase,
+  });
+};
+
+/**
+ * Query options for a page of projects, shared by `useProjects` and `prefetchProjects`.
+ * @param filters Filters for pagination (page, limit).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns Options for `useQuery`, `prefetchQuery` or `fetchQuery`.
+ */
+export const projectsQueryOptions = (
+  filters: { page?: number; limit?: number; [key: string]: any }, // Allow additional filters
+  options: { supabase: SupabaseClient<Database> },
+) => {
+  const { supabase } = options;
+  // Extract known filters, pass the rest if listProjects supports them (adjust listProjects accordingly)
+  const { page = 1, limit = 10, ...otherFilters } = filters;
+
+  return queryOptions<Project[], Error>({
+    // Include all filters in the query key for proper caching
+    queryKey: ["projects", { page, limit, ...otherFilters }],
+    queryFn: async () => {
+      if (!supabase) throw new Error("Supabase client is required.");
+      // Pass all filters to listProjects (modify listProjects to accept them if needed)
+      const { data, error } = await listProjects({
+        supabase,
+        page,
+        limit,
+        ...otherFilters,
+      });
+      if (error) throw error;
+      return data || []; // Return empty array if data is null
     },
-    enabled: !!id && !!supabase,
   });
 };
 
@@ -64,28 +200,163 @@ export const useProjects = (
   options: { supabase: SupabaseClient<Database> },
 ): UseQueryResult<Project[], Error> => {
   const { supabase } = options;
-  // Extract known filters, pass the rest if listProjects supports them (adjust listProjects accordingly)
-  const { page = 1, limit = 10, ...otherFilters } = filters;
 
   return useQuery<Project[], Error>({
-    // Include all filters in the query key for proper caching
-    queryKey: ["projects", { page, limit, ...otherFilters }],
-    queryFn: async () => {
+    ...projectsQueryOptions(filters, { supabase }),
+    // Keep showing the previous page while the next one loads.
+    placeholderData: keepPreviousData,
+    enabled: !!supabase,
+  });
+};
+
+/**
+ * A page of projects as stored by `useInfiniteProjects`.
+ */
+export type ProjectsPage = { data: Project[]; nextCursor: string | null };
+
+/**
+ * Infinite query options for projects, backed by `listProjectsByCursor`.
+ * Shared by `useInfiniteProjects` and `prefetchInfiniteProjects`.
+ * @param filters Optional `organization_id` filter and page size (limit, default: 10).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns Options for `useInfiniteQuery` or `prefetchInfiniteQuery`.
+ */
+export const infiniteProjectsQueryOptions = (
+  filters: { organization_id?: string; limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+) => {
+  const { supabase } = options;
+  const { limit = 10, ...otherFilters } = filters;
+
+  return infiniteQueryOptions({
+    queryKey: ["projects", { infinite: true, limit, ...otherFilters }],
+    queryFn: async ({ pageParam }): Promise<ProjectsPage> => {
       if (!supabase) throw new Error("Supabase client is required.");
-      // Pass all filters to listProjects (modify listProjects to accept them if needed)
-      const { data, error } = await listProjects({
+      const { data, error, nextCursor } = await listProjectsByCursor({
         supabase,
-        page,
-        limit,
         ...otherFilters,
+        limit,
+        cursor: pageParam,
       });
       if (error) throw error;
-      return data || []; // Return empty array if data is null
+      return { data: data ?? [], nextCursor };
     },
+    initialPageParam: null as string | null,
+    getNextPageParam: (lastPage) => lastPage.nextCursor,
+  });
+};
+
+/**
+ * Fetches projects as an infinite list using cursor pagination, for infinite
+ * scrolling. Each page costs the same regardless of how deep the user scrolls.
+ * @param filters Optional `organization_id` filter and page size (limit, default: 10).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A UseInfiniteQueryResult; rows are in `data.pages[n].data`.
+ * @example
+ * const supabase = // ... get your Supabase client instance ...
+ * const { data, fetchNextPage, hasNextPage } = useInfiniteProjects({ organization_id: 'org-uuid' }, { supabase });
+ * const projects = data?.pages.flatMap((page) => page.data) ?? [];
+ */
+export const useInfiniteProjects = (
+  filters: { organization_id?: string; limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+): UseInfiniteQueryResult<
+  InfiniteData<ProjectsPage, string | null>,
+  Error
+> => {
+  const { supabase } = options;
+
+  return useInfiniteQuery({
+    ...infiniteProjectsQueryOptions(filters, { supabase }),
     enabled: !!supabase,
   });
 };
 
+/**
+ * Prefetches a project into a QueryClient, e.g. in a server component before
+ * dehydrating the client into a `HydrationBoundary`.
+ * @param queryClient The QueryClient to fill.
+ * @param id The ID of the project to prefetch.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A promise that resolves once the query has settled.
+ * @example
+ * const queryClient = getQueryClient();
+ * await prefetchProject(queryClient, 'project-uuid', { supabase });
+ * return <HydrationBoundary state={dehydrate(queryClient)}>...</HydrationBoundary>;
+ */
+export const prefetchProject = (
+  queryClient: QueryClient,
+  id: string,
+  options: { supabase: SupabaseClient<Database> },
+): Promise<void> =>
+  queryClient.prefetchQuery(projectQueryOptions(id, options));
+
+/**
+ * Prefetches a page of projects (see `useProjects`) into a QueryClient.
+ * @param queryClient The QueryClient to fill.
+ * @param filters Filters for pagination (page, limit).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A promise that resolves once the query has settled.
+ */
+export const prefetchProjects = (
+  queryClient: QueryClient,
+  filters: { page?: number; limit?: number; [key: string]: any }, // Allow additional filters
+  options: { supabase: SupabaseClient<Database> },
+): Promise<void> =>
+  queryClient.prefetchQuery(projectsQueryOptions(filters, options));
+
+/**
+ * Prefetches the first page of an infinite project list (see `useInfiniteProjects`).
+ * @param queryClient The QueryClient to fill.
+ * @param filters Optional `organization_id` filter and page size (limit, default: 10).
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @returns A promise that resolves once the query has settled.
+ */
+export const prefetchInfiniteProjects = (
+  queryClient: QueryClient,
+  filters: { organization_id?: string; limit?: number },
+  options: { supabase: SupabaseClient<Database> },
+): Promise<void> =>
+  queryClient.prefetchInfiniteQuery(
+    infiniteProjectsQueryOptions(filters, options),
+  );
+
+/**
+ * Returns a callback that warms the `["projects", id]` cache, for `onMouseEnter` /
+ * `onFocus` handlers or when a row scrolls into view. Fresh entries are not
+ * refetched, and concurrent calls are batched into one request.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @param options.staleTime How long a prefetched project counts as fresh in ms (default: 30000).
+ * @returns A function taking the ID of the project to prefetch.
+ * @example
+ * const prefetch = usePrefetchProject({ supabase });
+ * <Link href={`/projects/${id}`} onMouseEnter={() => prefetch(id)}>...</Link>
+ */
+export const usePrefetchProject = (options: {
+  supabase: SupabaseClient<Database>;
+  staleTime?: number;
+}): ((id: string) => void) => {
+  const { supabase, staleTime = 30_000 } = options;
+  const queryClient = useQueryClient();
+
+  return useCallback(
+    (id: string) => {
+      if (!id || !supabase) return;
+      void queryClient.prefetchQuery({
+        ...projectQueryOptions(id, { supabase }),
+        staleTime,
+      });
+    },
+    [queryClient, supabase, staleTime],
+  );
+};
+
 /**
  * Creates a new project record.
  * @returns A UseMutationResult object. Call mutate with { supabase, insertData }.
@@ -114,16 +385,15 @@ export const useCreateProject = (): UseMutationResult<
       return data;
     },
     onSuccess: (data) => {
-      // Invalidate the general list query. Consider invalidating specific filtered lists too if applicable.
-      queryClient.invalidateQueries({ queryKey: ["projects"] });
-      // Optionally prime the cache for the new item
-      queryClient.setQueryData(["projects", data.id], data);
+      // Seed the new row and refetch only the lists whose filters it matches.
+      insertRowIntoCaches(queryClient, "projects", data);
     },
   });
 };
 
 /**
  * Updates an existing project record.
+ * The change is applied to cached data immediately and rolled back if the request fails.
  * @returns A UseMutationResult object. Call mutate with { supabase, id, updateData }.
  * @example
  * const supabase = // ... get your Supabase client instance ...
@@ -144,8 +414,10 @@ export const useUpdateProject = (): UseMutationResult<
       supabase: SupabaseClient<Database>;
       id: string;
       updateData: ProjectUpdate;
-    }
+    },
+    OptimisticSnapshot
   >({
+    mutationKey: updateMutationKey("projects"),
     mutationFn: async ({ supabase, id, updateData }) => {
       if (!supabase) throw new Error("Supabase client is required.");
       const { data, error } = await updateProject({ supabase, id, updateData });
@@ -153,12 +425,13 @@ export const useUpdateProject = (): UseMutationResult<
       if (!data) throw new Error("Failed to update Project, no data returned.");
       return data;
     },
-    onSuccess: (data, variables) => {
-      // Invalidate the general list query and the specific item query
-      queryClient.invalidateQueries({ queryKey: ["projects"] });
-      queryClient.invalidateQueries({ queryKey: ["projects", variables.id] });
-      // Optionally update the cache for the updated item
-      queryClient.setQueryData(["projects", variables.id], data);
+    // Show the edit immediately in the detail cache and every list holding it.
+    onMutate: ({ id, updateData }) =>
+      applyOptimisticUpdate(queryClient, "projects", id, updateData),
+    onError: (_error, _variables, snapshot) =>
+      rollbackOptimisticUpdate(queryClient, "projects", snapshot),
+    onSettled: (data) => {
+      if (data) reconcileServerRow(queryClient, "projects", data);
     },
   });
 };
@@ -190,9 +463,8 @@ export const useDeleteProject = (): UseMutationResult<
       return null;
     },
     onSuccess: (data, variables) => {
-      // Invalidate the general list query and remove the specific item query from cache
-      queryClient.invalidateQueries({ queryKey: ["projects"] });
-      queryClient.removeQueries({ queryKey: ["projects", variables.id] });
+      // Drop the row from its detail cache and any list holding it.
+      removeRowFromCaches(queryClient, "projects", variables.id);
     },
   });
 };
@@ -1,15 +1,38 @@
-import { SupabaseClient, PostgrestSingleResponse } from "@supabase/supabase-js";
+import {
+  SupabaseClient,
+  PostgrestSingleResponse,
+  PostgrestError,
+} from "@supabase/supabase-js";
 import {
   Database,
   Tables,
   TablesInsert,
   TablesUpdate,
 } from "../types/database.types";
+import {
+  CursorColumns,
+  CursorPageOptions,
+  CursorPageResponse,
+  buildKeysetFilter,
+  buildProjection,
+  clampLimit,
+  decodeCursor,
+  toCursorPage,
+} from "../utils/pagination";
+import { BatchLoader, createBatchLoader } from "../utils/batch-loader";
+import {
+  BulkOptions,
+  BulkResponse,
+  DEFAULT_BULK_IDS_PER_REQUEST,
+  mergePatchesById,
+  runBulk,
+} from "../utils/bulk";
 
 // Define table-specific types
 export type Project = Tables<"projects">;
 export type ProjectInsert = TablesInsert<"projects">;
 export type ProjectUpdate = TablesUpdate<"projects">;
+export type ProjectPatch = ProjectUpdate & { id: string };
 
 /**
  * Fetches a projects record by its primary key (id).
@@ -29,6 +52,55 @@ export const fetchProjectById = async ({
   return supabase.from("projects").select("*").eq("id", id).single();
 };
 
+/**
+ * Fetches several projects records by primary key in a single request.
+ * Ids that do not exist (or are hidden by RLS) are simply absent from the result.
+ * @param supabase The Supabase client instance.
+ * @param ids The primary keys of the projects to fetch.
+ * @returns A promise that resolves to the fetched projects records.
+ * @example
+ * const { data, error } = await fetchProjectsByIds({ supabase, ids: ["project-uuid-1", "project-uuid-2"] });
+ */
+export const fetchProjectsByIds = async ({
+  supabase,
+  ids,
+}: {
+  supabase: SupabaseClient<Database>;
+  ids: readonly string[];
+}): Promise<PostgrestSingleResponse<Project[]>> => {
+  return supabase
+    .from("projects")
+    .select("*")
+    .in("id", Array.from(new Set(ids)));
+};
+
+/**
+ * Creates a batching loader for projects records. Concurrent `load` calls made in
+ * the same tick are coalesced into one `fetchProjectsByIds` request.
+ * Create one loader per request scope; results are cached for its lifetime.
+ * @param supabase The Supabase client instance.
+ * @param cache Whether to cache results for the lifetime of the loader (default: true).
+ * @returns A BatchLoader for projects records.
+ * @example
+ * const loader = createProjectLoader({ supabase });
+ * const projects = await loader.loadMany(ids); // one PostgREST request
+ */
+export const createProjectLoader = ({
+  supabase,
+  cache = true,
+}: {
+  supabase: SupabaseClient<Database>;
+  cache?: boolean;
+}): BatchLoader<Project> =>
+  createBatchLoader<Project>({
+    cache,
+    batchFn: async (ids) => {
+      const { data, error } = await fetchProjectsByIds({ supabase, ids });
+      if (error) throw error;
+      return new Map((data ?? []).map((row) => [row.id, row]));
+    },
+  });
+
 /**
  * Creates a new projects record.
  * @param supabase The Supabase client instance.
@@ -91,6 +163,120 @@ export const deleteProject = async ({
   return supabase.from("projects").delete().eq("id", id);
 };
 
+/**
+ * Creates many projects records with multi-row inserts. Rows are sent in chunks
+ * (default: 500 per request) with bounded concurrency (default: 4).
+ * @param supabase The Supabase client instance.
+ * @param rows The rows to insert.
+ * @param chunkSize Maximum rows per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the created records and the rows of any failed chunks.
+ * @example
+ * const { data, error, failed } = await createProjects({ supabase, rows: [{ name: 'Imported', organization_id: 'org-uuid' }] });
+ */
+export const createProjects = async ({
+  supabase,
+  rows,
+  ...options
+}: {
+  supabase: SupabaseClient<Database>;
+  rows: readonly ProjectInsert[];
+} & BulkOptions): Promise<BulkResponse<Project, ProjectInsert>> =>
+  runBulk(
+    rows,
+    (part) => supabase.from("projects").insert(part).select(),
+    options,
+  );
+
+/**
+ * Inserts or updates many projects records (`INSERT ... ON CONFLICT DO UPDATE`).
+ * Rows are sent in chunks (default: 500 per request) with bounded concurrency.
+ * @param supabase The Supabase client instance.
+ * @param rows The rows to upsert.
+ * @param onConflict Comma separated columns of the unique constraint to match on (default: "id").
+ * @param ignoreDuplicates Skip conflicting rows instead of updating them (default: false).
+ * @param chunkSize Maximum rows per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the written records and the rows of any failed chunks.
+ * @example
+ * const { data, error } = await upsertProjects({ supabase, rows: [{ name: 'Imported', organization_id: 'org-uuid' }] });
+ */
+export const upsertProjects = async ({
+  supabase,
+  rows,
+  onConflict = "id",
+  ignoreDuplicates = false,
+  ...options
+}: {
+  supabase: SupabaseClient<Database>;
+  rows: readonly ProjectInsert[];
+  onConflict?: string;
+  ignoreDuplicates?: boolean;
+} & BulkOptions): Promise<BulkResponse<Project, ProjectInsert>> =>
+  runBulk(
+    rows,
+    (part) =>
+      supabase
+        .from("projects")
+        .upsert(part, { onConflict, ignoreDuplicates })
+        .select(),
+    options,
+  );
+
+/**
+ * Updates many projects records through the `bulk_update_projects` RPC, which applies
+ * each chunk of patches in a single UPDATE statement. Only keys present in a
+ * patch are changed; patches for the same id are merged first. A key that is not
+ * a patchable column makes the RPC raise, failing the whole chunk.
+ * @param supabase The Supabase client instance.
+ * @param patches The patches to apply, each with the id of the record to update.
+ * @param chunkSize Maximum patches per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the updated records and the patches of any failed chunks.
+ * @example
+ * const { data, error } = await updateProjects({ supabase, patches: [{ id: 'project-uuid', name: 'Renamed' }] });
+ */
+export const updateProjects = async ({
+  supabase,
+  patches,
+  ...options
+}: {
+  supabase: SupabaseClient<Database>;
+  patches: readonly ProjectPatch[];
+} & BulkOptions): Promise<BulkResponse<Project, ProjectPatch>> =>
+  runBulk(
+    mergePatchesById(patches),
+    (part) => supabase.rpc("bulk_update_projects", { patches: part }),
+    options,
+  );
+
+/**
+ * Deletes many projects records by primary key using `.in("id", ids)`. Ids are sent
+ * in chunks (default: 150 per request, to stay within URL length limits).
+ * @param supabase The Supabase client instance.
+ * @param ids The primary keys of the projects to delete.
+ * @param chunkSize Maximum ids per request.
+ * @param concurrency Maximum requests in flight at once.
+ * @returns A promise that resolves to the ids that were deleted and the ids of any failed chunks.
+ * @example
+ * const { data: deleted, error } = await deleteProjects({ supabase, ids: ["uuid-1", "uuid-2"] });
+ */
+export const deleteProjects = async ({
+  supabase,
+  ids,
+  chunkSize = DEFAULT_BULK_IDS_PER_REQUEST,
+  concurrency,
+}: {
+  supabase: SupabaseClient<Database>;
+  ids: readonly string[];
+} & BulkOptions): Promise<BulkResponse<{ id: string }, string>> =>
+  runBulk(
+    Array.from(new Set(ids)),
+    (part) =>
+      supabase.from("projects").delete().in("id", part).select("id"),
+    { chunkSize, concurrency },
+  );
+
 /**
  * Lists projects records with pagination.
  * @param supabase The Supabase client instance.
@@ -113,3 +299,57 @@ export const listProjects = async ({
   const rangeEnd = rangeStart + limit - 1;
   return supabase.from("projects").select("*").range(rangeStart, rangeEnd);
 };
+
+/**
+ * Lists projects records using keyset (cursor) pagination on `(created_at, id)`.
+ * Unlike `listProjects`, the cost of a page does not grow with its depth.
+ * @param supabase The Supabase client instance.
+ * @param organization_id Optional filter restricting results to a single organization.
+ * @param cursor The `nextCursor` returned by the previous page (omit for the first page).
+ * @param limit The number of records per page (default: 10).
+ * @param columns Optional column projection. `id` and `created_at` are always returned.
+ * @param count Pass "estimated" to include a planner-estimated total count.
+ * @returns A promise that resolves to the page of projects records and the next cursor.
+ * @throws Error if the cursor is malformed.
+ * @example
+ * const { data, nextCursor, error } = await listProjectsByCursor({ supabase, organization_id: 'org-uuid', columns: ['name'], limit: 25 });
+ * const nextPage = await listProjectsByCursor({ supabase, cursor: nextCursor });
+ */
+export const listProjectsByCursor = async <
+  K extends keyof Project = keyof Project,
+>({
+  supabase,
+  organization_id,
+  cursor,
+  limit,
+  columns,
+  count,
+}: {
+  supabase: SupabaseClient<Database>;
+  organization_id?: string;
+} & CursorPageOptions<K>): Promise<
+  CursorPageResponse<Pick<Project, K | CursorColumns>>
+> => {
+  const pageSize = clampLimit(limit);
+  let query = supabase
+    .from("projects")
+    .select(buildProjection(columns), { count });
+  if (organization_id) {
+    query = query.eq("organization_id", organization_id);
+  }
+  if (cursor) {
+    query = query.or(buildKeysetFilter(decodeCursor(cursor)));
+  }
+  const result = await query
+    .order("created_at", { ascending: false })
+    .order("id", { ascending: false })
+    .limit(pageSize + 1);
+  return toCursorPage(
+    result as unknown as {
+      data: Pick<Project, K | CursorColumns>[] | null;
+      error: PostgrestError | null;
+      count: number | null;
+    },
+    pageSize,
+  );
+};
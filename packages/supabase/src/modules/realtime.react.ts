@@ -0,0 +1,219 @@
+import { useEffect } from "react";
+import {
+  notifyManager,
+  QueryClient,
+  useQueryClient,
+} from "@tanstack/react-query";
+import {
+  RealtimePostgresChangesPayload,
+  SupabaseClient,
+} from "@supabase/supabase-js";
+import { Database } from "../types/database.types";
+import {
+  CachedRow,
+  insertRowIntoCaches,
+  markListsStale,
+  patchRowInCaches,
+  removeRowFromCaches,
+} from "../utils/query-cache";
+
+/** Tables whose rows are cached by the module hooks and patched in place. */
+const ROW_TABLES = ["projects", "organizations", "profiles"] as const;
+
+/**
+ * Membership tables are not cached directly, but a change alters which rows
+ * RLS lets the user see, so the affected lists are marked stale instead.
+ */
+const MEMBERSHIP_TABLES = {
+  organization_members: ["organizations", "projects"],
+  project_members: ["projects"],
+} as const;
+
+type RowTable = (typeof ROW_TABLES)[number];
+type MembershipTable = keyof typeof MEMBERSHIP_TABLES;
+
+type RowChange = {
+  table: RowTable;
+  eventType: "INSERT" | "UPDATE" | "DELETE";
+  row: CachedRow;
+};
+
+export interface RealtimeCacheSyncOptions {
+  supabase: SupabaseClient<Database>;
+  queryClient: QueryClient;
+  /** Realtime channel name (default: "query-cache-sync"). */
+  channelName?: string;
+  /** Schedules a flush of queued changes (default: next animation frame). */
+  schedule?: (flush: () => void) => void;
+}
+
+type ActiveSync = { refs: number; stop: () => void };
+
+// One channel per Supabase client, shared by every caller.
+const activeSyncs = new WeakMap<SupabaseClient<Database>, ActiveSync>();
+
+const defaultSchedule = (flush: () => void) => {
+  if (typeof requestAnimationFrame === "function") {
+    requestAnimationFrame(() => flush());
+  } else {
+    setTimeout(flush, 16);
+  }
+};
+
+const startSync = ({
+  supabase,
+  queryClient,
+  channelName = "query-cache-sync",
+  schedule = defaultSchedule,
+}: RealtimeCacheSyncOptions): (() => void) => {
+  // Changes are coalesced per row so a burst of updates becomes one write.
+  let rowChanges = new Map<string, RowChange>();
+  let staleTables = new Set<RowTable>();
+  let scheduled = false;
+  let hasConnected = false;
+
+  const flush = () => {
+    const changes = rowChanges;
+    const tables = staleTables;
+    rowChanges = new Map();
+    staleTables = new Set();
+    scheduled = false;
+
+    notifyManager.batch(() => {
+      changes.forEach(({ table, eventType, row }) => {
+        if (eventType === "DELETE") {
+          removeRowFromCaches(queryClient, table, row.id);
+        } else if (eventType === "INSERT") {
+          insertRowIntoCaches(queryClient, table, row);
+        } else {
+          patchRowInCaches(queryClient, table, row);
+        }
+      });
+      tables.forEach((table) => markListsStale(queryClient, table));
+    });
+  };
+
+  const enqueue = () => {
+    if (scheduled) return;
+    scheduled = true;
+    schedule(flush);
+  };
+
+  const onRowChange =
+    (table: RowTable) =>
+    (payload: RealtimePostgresChangesPayload<CachedRow>) => {
+      const row = (
+        payload.eventType === "DELETE" ? payload.old : payload.new
+      ) as CachedRow;
+      if (!row?.id) return;
+
+      const key = `${table}:${row.id}`;
+      const previous = rowChanges.get(key);
+      // An insert followed by updates in the same frame is still an insert.
+      const eventType =
+        previous?.eventType === "INSERT" && payload.eventType === "UPDATE"
+          ? "INSERT"
+          : payload.eventType;
+      rowChanges.set(key, { table, eventType, row });
+      enqueue();
+    };
+
+  const onMembershipChange = (table: MembershipTable) => () => {
+    MEMBERSHIP_TABLES[table].forEach((affected) => staleTables.add(affected));
+    enqueue();
+  };
+
+  const channel = supabase.channel(channelName);
+
+  ROW_TABLES.forEach((table) => {
+    channel.on<CachedRow>(
+      "postgres_changes",
+      { event: "*", schema: "public", table },
+      onRowChange(table),
+    );
+  });
+
+  (Object.keys(MEMBERSHIP_TABLES) as MembershipTable[]).forEach((table) => {
+    channel.on(
+      "postgres_changes",
+      { event: "*", schema: "public", table },
+      onMembershipChange(table),
+    );
+  });
+
+  channel.subscribe((status) => {
+    if (status !== "SUBSCRIBED") return;
+    // Changes made while disconnected were never delivered: resync once.
+    if (hasConnected) {
+      ROW_TABLES.forEach((table) =>
+        queryClient.invalidateQueries({ queryKey: [table] }),
+      );
+    }
+    hasConnected = true;
+  });
+
+  return () => {
+    void supabase.removeChannel(channel);
+  };
+};
+
+/**
+ * Keeps React Query caches in sync with database changes via Supabase Realtime.
+ * Inserts, updates and deletes on projects, organizations and profiles are
+ * patched directly into the matching detail (`[table, id]`) and list
+ * (`[table, { ...filters }]`) caches, batched per animation frame. Membership
+ * changes mark the affected lists stale. A broad refetch only happens after
+ * the channel reconnects.
+ *
+ * Only one channel is opened per Supabase client; repeated calls share it.
+ * @param options Options including the Supabase and React Query clients.
+ * @returns A function that releases this subscription.
+ * @example
+ * const release = createRealtimeCacheSync({ supabase, queryClient });
+ * // ...later
+ * release();
+ */
+export const createRealtimeCacheSync = (
+  options: RealtimeCacheSyncOptions,
+): (() => void) => {
+  const { supabase } = options;
+  let sync = activeSyncs.get(supabase);
+  if (!sync) {
+    sync = { refs: 0, stop: startSync(options) };
+    activeSyncs.set(supabase, sync);
+  }
+  sync.refs += 1;
+
+  let released = false;
+  return () => {
+    if (released || !sync) return;
+    released = true;
+    sync.refs -= 1;
+    if (sync.refs === 0) {
+      sync.stop();
+      activeSyncs.delete(supabase);
+    }
+  };
+};
+
+/**
+ * React binding for `createRealtimeCacheSync`, using the nearest QueryClient.
+ * Mount it once near the root of the authenticated app.
+ * @param options Options including the Supabase client.
+ * @param options.supabase The Supabase client instance.
+ * @param options.enabled Set to false to skip subscribing (e.g. signed out).
+ * @example
+ * useRealtimeCacheSync({ supabase, enabled: !!user });
+ */
+export const useRealtimeCacheSync = (options: {
+  supabase: SupabaseClient<Database>;
+  enabled?: boolean;
+}): void => {
+  const { supabase, enabled = true } = options;
+  const queryClient = useQueryClient();
+
+  useEffect(() => {
+    if (!enabled || !supabase) return;
+    return createRealtimeCacheSync({ supabase, queryClient });
+  }, [supabase, queryClient, enabled]);
+};
@@ -0,0 +1,151 @@
+import {
+  SupabaseClient,
+  PostgrestSingleResponse,
+  PostgrestError,
+} from "@supabase/supabase-js";
+import { Database, Json, Tables } from "../types/database.types";
+
+// Define table-specific types
+export type StripeProductRow = Tables<"stripe_products">;
+export type StripePriceRow = Tables<"stripe_prices">;
+
+/** Mirror rows as written by the backend; `synced_at` is set by the database. */
+export type StripeProductSync = Omit<StripeProductRow, "synced_at">;
+export type StripePriceSync = Omit<StripePriceRow, "synced_at">;
+
+/**
+ * An active product with its active prices, as read from the catalog mirror.
+ */
+export type StripeCatalogProduct = StripeProductRow & {
+  prices: StripePriceRow[];
+};
+
+/**
+ * Fetches the active catalog from the local Stripe mirror: active products
+ * (oldest first, matching the Stripe dashboard order) with their active
+ * prices. The catalog is public, so an anonymous client is enough.
+ * @param supabase The Supabase client instance.
+ * @returns A promise that resolves to the active products with their prices.
+ * @example
+ * const { data: products, error } = await fetchStripeCatalog({ supabase });
+ */
+export const fetchStripeCatalog = async ({
+  supabase,
+}: {
+  supabase: SupabaseClient<Database>;
+}): Promise<PostgrestSingleResponse<StripeCatalogProduct[]>> => {
+  const products = await supabase
+    .from("stripe_products")
+    .select("*")
+    .eq("active", true)
+    .order("created_at", { ascending: true });
+  if (products.error) return products;
+
+  const productIds = products.data.map((product) => product.id);
+  const prices = await supabase
+    .from("stripe_prices")
+    .select("*")
+    .eq("active", true)
+    .in("product_id", productIds)
+    .order("unit_amount", { ascending: true, nullsFirst: false });
+  if (prices.error) return prices;
+
+  const pricesByProduct = new Map<string, StripePriceRow[]>();
+  prices.data.forEach((price) => {
+    const list = pricesByProduct.get(price.product_id) ?? [];
+    list.push(price);
+    pricesByProduct.set(price.product_id, list);
+  });
+
+  return {
+    ...products,
+    data: products.data.map((product) => ({
+      ...product,
+      prices: pricesByProduct.get(product.id) ?? [],
+    })),
+  };
+};
+
+/**
+ * Upserts products into the mirror. Rows older than the stored version (by
+ * `last_event_at`) are skipped, so out-of-order webhooks cannot regress data,
+ * and a tombstone (`deleted`) is never written over. Requires a service-role
+ * client.
+ * @param supabase A Supabase client authenticated with the service role key.
+ * @param products The product rows to write.
+ * @returns A promise that resolves to the number of rows written.
+ */
+export const upsertStripeProducts = async ({
+  supabase,
+  products,
+}: {
+  supabase: SupabaseClient<Database>;
+  products: readonly StripeProductSync[];
+}): Promise<PostgrestSingleResponse<number>> => {
+  return supabase.rpc("upsert_stripe_products", {
+    products: products as unknown as Json,
+  });
+};
+
+/**
+ * Upserts prices into the mirror. Rows older than the stored version (by
+ * `last_event_at`) are skipped. Requires a service-role client.
+ * @param supabase A Supabase client authenticated with the service role key.
+ * @param prices The price rows to write.
+ * @returns A promise that resolves to the number of rows written.
+ */
+export const upsertStripePrices = async ({
+  supabase,
+  prices,
+}: {
+  supabase: SupabaseClient<Database>;
+  prices: readonly StripePriceSync[];
+}): Promise<PostgrestSingleResponse<number>> => {
+  return supabase.rpc("upsert_stripe_prices", {
+    prices: prices as unknown as Json,
+  });
+};
+
+// How long tombstones of deleted objects are kept: longer than Stripe retries
+// webhook deliveries (3 days), so no late event can revive a deleted object.
+const TOMBSTONE_RETENTION_MS = 7 * 24 * 60 * 60 * 1000;
+
+/**
+ * Removes catalog rows whose data was last observed before `before`. A full
+ * sync writes every object with its start time as `last_event_at` and calls
+ * this afterwards to drop objects that no longer exist in Stripe; rows updated
+ * by webhooks during the sync are newer and kept. Tombstones of deleted
+ * objects are kept until TOMBSTONE_RETENTION_MS after their deletion.
+ * Requires a service-role client.
+ * @param supabase A Supabase client authenticated with the service role key.
+ * @param before ISO timestamp; rows last observed earlier are deleted.
+ * @returns The number of products and prices removed, or the first error.
+ */
+export const deleteStaleStripeCatalog = async ({
+  supabase,
+  before,
+}: {
+  supabase: SupabaseClient<Database>;
+  before: string;
+}): Promise<{
+  data: { products: number; prices: number } | null;
+  error: PostgrestError | null;
+}> => {
+  const expired = new Date(
+    Math.min(Date.parse(before), Date.now() - TOMBSTONE_RETENTION_MS),
+  ).toISOString();
+  // Live rows older than the sync, or tombstones past their retention
+  const stale =
+    `and(deleted.eq.false,last_event_at.lt."${before}"),` +
+    `last_event_at.lt."${expired}"`;
+  const [products, prices] = await Promise.all([
+    supabase.from("stripe_products").delete({ count: "exact" }).or(stale),
+    supabase.from("stripe_prices").delete({ count: "exact" }).or(stale),
+  ]);
+  const error = products.error ?? prices.error;
+  if (error) return { data: null, error };
+  return {
+    data: { products: products.count ?? 0, prices: prices.count ?? 0 },
+    error: null,
+  };
+};
@@ -0,0 +1,77 @@
+import {
+  SupabaseClient,
+  PostgrestSingleResponse,
+} from "@supabase/supabase-js";
+import { Database, Tables } from "../types/database.types";
+
+// Define table-specific types
+export type StripeCustomer = Tables<"stripe_customers">;
+
+/**
+ * Fetches the Stripe customer linked to a profile, if any. After the linked
+ * customer was deleted the row remains with a null `stripe_customer_id` and a
+ * bumped `generation`.
+ * @param supabase The Supabase client instance.
+ * @param profileId The profile whose customer to fetch.
+ * @returns A promise that resolves to the mapping, or null when none exists.
+ * @example
+ * const { data } = await fetchStripeCustomer({ supabase, profileId: user.id });
+ * const customerId = data?.stripe_customer_id;
+ */
+export const fetchStripeCustomer = async ({
+  supabase,
+  profileId,
+}: {
+  supabase: SupabaseClient<Database>;
+  profileId: string;
+}): Promise<PostgrestSingleResponse<StripeCustomer | null>> => {
+  return supabase
+    .from("stripe_customers")
+    .select("*")
+    .eq("profile_id", profileId)
+    .maybeSingle();
+};
+
+/**
+ * Links a profile to a Stripe customer unless it is already linked. The first
+ * link wins, so concurrent callers all get the same customer id back.
+ * Requires a service-role client.
+ * @param supabase A Supabase client authenticated with the service role key.
+ * @param profileId The profile to link.
+ * @param customerId The Stripe customer id.
+ * @returns A promise that resolves to the customer id now linked to the
+ * profile (which may differ from `customerId`).
+ */
+export const linkStripeCustomer = async ({
+  supabase,
+  profileId,
+  customerId,
+}: {
+  supabase: SupabaseClient<Database>;
+  profileId: string;
+  customerId: string;
+}): Promise<PostgrestSingleResponse<string>> => {
+  return supabase.rpc("link_stripe_customer", {
+    profile: profileId,
+    customer: customerId,
+  });
+};
+
+/**
+ * Removes the link to a Stripe customer after the customer was deleted in
+ * Stripe, and bumps the profile's `generation` so the next customer is
+ * created with a new idempotency key. Unlinking twice is a no-op. Requires a
+ * service-role client.
+ * @param supabase A Supabase client authenticated with the service role key.
+ * @param customerId The Stripe customer id.
+ * @returns A promise that resolves to the number of links removed (0 or 1).
+ */
+export const unlinkStripeCustomer = async ({
+  supabase,
+  customerId,
+}: {
+  supabase: SupabaseClient<Database>;
+  customerId: string;
+}): Promise<PostgrestSingleResponse<number>> => {
+  return supabase.rpc("unlink_stripe_customer", { customer: customerId });
+};
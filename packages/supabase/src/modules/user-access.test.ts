@@ -0,0 +1,143 @@
+import assert from "node:assert/strict";
+import { describe, it } from "node:test";
+import type { SupabaseClient } from "@supabase/supabase-js";
+import type { Database } from "../types/database.types";
+import {
+  fetchProjectAccess,
+  fetchUserAccess,
+  hasProjectAccess,
+  UserAccess,
+} from "./user-access";
+
+// PostgREST's `max_rows` (supabase/config.toml): longer results are cut off.
+const MAX_ROWS = 1000;
+
+const accessRow = (index: number): UserAccess => ({
+  profile_id: "profile-1",
+  project_id: `project-${String(index).padStart(5, "0")}`,
+  organization_id: `org-${index % 7}`,
+  organization_role: index % 2 === 0 ? "member" : null,
+  project_role: index % 2 === 0 ? null : "viewer",
+  updated_at: "2025-01-01T00:00:00Z",
+});
+
+/**
+ * A stand-in for the `user_access` endpoint: applies `eq` filters, orders by
+ * project and caps every response at `MAX_ROWS`, like the real API.
+ */
+const createFakeClient = (rows: UserAccess[]) => {
+  const ranges: [number, number][] = [];
+
+  const query = () => {
+    const filters: [keyof UserAccess, unknown][] = [];
+    const matching = () =>
+      rows
+        .filter((row) =>
+          filters.every(([column, value]) => row[column] === value),
+        )
+        .sort((a, b) => a.project_id.localeCompare(b.project_id));
+
+    const builder = {
+      select: () => builder,
+      eq: (column: keyof UserAccess, value: unknown) => {
+        filters.push([column, value]);
+        return builder;
+      },
+      order: () => builder,
+      range: async (from: number, to: number) => {
+        ranges.push([from, to]);
+        const page = matching().slice(from, Math.min(to + 1, from + MAX_ROWS));
+        return { data: page, error: null };
+      },
+      maybeSingle: async () => ({ data: matching()[0] ?? null, error: null }),
+    };
+    return builder;
+  };
+
+  const supabase = { from: () => query() };
+  return {
+    supabase: supabase as unknown as SupabaseClient<Database>,
+    ranges,
+  };
+};
+
+describe("fetchUserAccess", () => {
+  it("returns every row when the user has more than max_rows projects", async () => {
+    const rows = Array.from({ length: 2500 }, (_, index) => accessRow(index));
+    const { supabase, ranges } = createFakeClient(rows);
+
+    const { data, error } = await fetchUserAccess({
+      supabase,
+      profileId: "profile-1",
+    });
+
+    assert.equal(error, null);
+    assert.equal(data?.length, 2500);
+    assert.equal(new Set(data?.map((row) => row.project_id)).size, 2500);
+    assert.deepEqual(ranges, [
+      [0, 999],
+      [1000, 1999],
+      [2000, 2999],
+    ]);
+  });
+
+  it("reads one extra empty page when the set is a multiple of the page size", async () => {
+    const rows = Array.from({ length: 2000 }, (_, index) => accessRow(index));
+    const { supabase, ranges } = createFakeClient(rows);
+
+    const { data } = await fetchUserAccess({ supabase, profileId: "profile-1" });
+
+    assert.equal(data?.length, 2000);
+    assert.equal(ranges.length, 3);
+  });
+
+  it("returns the error of a failed page", async () => {
+    const error = { message: "boom", details: "", hint: "", code: "500" };
+    const supabase = {
+      from: () => {
+        const builder = {
+          select: () => builder,
+          eq: () => builder,
+          order: () => builder,
+          range: async () => ({ data: null, error }),
+        };
+        return builder;
+      },
+    } as unknown as SupabaseClient<Database>;
+
+    const result = await fetchUserAccess({ supabase, profileId: "profile-1" });
+
+    assert.equal(result.data, null);
+    assert.equal(result.error, error);
+  });
+});
+
+describe("fetchProjectAccess", () => {
+  it("finds a project past the first max_rows rows", async () => {
+    const rows = Array.from({ length: 2500 }, (_, index) => accessRow(index));
+    const { supabase } = createFakeClient(rows);
+
+    const { data } = await fetchProjectAccess({
+      supabase,
+      profileId: "profile-1",
+      projectId: "project-02345",
+    });
+
+    assert.equal(data?.project_id, "project-02345");
+    assert.equal(hasProjectAccess(data, ["viewer"]), true);
+    assert.equal(hasProjectAccess(data, ["owner"]), false);
+  });
+
+  it("returns null without access", async () => {
+    const { supabase } = createFakeClient([accessRow(1)]);
+
+    const { data } = await fetchProjectAccess({
+      supabase,
+      profileId: "profile-1",
+      projectId: "project-99999",
+    });
+
+    assert.equal(data, null);
+    assert.equal(hasProjectAccess(data), false);
+  });
+});
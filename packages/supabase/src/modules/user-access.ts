@@ -0,0 +1,149 @@
+import {
+  PostgrestError,
+  PostgrestSingleResponse,
+  SupabaseClient,
+} from "@supabase/supabase-js";
+import { Database, Tables } from "../types/database.types";
+
+// Define table-specific types
+export type UserAccess = Tables<"user_access">;
+
+/**
+ * Rows per request when reading a whole access set. Must not exceed the
+ * API's `max_rows` (1000, see supabase/config.toml): a page cut short by the
+ * server would look like the last one.
+ */
+export const USER_ACCESS_PAGE_SIZE = 1000;
+
+/**
+ * A user's access set, indexed for constant-time permission checks.
+ */
+export interface UserAccessSet {
+  profileId: string;
+  /** Access rows keyed by project id. */
+  projects: ReadonlyMap<string, UserAccess>;
+  /** Organization roles keyed by organization id, for orgs with any project. */
+  organizations: ReadonlyMap<string, string>;
+}
+
+/**
+ * Fetches every project a user can access, with the roles granting access,
+ * from the trigger-maintained `user_access` table. Indexed range scans
+ * replace joining both membership tables; the set is read in pages of
+ * `pageSize` rows ordered by project, so users with more projects than the
+ * API's `max_rows` get all of them.
+ * A user-scoped client only sees its own rows; pass a service-role client to
+ * read another user's access. To check a single project, use
+ * `fetchProjectAccess` instead.
+ * @param supabase The Supabase client instance.
+ * @param profileId The profile whose access to fetch.
+ * @param pageSize Rows per request (default: 1000, at most `max_rows`).
+ * @returns A promise that resolves to every access row of the user.
+ * @example
+ * const { data, error } = await fetchUserAccess({ supabase, profileId: user.id });
+ */
+export const fetchUserAccess = async ({
+  supabase,
+  profileId,
+  pageSize = USER_ACCESS_PAGE_SIZE,
+}: {
+  supabase: SupabaseClient<Database>;
+  profileId: string;
+  pageSize?: number;
+}): Promise<{ data: UserAccess[] | null; error: PostgrestError | null }> => {
+  const rows: UserAccess[] = [];
+  for (let from = 0; ; from += pageSize) {
+    const { data, error } = await supabase
+      .from("user_access")
+      .select("*")
+      .eq("profile_id", profileId)
+      .order("project_id")
+      .range(from, from + pageSize - 1);
+    if (error) return { data: null, error };
+    rows.push(...data);
+    if (data.length < pageSize) return { data: rows, error: null };
+  }
+};
+
+/**
+ * Fetches a user's access row for one project by primary key, for single
+ * permission checks that do not need the whole access set.
+ * @param supabase The Supabase client instance.
+ * @param profileId The profile whose access to check.
+ * @param projectId The project to check.
+ * @returns A promise that resolves to the access row, or null without access.
+ * @example
+ * const { data: row } = await fetchProjectAccess({ supabase, profileId, projectId });
+ * if (!hasProjectAccess(row, ["owner", "admin"])) throw new Error("Forbidden");
+ */
+export const fetchProjectAccess = async ({
+  supabase,
+  profileId,
+  projectId,
+}: {
+  supabase: SupabaseClient<Database>;
+  profileId: string;
+  projectId: string;
+}): Promise<PostgrestSingleResponse<UserAccess | null>> => {
+  return supabase
+    .from("user_access")
+    .select("*")
+    .eq("profile_id", profileId)
+    .eq("project_id", projectId)
+    .maybeSingle();
+};
+
+/**
+ * Indexes access rows for repeated permission checks.
+ * @param profileId The profile the rows belong to.
+ * @param rows The rows returned by `fetchUserAccess`.
+ * @returns The indexed access set.
+ */
+export const toUserAccessSet = (
+  profileId: string,
+  rows: readonly UserAccess[],
+): UserAccessSet => {
+  const projects = new Map<string, UserAccess>();
+  const organizations = new Map<string, string>();
+  rows.forEach((row) => {
+    projects.set(row.project_id, row);
+    if (row.organization_role) {
+      organizations.set(row.organization_id, row.organization_role);
+    }
+  });
+  return { profileId, projects, organizations };
+};
+
+/**
+ * Returns true when an access row exists and, if roles are given, grants one
+ * of them (organization or project role).
+ * @param row The access row, or null/undefined when there is none.
+ * @param roles Roles that satisfy the check; any role when omitted.
+ */
+export const hasProjectAccess = (
+  row: UserAccess | null | undefined,
+  roles?: readonly string[],
+): boolean => {
+  if (!row) return false;
+  if (!roles) return true;
+  return [row.organization_role, row.project_role].some(
+    (role) => role !== null && roles.includes(role),
+  );
+};
+
+/**
+ * Returns true when the access set grants access to the project, optionally
+ * requiring one of the given roles (organization or project role).
+ * @param access The user's access set.
+ * @param projectId The project to check.
+ * @param roles Roles that satisfy the check; any role when omitted.
+ * @example
+ * if (!canAccessProject(access, projectId, ["owner", "admin", "editor"])) {
+ *   return c.json({ error: "Forbidden" }, 403);
+ * }
+ */
+export const canAccessProject = (
+  access: UserAccessSet,
+  projectId: string,
+  roles?: readonly string[],
+): boolean => hasProjectAccess(access.projects.get(projectId), roles);
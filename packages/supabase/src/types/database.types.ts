@@ -34,6 +34,122 @@ export type Database = {
   };
   public: {
     Tables: {
+      entitlements: {
+        Row: {
+          cancel_at_period_end: boolean;
+          current_period_end: string | null;
+          features: string[];
+          last_event_at: string;
+          last_event_id: string | null;
+          organization_id: string | null;
+          plans: string[];
+          price_ids: string[];
+          product_ids: string[];
+          profile_id: string | null;
+          status: string;
+          stripe_customer_id: string;
+          stripe_subscription_id: string;
+          updated_at: string;
+        };
+        Insert: {
+          cancel_at_period_end?: boolean;
+          current_period_end?: string | null;
+          features?: string[];
+          last_event_at: string;
+          last_event_id?: string | null;
+          organization_id?: string | null;
+          plans?: string[];
+          price_ids?: string[];
+          product_ids?: string[];
+          profile_id?: string | null;
+          status: string;
+          stripe_customer_id: string;
+          stripe_subscription_id: string;
+          updated_at?: string;
+        };
+        Update: {
+          cancel_at_period_end?: boolean;
+          current_period_end?: string | null;
+          features?: string[];
+          last_event_at?: string;
+          last_event_id?: string | null;
+          organization_id?: string | null;
+          plans?: string[];
+          price_ids?: string[];
+          product_ids?: string[];
+          profile_id?: string | null;
+          status?: string;
+          stripe_customer_id?: string;
+          stripe_subscription_id?: string;
+          updated_at?: string;
+        };
+        Relationships: [
+          {
+            foreignKeyName: "entitlements_organization_id_fkey";
+            columns: ["organization_id"];
+            isOneToOne: false;
+            referencedRelation: "organizations";
+            referencedColumns: ["id"];
+          },
+          {
+            foreignKeyName: "entitlements_profile_id_fkey";
+            columns: ["profile_id"];
+            isOneToOne: false;
+            referencedRelation: "profiles";
+            referencedColumns: ["id"];
+          },
+        ];
+      };
+      invitations: {
+        Row: {
+          created_at: string;
+          expires_at: string | null;
+          id: string;
+          invitee_email: string;
+          inviter_id: string;
+          role: string;
+          status: Database["public"]["Enums"]["invitation_status"];
+          target_id: string;
+          target_type: Database["public"]["Enums"]["invitation_target_type"];
+          token: string;
+          updated_at: string;
+        };
+        Insert: {
+          created_at?: string;
+          expires_at?: string | null;
+          id?: string;
+          invitee_email: string;
+          inviter_id: string;
+          role: string;
+          status?: Database["public"]["Enums"]["invitation_status"];
+          target_id: string;
+          target_type: Database["public"]["Enums"]["invitation_target_type"];
+          token?: string;
+          updated_at?: string;
+        };
+        Update: {
+          created_at?: string;
+          expires_at?: string | null;
+          id?: string;
+          invitee_email?: string;
+          inviter_id?: string;
+          role?: string;
+          status?: Database["public"]["Enums"]["invitation_status"];
+          target_id?: string;
+          target_type?: Database["public"]["Enums"]["invitation_target_type"];
+          token?: string;
+          updated_at?: string;
+        };
+        Relationships: [
+          {
+            foreignKeyName: "invitations_inviter_id_fkey";
+            columns: ["inviter_id"];
+            isOneToOne: false;
+            referencedRelation: "profiles";
+            referencedColumns: ["id"];
+          },
+        ];
+      };
       organization_members: {
         Row: {
           created_at: string;
@@ -200,15 +316,400 @@ export type Database = {
           },
         ];
       };
+      stripe_customers: {
+        Row: {
+          created_at: string;
+          generation: number;
+          profile_id: string;
+          stripe_customer_id: string | null;
+        };
+        Insert: {
+          created_at?: string;
+          generation?: number;
+          profile_id: string;
+          stripe_customer_id?: string | null;
+        };
+        Update: {
+          created_at?: string;
+          generation?: number;
+          profile_id?: string;
+          stripe_customer_id?: string | null;
+        };
+        Relationships: [
+          {
+            foreignKeyName: "stripe_customers_profile_id_fkey";
+            columns: ["profile_id"];
+            isOneToOne: true;
+            referencedRelation: "profiles";
+            referencedColumns: ["id"];
+          },
+        ];
+      };
+      stripe_prices: {
+        Row: {
+          active: boolean;
+          created_at: string;
+          currency: string;
+          deleted: boolean;
+          id: string;
+          last_event_at: string;
+          livemode: boolean;
+          lookup_key: string | null;
+          metadata: Json;
+          nickname: string | null;
+          product_id: string;
+          recurring_interval: string | null;
+          recurring_interval_count: number | null;
+          synced_at: string;
+          type: string;
+          unit_amount: number | null;
+        };
+        Insert: {
+          active: boolean;
+          created_at: string;
+          currency: string;
+          deleted?: boolean;
+          id: string;
+          last_event_at: string;
+          livemode: boolean;
+          lookup_key?: string | null;
+          metadata?: Json;
+          nickname?: string | null;
+          product_id: string;
+          recurring_interval?: string | null;
+          recurring_interval_count?: number | null;
+          synced_at?: string;
+          type: string;
+          unit_amount?: number | null;
+        };
+        Update: {
+          active?: boolean;
+          created_at?: string;
+          currency?: string;
+          deleted?: boolean;
+          id?: string;
+          last_event_at?: string;
+          livemode?: boolean;
+          lookup_key?: string | null;
+          metadata?: Json;
+          nickname?: string | null;
+          product_id?: string;
+          recurring_interval?: string | null;
+          recurring_interval_count?: number | null;
+          synced_at?: string;
+          type?: string;
+          unit_amount?: number | null;
+        };
+        Relationships: [];
+      };
+      stripe_products: {
+        Row: {
+          active: boolean;
+          created_at: string;
+          default_price_id: string | null;
+          deleted: boolean;
+          description: string | null;
+          id: string;
+          images: string[];
+          last_event_at: string;
+          livemode: boolean;
+          marketing_features: Json;
+          metadata: Json;
+          name: string;
+          synced_at: string;
+        };
+        Insert: {
+          active: boolean;
+          created_at: string;
+          default_price_id?: string | null;
+          deleted?: boolean;
+          description?: string | null;
+          id: string;
+          images?: string[];
+          last_event_at: string;
+          livemode: boolean;
+          marketing_features?: Json;
+          metadata?: Json;
+          name: string;
+          synced_at?: string;
+        };
+        Update: {
+          active?: boolean;
+          created_at?: string;
+          default_price_id?: string | null;
+          deleted?: boolean;
+          description?: string | null;
+          id?: string;
+          images?: string[];
+          last_event_at?: string;
+          livemode?: boolean;
+          marketing_features?: Json;
+          metadata?: Json;
+          name?: string;
+          synced_at?: string;
+        };
+        Relationships: [];
+      };
+      user_access: {
+        Row: {
+          organization_id: string;
+          organization_role: string | null;
+          profile_id: string;
+          project_id: string;
+          project_role: string | null;
+          updated_at: string;
+        };
+        Insert: {
+          organization_id: string;
+          organization_role?: string | null;
+          profile_id: string;
+          project_id: string;
+          project_role?: string | null;
+          updated_at?: string;
+        };
+        Update: {
+          organization_id?: string;
+          organization_role?: string | null;
+          profile_id?: string;
+          project_id?: string;
+          project_role?: string | null;
+          updated_at?: string;
+        };
+        Relationships: [
+          {
+            foreignKeyName: "user_access_organization_id_fkey";
+            columns: ["organization_id"];
+            isOneToOne: false;
+            referencedRelation: "organizations";
+            referencedColumns: ["id"];
+          },
+          {
+            foreignKeyName: "user_access_profile_id_fkey";
+            columns: ["profile_id"];
+            isOneToOne: false;
+            referencedRelation: "profiles";
+            referencedColumns: ["id"];
+          },
+          {
+            foreignKeyName: "user_access_project_id_fkey";
+            columns: ["project_id"];
+            isOneToOne: false;
+            referencedRelation: "projects";
+            referencedColumns: ["id"];
+          },
+        ];
+      };
     };
     Views: {
       [_ in never]: never;
     };
     Functions: {
-      [_ in never]: never;
+      accept_all_invitations: {
+        Args: Record<PropertyKey, never>;
+        Returns: Json;
+      };
+      accept_invitation: {
+        Args: {
+          invitation_id: string;
+        };
+        Returns: Json;
+      };
+      assert_bulk_patch_keys: {
+        Args: {
+          allowed: string[];
+          patches: Json;
+        };
+        Returns: undefined;
+      };
+      bulk_update_organizations: {
+        Args: {
+          patches: Json;
+        };
+        Returns: {
+          created_at: string;
+          id: string;
+          name: string;
+          owner_id: string | null;
+          updated_at: string;
+        }[];
+      };
+      bulk_update_profiles: {
+        Args: {
+          patches: Json;
+        };
+        Returns: {
+          avatar_url: string | null;
+          created_at: string;
+          full_name: string | null;
+          id: string;
+          updated_at: string;
+          username: string | null;
+        }[];
+      };
+      bulk_update_projects: {
+        Args: {
+          patches: Json;
+        };
+        Returns: {
+          created_at: string;
+          description: string | null;
+          id: string;
+          name: string;
+          organization_id: string;
+          updated_at: string;
+        }[];
+      };
+      create_invitations: {
+        Args: {
+          invitations: Json;
+        };
+        Returns: {
+          created_at: string;
+          expires_at: string | null;
+          id: string;
+          invitee_email: string;
+          inviter_id: string;
+          role: string;
+          status: Database["public"]["Enums"]["invitation_status"];
+          target_id: string;
+          target_type: Database["public"]["Enums"]["invitation_target_type"];
+          token: string;
+          updated_at: string;
+        }[];
+      };
+      decline_all_invitations: {
+        Args: Record<PropertyKey, never>;
+        Returns: Json;
+      };
+      decline_invitation: {
+        Args: {
+          invitation_id: string;
+        };
+        Returns: Json;
+      };
+      entitlements_for: {
+        Args: {
+          profile: string;
+        };
+        Returns: {
+          cancel_at_period_end: boolean;
+          current_period_end: string | null;
+          features: string[];
+          last_event_at: string;
+          last_event_id: string | null;
+          organization_id: string | null;
+          plans: string[];
+          price_ids: string[];
+          product_ids: string[];
+          profile_id: string | null;
+          status: string;
+          stripe_customer_id: string;
+          stripe_subscription_id: string;
+          updated_at: string;
+        }[];
+      };
+      expire_invitations: {
+        Args: Record<PropertyKey, never>;
+        Returns: number;
+      };
+      get_pending_invitations: {
+        Args: Record<PropertyKey, never>;
+        Returns: {
+          created_at: string;
+          expires_at: string | null;
+          id: string;
+          invitee_email: string;
+          inviter_id: string;
+          role: string;
+          status: Database["public"]["Enums"]["invitation_status"];
+          target_id: string;
+          target_type: Database["public"]["Enums"]["invitation_target_type"];
+          token: string;
+          updated_at: string;
+        }[];
+      };
+      is_org_member: {
+        Args: {
+          org_id: string;
+        };
+        Returns: boolean;
+      };
+      is_project_member: {
+        Args: {
+          project_id: string;
+        };
+        Returns: boolean;
+      };
+      link_stripe_customer: {
+        Args: {
+          profile: string;
+          customer: string;
+        };
+        Returns: string;
+      };
+      rebuild_user_access: {
+        Args: Record<PropertyKey, never>;
+        Returns: undefined;
+      };
+      unlink_stripe_customer: {
+        Args: {
+          customer: string;
+        };
+        Returns: number;
+      };
+      upsert_entitlement: {
+        Args: {
+          entitlement: Json;
+        };
+        Returns: {
+          cancel_at_period_end: boolean;
+          current_period_end: string | null;
+          features: string[];
+          last_event_at: string;
+          last_event_id: string | null;
+          organization_id: string | null;
+          plans: string[];
+          price_ids: string[];
+          product_ids: string[];
+          profile_id: string | null;
+          status: string;
+          stripe_customer_id: string;
+          stripe_subscription_id: string;
+          updated_at: string;
+        };
+      };
+      upsert_stripe_prices: {
+        Args: {
+          prices: Json;
+        };
+        Returns: number;
+      };
+      upsert_stripe_products: {
+        Args: {
+          products: Json;
+        };
+        Returns: number;
+      };
+      user_accessible_project_ids: {
+        Args: Record<PropertyKey, never>;
+        Returns: string[];
+      };
+      user_org_ids: {
+        Args: Record<PropertyKey, never>;
+        Returns: string[];
+      };
+      user_org_project_ids: {
+        Args: Record<PropertyKey, never>;
+        Returns: string[];
+      };
+      user_project_ids: {
+        Args: Record<PropertyKey, never>;
+        Returns: string[];
+      };
     };
     Enums: {
-      [_ in never]: never;
+      invitation_status: "pending" | "accepted" | "declined" | "expired";
+      invitation_target_type: "organization" | "project";
     };
     CompositeTypes: {
       [_ in never]: never;
@@ -326,6 +827,9 @@ export const Constants = {
     Enums: {},
   },
   public: {
-    Enums: {},
+    Enums: {
+      invitation_status: ["pending", "accepted", "declined", "expired"],
+      invitation_target_type: ["organization", "project"],
+    },
   },
 } as const;
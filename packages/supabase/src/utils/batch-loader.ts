@@ -0,0 +1,127 @@
+/**
+ * A DataLoader-style batching loader keyed by primary key.
+ * Calls to `load` made within the same tick are coalesced into a single
+ * `batchFn` call, duplicate keys are fetched once, and (optionally) results
+ * are cached for the lifetime of the loader.
+ */
+export interface BatchLoader<V> {
+  /** Loads a single record, resolving to null when it does not exist. */
+  load: (key: string) => Promise<V | null>;
+  /** Loads several records, preserving the order of `keys`. */
+  loadMany: (keys: readonly string[]) => Promise<(V | null)[]>;
+  /** Seeds the cache with a known value. No-op when caching is disabled. */
+  prime: (key: string, value: V) => void;
+  /** Clears a single cached key, or the whole cache when no key is given. */
+  clear: (key?: string) => void;
+}
+
+export interface BatchLoaderOptions<V> {
+  /** Fetches a batch of unique keys, returning the records found keyed by id. */
+  batchFn: (keys: string[]) => Promise<Map<string, V>>;
+  /** Maximum keys per `batchFn` call; larger batches are split (default: 100). */
+  maxBatchSize?: number;
+  /** Cache results for the lifetime of the loader (default: true). */
+  cache?: boolean;
+  /** Schedules the dispatch of a pending batch (default: next macrotask). */
+  schedule?: (dispatch: () => void) => void;
+}
+
+type PendingLoad<V> = {
+  resolve: (value: V | null) => void;
+  reject: (error: unknown) => void;
+};
+
+const defaultSchedule = (dispatch: () => void) => {
+  setTimeout(dispatch, 0);
+};
+
+/**
+ * Creates a batching loader. Create one loader per request (server) or per
+ * client (browser) so cached values never leak across users.
+ * @param options Loader options, including the batch fetch function.
+ * @returns A BatchLoader instance.
+ * @example
+ * const loader = createBatchLoader<Profile>({
+ *   batchFn: async (ids) => {
+ *     const { data, error } = await fetchProfilesByIds({ supabase, ids });
+ *     if (error) throw error;
+ *     return new Map(data.map((row) => [row.id, row]));
+ *   },
+ * });
+ * const [a, b] = await Promise.all([loader.load(idA), loader.load(idB)]); // one request
+ */
+export const createBatchLoader = <V>({
+  batchFn,
+  maxBatchSize = 100,
+  cache = true,
+  schedule = defaultSchedule,
+}: BatchLoaderOptions<V>): BatchLoader<V> => {
+  const cached = new Map<string, Promise<V | null>>();
+  let pending = new Map<string, PendingLoad<V>[]>();
+  let scheduled = false;
+
+  const dispatchChunk = async (
+    keys: string[],
+    waiters: Map<string, PendingLoad<V>[]>,
+  ) => {
+    try {
+      const results = await batchFn(keys);
+      keys.forEach((key) => {
+        const value = results.get(key) ?? null;
+        waiters.get(key)?.forEach(({ resolve }) => resolve(value));
+      });
+    } catch (error) {
+      keys.forEach((key) => {
+        if (cache) cached.delete(key);
+        waiters.get(key)?.forEach(({ reject }) => reject(error));
+      });
+    }
+  };
+
+  const dispatch = () => {
+    const batch = pending;
+    pending = new Map();
+    scheduled = false;
+
+    const keys = Array.from(batch.keys());
+    for (let i = 0; i < keys.length; i += maxBatchSize) {
+      void dispatchChunk(keys.slice(i, i + maxBatchSize), batch);
+    }
+  };
+
+  const load = (key: string): Promise<V | null> => {
+    const hit = cache ? cached.get(key) : undefined;
+    if (hit) return hit;
+
+    const promise = new Promise<V | null>((resolve, reject) => {
+      const waiters = pending.get(key);
+      if (waiters) {
+        waiters.push({ resolve, reject });
+      } else {
+        pending.set(key, [{ resolve, reject }]);
+      }
+    });
+
+    if (cache) cached.set(key, promise);
+    if (!scheduled) {
+      scheduled = true;
+      schedule(dispatch);
+    }
+    return promise;
+  };
+
+  return {
+    load,
+    loadMany: (keys) => Promise.all(keys.map(load)),
+    prime: (key, value) => {
+      if (cache && !cached.has(key)) cached.set(key, Promise.resolve(value));
+    },
+    clear: (key) => {
+      if (key === undefined) {
+        cached.clear();
+      } else {
+        cached.delete(key);
+      }
+    },
+  };
+};
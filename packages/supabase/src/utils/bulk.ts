@@ -0,0 +1,103 @@
+import { PostgrestError } from "@supabase/supabase-js";
+import { mapWithConcurrency } from "@maestro/utils";
+
+/** Rows per request for writes that send rows in the request body. */
+export const DEFAULT_BULK_ROWS_PER_REQUEST = 500;
+/** Ids per request for filters sent in the URL (`.in("id", ids)`). */
+export const DEFAULT_BULK_IDS_PER_REQUEST = 150;
+/** Chunks in flight at once. */
+export const DEFAULT_BULK_CONCURRENCY = 4;
+
+/**
+ * Options accepted by every bulk write helper.
+ */
+export interface BulkOptions {
+  /** Maximum items per request. Defaults depend on the operation. */
+  chunkSize?: number;
+  /** Maximum number of requests in flight at once (default: 4). */
+  concurrency?: number;
+}
+
+/**
+ * Response shape for bulk write helpers. Chunks are independent requests, so
+ * a failure in one chunk does not undo the chunks that succeeded.
+ */
+export interface BulkResponse<T, I> {
+  /** Rows returned by the chunks that succeeded. */
+  data: T[];
+  /** The first error encountered, or null when every chunk succeeded. */
+  error: PostgrestError | null;
+  /** Inputs of the chunks that failed, ready to be retried. */
+  failed: I[];
+}
+
+/**
+ * Splits items into consecutive chunks of at most `size` items.
+ * @param items The items to split.
+ * @param size The maximum chunk size.
+ * @returns The chunks, in order.
+ */
+export const chunk = <I>(items: readonly I[], size: number): I[][] => {
+  const step = Math.max(1, Math.floor(size));
+  const chunks: I[][] = [];
+  for (let i = 0; i < items.length; i += step) {
+    chunks.push(items.slice(i, i + step));
+  }
+  return chunks;
+};
+
+/**
+ * Runs a write in chunks with bounded concurrency and merges the results.
+ * @param items The inputs to write.
+ * @param write Performs the write for one chunk.
+ * @param options Chunk size and concurrency.
+ * @returns The merged response.
+ * @example
+ * const result = await runBulk(rows, (part) =>
+ *   supabase.from("projects").insert(part).select(),
+ * );
+ */
+export const runBulk = async <I, T>(
+  items: readonly I[],
+  write: (
+    part: I[],
+  ) => PromiseLike<{ data: T[] | null; error: PostgrestError | null }>,
+  {
+    chunkSize = DEFAULT_BULK_ROWS_PER_REQUEST,
+    concurrency = DEFAULT_BULK_CONCURRENCY,
+  }: BulkOptions = {},
+): Promise<BulkResponse<T, I>> => {
+  const parts = chunk(items, chunkSize);
+  const results = mapWithConcurrency(parts, concurrency, async (part) => ({
+    part,
+    ...(await write(part)),
+  }));
+
+  const response: BulkResponse<T, I> = { data: [], error: null, failed: [] };
+  for await (const { part, data, error } of results) {
+    if (error) {
+      response.error ??= error;
+      response.failed.push(...part);
+    } else if (data) {
+      response.data.push(...data);
+    }
+  }
+  return response;
+};
+
+/**
+ * Merges patches that target the same id (later patches win per column), so
+ * a set-based UPDATE sees exactly one patch per row.
+ * @param patches The patches, each carrying the row id.
+ * @returns One patch per id, in first-seen order.
+ */
+export const mergePatchesById = <P extends { id: string }>(
+  patches: readonly P[],
+): P[] => {
+  const merged = new Map<string, P>();
+  patches.forEach((patch) => {
+    const existing = merged.get(patch.id);
+    merged.set(patch.id, existing ? { ...existing, ...patch } : patch);
+  });
+  return Array.from(merged.values());
+};
@@ -0,0 +1,135 @@
+import { isListQueryKey, isNewerVersion } from "@maestro/utils";
+import { QueryClient } from "@tanstack/react-query";
+import {
+  CachedRow,
+  findRowInLists,
+  markListsStale,
+  patchRowInCaches,
+} from "./query-cache";
+
+/**
+ * What `applyOptimisticUpdate` replaced, passed back as mutation context so a
+ * failed update can be rolled back.
+ */
+export interface OptimisticSnapshot {
+  id: string;
+  /** Previous values of the patched columns, or null when they were not cached. */
+  previous: Record<string, unknown> | null;
+}
+
+/**
+ * Mutation key used by the optimistic update hooks of a table. Lets
+ * `reconcileServerRow` detect overlapping updates to the same row.
+ * @param table The table name.
+ * @returns The mutation key, e.g. `["projects", "update"]`.
+ */
+export const updateMutationKey = (table: string) => [table, "update"] as const;
+
+/**
+ * Applies an update to the cache before the server confirms it. In-flight
+ * fetches for the row and the table's lists are cancelled so they cannot
+ * overwrite the optimistic values, then the patch is written into the detail
+ * cache and every list that holds the row. Call from `onMutate`.
+ * @param queryClient The React Query client.
+ * @param table The table name used as the first query key element.
+ * @param id The id of the row being updated.
+ * @param patch The columns being changed.
+ * @returns A snapshot to pass to `rollbackOptimisticUpdate` on error.
+ * @example
+ * onMutate: ({ id, updateData }) =>
+ *   applyOptimisticUpdate(queryClient, "projects", id, updateData),
+ */
+export const applyOptimisticUpdate = async (
+  queryClient: QueryClient,
+  table: string,
+  id: string,
+  patch: Record<string, unknown>,
+): Promise<OptimisticSnapshot> => {
+  await queryClient.cancelQueries({
+    queryKey: [table],
+    predicate: (query) =>
+      query.queryKey[1] === id || isListQueryKey(query.queryKey),
+  });
+
+  const changes = Object.fromEntries(
+    Object.entries(patch).filter(([, value]) => value !== undefined),
+  );
+  const cached =
+    queryClient.getQueryData<CachedRow>([table, id]) ??
+    findRowInLists<CachedRow>(queryClient, table, id);
+  const keys = Object.keys(changes);
+  const previous =
+    cached && keys.every((key) => key in cached)
+      ? Object.fromEntries(keys.map((key) => [key, cached[key]]))
+      : null;
+
+  patchRowInCaches(queryClient, table, { ...changes, id });
+  return { id, previous };
+};
+
+/**
+ * Reverts an optimistic update after the mutation failed. Only the patched
+ * columns are restored, so changes to other rows that arrived meanwhile (e.g.
+ * via realtime) are kept. When the previous values were unknown, the row and
+ * the table's lists are refetched instead. Call from `onError`.
+ * @param queryClient The React Query client.
+ * @param table The table name used as the first query key element.
+ * @param snapshot The snapshot returned by `applyOptimisticUpdate`.
+ */
+export const rollbackOptimisticUpdate = (
+  queryClient: QueryClient,
+  table: string,
+  snapshot: OptimisticSnapshot | undefined,
+): void => {
+  if (!snapshot) return;
+  if (snapshot.previous) {
+    patchRowInCaches(queryClient, table, {
+      ...snapshot.previous,
+      id: snapshot.id,
+    });
+    return;
+  }
+  void queryClient.invalidateQueries({
+    queryKey: [table, snapshot.id],
+    exact: true,
+  });
+  void markListsStale(queryClient, table);
+};
+
+/**
+ * Writes the row returned by the server into the caches once an update has
+ * settled. Conflicts are resolved the same way for every table:
+ * - while a later update to the same row is still pending, its optimistic
+ *   values are kept and that mutation reconciles when it settles;
+ * - if the cache already holds a newer version of the row (by `updated_at`,
+ *   e.g. delivered by realtime), it is kept;
+ * - otherwise the server row wins.
+ * @param queryClient The React Query client.
+ * @param table The table name used as the first query key element.
+ * @param row The row returned by the update.
+ * @example
+ * onSettled: (data) => {
+ *   if (data) reconcileServerRow(queryClient, "projects", data);
+ * },
+ */
+export const reconcileServerRow = (
+  queryClient: QueryClient,
+  table: string,
+  row: CachedRow,
+): void => {
+  // The settling mutation still counts as pending while its callbacks run.
+  const pending = queryClient.isMutating({
+    mutationKey: updateMutationKey(table),
+    predicate: (mutation) =>
+      (mutation.state.variables as { id?: string } | undefined)?.id === row.id,
+  });
+  if (pending > 1) return;
+
+  const cached =
+    queryClient.getQueryData<CachedRow>([table, row.id]) ??
+    findRowInLists<CachedRow>(queryClient, table, row.id);
+  if (isNewerVersion(cached, row)) return;
+
+  patchRowInCaches(queryClient, table, row);
+  queryClient.setQueryData([table, row.id], row);
+};
@@ -0,0 +1,56 @@
+import assert from "node:assert/strict";
+import { describe, it } from "node:test";
+import { buildKeysetFilter, decodeCursor, encodeCursor } from "./pagination";
+
+const ID = "3f2b8c1e-9a4d-4e6f-8b7a-1c2d3e4f5a6b";
+
+const rawCursor = (payload: unknown) =>
+  btoa(JSON.stringify(payload))
+    .replace(/\+/g, "-")
+    .replace(/\//g, "_")
+    .replace(/=+$/, "");
+
+describe("decodeCursor", () => {
+  it("round-trips a cursor from encodeCursor", () => {
+    const cursor = { created_at: "2025-04-01T12:30:00.123456+00:00", id: ID };
+
+    assert.deepEqual(decodeCursor(encodeCursor(cursor)), cursor);
+  });
+
+  it("rejects an id that is not a UUID", () => {
+    const cursor = rawCursor(["2025-04-01T12:30:00Z", "1),id.gt.(0"]);
+
+    assert.throws(() => decodeCursor(cursor), /Invalid pagination cursor/);
+  });
+
+  it("rejects a created_at that is not an ISO timestamp", () => {
+    for (const createdAt of [
+      '2025-04-01",id.gt.0,created_at.eq."x',
+      "yesterday",
+      "2025-13-45T99:99:99Z",
+    ]) {
+      assert.throws(
+        () => decodeCursor(rawCursor([createdAt, ID])),
+        /Invalid pagination cursor/,
+      );
+    }
+  });
+
+  it("rejects garbage", () => {
+    assert.throws(() => decodeCursor("not a cursor"), /Invalid/);
+    assert.throws(() => decodeCursor(rawCursor({ id: ID })), /Invalid/);
+  });
+});
+
+describe("buildKeysetFilter", () => {
+  it("quotes the timestamp of a decoded cursor", () => {
+    const cursor = decodeCursor(
+      encodeCursor({ created_at: "2025-04-01T12:30:00+00:00", id: ID }),
+    );
+
+    assert.equal(
+      buildKeysetFilter(cursor),
+      `created_at.lt."2025-04-01T12:30:00+00:00",and(created_at.eq."2025-04-01T12:30:00+00:00",id.lt.${ID})`,
+    );
+  });
+});
@@ -0,0 +1,161 @@
+import { PostgrestError } from "@supabase/supabase-js";
+
+/**
+ * Columns every keyset-paginated row must carry so the next cursor can be built.
+ */
+export type CursorColumns = "id" | "created_at";
+
+/**
+ * Decoded keyset cursor. Pages are ordered by `(created_at DESC, id DESC)`.
+ */
+export interface Cursor {
+  created_at: string;
+  id: string;
+}
+
+/**
+ * Response shape for keyset-paginated list functions.
+ * `nextCursor` is null when there are no more rows.
+ * `count` is only populated when a count mode was requested.
+ */
+export interface CursorPageResponse<T> {
+  data: T[] | null;
+  error: PostgrestError | null;
+  count: number | null;
+  nextCursor: string | null;
+}
+
+/**
+ * Common options accepted by every `list*ByCursor` function.
+ */
+export interface CursorPageOptions<K extends string> {
+  /** Opaque cursor returned as `nextCursor` by the previous page. */
+  cursor?: string | null;
+  /** Maximum number of rows per page (default: 10, max: 1000). */
+  limit?: number;
+  /** Columns to return. `id` and `created_at` are always included. */
+  columns?: readonly K[];
+  /** Set to "estimated" to return a planner-estimated total row count. */
+  count?: "estimated";
+}
+
+export const DEFAULT_PAGE_LIMIT = 10;
+export const MAX_PAGE_LIMIT = 1000;
+
+/**
+ * Encodes a row position into an opaque, URL-safe cursor string.
+ * @param cursor The `created_at` and `id` of the last row on a page.
+ * @returns The encoded cursor.
+ * @example
+ * const next = encodeCursor({ created_at: row.created_at, id: row.id });
+ */
+export const encodeCursor = (cursor: Cursor): string =>
+  btoa(JSON.stringify([cursor.created_at, cursor.id]))
+    .replace(/\+/g, "-")
+    .replace(/\//g, "_")
+    .replace(/=+$/, "");
+
+// Cursor values are interpolated into a PostgREST filter (buildKeysetFilter),
+// so only exact UUIDs and ISO 8601 timestamps are accepted.
+const UUID_PATTERN =
+  /^[0-9a-f]{8}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{12}$/i;
+const TIMESTAMP_PATTERN =
+  /^\d{4}-\d{2}-\d{2}[T ]\d{2}:\d{2}:\d{2}(?:\.\d{1,6})?(?:Z|[+-]\d{2}(?::?\d{2})?)?$/;
+
+const isTimestamp = (value: string): boolean =>
+  TIMESTAMP_PATTERN.test(value) && !Number.isNaN(Date.parse(value));
+
+/**
+ * Decodes a cursor produced by `encodeCursor`.
+ * @param value The opaque cursor string.
+ * @returns The decoded cursor.
+ * @throws Error if the cursor is malformed, its `id` is not a UUID or its
+ * `created_at` is not an ISO 8601 timestamp.
+ */
+export const decodeCursor = (value: string): Cursor => {
+  try {
+    const base64 = value.replace(/-/g, "+").replace(/_/g, "/");
+    const [created_at, id] = JSON.parse(atob(base64));
+    if (
+      typeof created_at !== "string" ||
+      typeof id !== "string" ||
+      !isTimestamp(created_at) ||
+      !UUID_PATTERN.test(id)
+    ) {
+      throw new Error("Unexpected cursor payload");
+    }
+    return { created_at, id };
+  } catch {
+    throw new Error("Invalid pagination cursor.");
+  }
+};
+
+/**
+ * Builds the PostgREST select string for a column projection, always including
+ * the cursor columns.
+ * @param columns Requested columns, or undefined for all columns.
+ * @returns A comma separated column list suitable for `.select()`.
+ */
+export const buildProjection = (columns?: readonly string[]): string => {
+  if (!columns || columns.length === 0) return "*";
+  return Array.from(new Set<string>([...columns, "id", "created_at"])).join(
+    ",",
+  );
+};
+
+/**
+ * Builds the PostgREST `or` filter that selects rows strictly after a cursor
+ * in `(created_at DESC, id DESC)` order.
+ * Values are double-quoted so timestamps containing `+` or `:` survive parsing.
+ * @param cursor The decoded cursor.
+ * @returns A filter string for `.or()`.
+ */
+export const buildKeysetFilter = (cursor: Cursor): string =>
+  `created_at.lt."${cursor.created_at}",and(created_at.eq."${cursor.created_at}",id.lt.${cursor.id})`;
+
+/**
+ * Clamps a requested page size into the supported range.
+ * @param limit The requested limit.
+ * @returns A limit between 1 and MAX_PAGE_LIMIT.
+ */
+export const clampLimit = (limit?: number): number =>
+  Math.min(Math.max(Math.floor(limit ?? DEFAULT_PAGE_LIMIT), 1), MAX_PAGE_LIMIT);
+
+/**
+ * Converts a `limit + 1` result set into a page response, trimming the probe
+ * row and deriving `nextCursor` from the last row kept.
+ * @param result The raw PostgREST result.
+ * @param limit The page size that was requested.
+ * @returns The page response.
+ */
+export const toCursorPage = <T extends { id: string; created_at: string }>(
+  result: {
+    data: T[] | null;
+    error: PostgrestError | null;
+    count: number | null;
+  },
+  limit: number,
+): CursorPageResponse<T> => {
+  if (result.error || !result.data) {
+    return {
+      data: null,
+      error: result.error,
+      count: result.count,
+      nextCursor: null,
+    };
+  }
+
+  const hasMore = result.data.length > limit;
+  const rows = hasMore ? result.data.slice(0, limit) : result.data;
+  const last = rows[rows.length - 1];
+
+  return {
+    data: rows,
+    error: null,
+    count: result.count,
+    nextCursor:
+      hasMore && last
+        ? encodeCursor({ created_at: last.created_at, id: last.id })
+        : null,
+  };
+};
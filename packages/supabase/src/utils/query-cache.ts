@@ -0,0 +1,242 @@
+import { isListQueryKey } from "@maestro/utils";
+import { QueryClient } from "@tanstack/react-query";
+
+/**
+ * Minimal shape of a row that can be patched into React Query caches.
+ */
+export type CachedRow = { id: string } & Record<string, unknown>;
+
+// Keys in a list query's filter object that describe paging or projection,
+// not which rows belong to the list.
+const NON_FILTER_KEYS = new Set([
+  "page",
+  "limit",
+  "cursor",
+  "columns",
+  "count",
+  "infinite",
+  "ids",
+]);
+
+type ListFilters = Record<string, unknown>;
+
+type InfiniteData = { pages: unknown[]; pageParams: unknown[] };
+
+/**
+ * Checks whether a row satisfies the equality filters of a list query key
+ * (e.g. `{ organization_id }`). Paging keys are ignored; `ids` lists only match
+ * rows they already contain.
+ */
+const rowMatchesFilters = (row: CachedRow, filters: ListFilters): boolean => {
+  if (Array.isArray(filters.ids)) return filters.ids.includes(row.id);
+  return Object.entries(filters).every(
+    ([key, value]) =>
+      NON_FILTER_KEYS.has(key) || value === undefined || row[key] === value,
+  );
+};
+
+/**
+ * Compares the columns a change touches with the equality filters of a list
+ * query key: "leaves" when a touched column no longer matches, "joins" when
+ * every touched filter column matches, null when no filter column changed.
+ */
+const filterChange = (
+  row: CachedRow,
+  filters: ListFilters,
+): "joins" | "leaves" | null => {
+  if (Array.isArray(filters.ids)) return null;
+  const touched = Object.entries(filters).filter(
+    ([key, value]) =>
+      !NON_FILTER_KEYS.has(key) && value !== undefined && key in row,
+  );
+  if (touched.length === 0) return null;
+  return touched.every(([key, value]) => row[key] === value)
+    ? "joins"
+    : "leaves";
+};
+
+const isInfiniteData = (data: unknown): data is InfiniteData =>
+  typeof data === "object" &&
+  data !== null &&
+  Array.isArray((data as InfiniteData).pages);
+
+/**
+ * Applies `update` to every row array held by a list cache entry. Supports
+ * plain arrays (`useProjects`) and infinite query data whose pages are either
+ * arrays or `{ data: T[] }` page responses.
+ */
+const mapListRows = (
+  data: unknown,
+  update: (rows: CachedRow[]) => CachedRow[],
+): unknown => {
+  if (Array.isArray(data)) return update(data as CachedRow[]);
+  if (!isInfiniteData(data)) return data;
+
+  return {
+    ...data,
+    pages: data.pages.map((page) => {
+      if (Array.isArray(page)) return update(page as CachedRow[]);
+      const rows = (page as { data?: CachedRow[] | null } | null)?.data;
+      return Array.isArray(rows) ? { ...page, data: update(rows) } : page;
+    }),
+  };
+};
+
+/**
+ * Merges a changed row into an existing cached row, keeping the cached row's
+ * projection so lists fetched with `columns` do not grow extra fields.
+ */
+const mergeRow = (cached: CachedRow, row: CachedRow): CachedRow => {
+  const next: CachedRow = { ...cached };
+  Object.keys(cached).forEach((key) => {
+    if (key in row) next[key] = row[key];
+  });
+  return next;
+};
+
+/**
+ * Writes an updated row into the detail cache (`[table, id]`) and every list
+ * cache that already contains it. A row whose change moves it out of a list's
+ * filters (e.g. a new `organization_id`) is removed from that list, and lists
+ * it moves into are marked stale; nothing else is refetched.
+ * @param queryClient The React Query client.
+ * @param table The table name used as the first query key element.
+ * @param row The updated row (at least its id and changed columns).
+ * @example
+ * patchRowInCaches(queryClient, "projects", updatedProject);
+ */
+export const patchRowInCaches = (
+  queryClient: QueryClient,
+  table: string,
+  row: CachedRow,
+): void => {
+  queryClient.setQueryData<CachedRow>([table, row.id], (cached) =>
+    cached ? { ...cached, ...row } : cached,
+  );
+
+  queryClient
+    .getQueriesData({
+      queryKey: [table],
+      predicate: (query) => isListQueryKey(query.queryKey),
+    })
+    .forEach(([queryKey, data]) => {
+      const change = filterChange(row, queryKey[1] as ListFilters);
+      let found = false;
+      const next = mapListRows(data, (rows) => {
+        if (!rows.some((cached) => cached.id === row.id)) return rows;
+        found = true;
+        if (change === "leaves") {
+          return rows.filter((cached) => cached.id !== row.id);
+        }
+        return rows.map((cached) =>
+          cached.id === row.id ? mergeRow(cached, row) : cached,
+        );
+      });
+      if (found) {
+        queryClient.setQueryData(queryKey, next);
+      } else if (change === "joins") {
+        void queryClient.invalidateQueries({ queryKey, exact: true });
+      }
+    });
+};
+
+/**
+ * Records a newly created row: seeds its detail cache and marks stale only
+ * the list queries whose filters the row satisfies. Lists that cannot contain
+ * the row (other organization, `ids` lists, ...) are left untouched.
+ * @param queryClient The React Query client.
+ * @param table The table name used as the first query key element.
+ * @param row The inserted row.
+ */
+export const insertRowIntoCaches = (
+  queryClient: QueryClient,
+  table: string,
+  row: CachedRow,
+): void => {
+  queryClient.setQueryData([table, row.id], row);
+  queryClient.invalidateQueries({
+    queryKey: [table],
+    predicate: (query) =>
+      isListQueryKey(query.queryKey) &&
+      rowMatchesFilters(row, query.queryKey[1] as ListFilters),
+  });
+};
+
+/**
+ * Removes a deleted row from its detail cache and from every list cache that
+ * contains it. Nothing is refetched.
+ * @param queryClient The React Query client.
+ * @param table The table name used as the first query key element.
+ * @param id The id of the deleted row.
+ */
+export const removeRowFromCaches = (
+  queryClient: QueryClient,
+  table: string,
+  id: string,
+): void => {
+  queryClient.removeQueries({ queryKey: [table, id], exact: true });
+
+  queryClient
+    .getQueriesData({
+      queryKey: [table],
+      predicate: (query) => isListQueryKey(query.queryKey),
+    })
+    .forEach(([queryKey, data]) => {
+      let found = false;
+      const next = mapListRows(data, (rows) => {
+        const kept = rows.filter((cached) => cached.id !== id);
+        if (kept.length !== rows.length) found = true;
+        return kept;
+      });
+      if (found) queryClient.setQueryData(queryKey, next);
+    });
+};
+
+/**
+ * Looks up a row in the table's cached lists, e.g. to render a detail view
+ * instantly from the list the user navigated from. Lists fetched with a
+ * `columns` projection are skipped because their rows are partial.
+ * @param queryClient The React Query client.
+ * @param table The table name used as the first query key element.
+ * @param id The id of the row to find.
+ * @returns The cached row, or undefined when no list holds it.
+ * @example
+ * placeholderData: () => findRowInLists<Project>(queryClient, "projects", id),
+ */
+export const findRowInLists = <T extends { id: string }>(
+  queryClient: QueryClient,
+  table: string,
+  id: string,
+): T | undefined => {
+  const lists = queryClient.getQueriesData({
+    queryKey: [table],
+    predicate: (query) =>
+      isListQueryKey(query.queryKey) &&
+      !(query.queryKey[1] as ListFilters).columns,
+  });
+
+  for (const [, data] of lists) {
+    let match: CachedRow | undefined;
+    mapListRows(data, (rows) => {
+      match ??= rows.find((row) => row.id === id);
+      return rows;
+    });
+    if (match) return match as unknown as T;
+  }
+  return undefined;
+};
+
+/**
+ * Marks every list query for a table as stale. Active lists refetch, inactive
+ * ones refetch on next use. Detail caches are left alone.
+ * @param queryClient The React Query client.
+ * @param table The table name used as the first query key element.
+ */
+export const markListsStale = (
+  queryClient: QueryClient,
+  table: string,
+): Promise<void> =>
+  queryClient.invalidateQueries({
+    queryKey: [table],
+    predicate: (query) => isListQueryKey(query.queryKey),
+  });
@@ -0,0 +1,321 @@
+-- Benchmark: query-benchmark.sql
+-- Purpose: Time the queries issued by the src/modules helpers under RLS, as users with light,
+--   typical and heavy access, and summarise their plans. Run it before and after a migration
+--   to catch plan regressions (a new Seq Scan, a lost index, a per-row policy subquery).
+-- Usage (local stack): pnpm supabase:seed:synthetic && pnpm supabase:bench:queries
+--   or: psql "$SUPABASE_DB_URL" -v iterations=200 -f supabase/benchmarks/query-benchmark.sql
+-- Requires the dataset from synthetic-data.sql. Runs in a transaction that is rolled back.
+\set ON_ERROR_STOP on
+\if :{?iterations}
+\else
+\set iterations 50
+\endif
+\if :{?warmup}
+\else
+\set warmup 5
+\endif
+\pset pager off
+BEGIN
+;
+
+-- ========= Benchmark Users =========
+-- Synthetic users at the median, 99th percentile and maximum of accessible projects.
+CREATE TEMP TABLE bench_users ON COMMIT DROP AS WITH per_user AS (
+    SELECT
+        u.id,
+        u.email,
+        count(ua.project_id) AS projects
+    FROM
+        auth.users u
+        LEFT JOIN public.user_access ua ON ua.profile_id = u.id
+    WHERE
+        u.email LIKE 'synthetic-%@synthetic.test'
+        AND u.email NOT LIKE 'synthetic-invitee-%'
+    GROUP BY
+        u.id,
+        u.email
+),
+ranked AS (
+    SELECT
+        per_user.*,
+        percent_rank() OVER (
+            ORDER BY
+                projects,
+                id
+        ) AS pct
+    FROM
+        per_user
+)
+SELECT
+    DISTINCT ON (label) label,
+    r.id,
+    r.email,
+    r.projects
+FROM
+    (
+        VALUES
+            ('p50', 0.5),
+            ('p99', 0.99),
+            ('max', 1.0)
+    ) targets(label, pct)
+    JOIN ranked r ON r.pct >= targets.pct
+ORDER BY
+    label,
+    r.pct;
+
+SELECT
+    count(*) = 0 AS missing_dataset
+FROM
+    bench_users \gset
+\if :missing_dataset
+\echo 'No synthetic data found. Run pnpm supabase:seed:synthetic first.'
+ROLLBACK;
+\quit
+\endif
+
+-- ========= Queries =========
+-- Mirrors the module helpers; %1$L is the user id, %2$L a project and %3$L an organization
+-- the user can access.
+CREATE TEMP TABLE bench_queries (name text PRIMARY KEY, sql text NOT NULL) ON COMMIT DROP;
+
+INSERT INTO
+    bench_queries (name, sql)
+VALUES
+    (
+        'listProjectsByCursor (first page)',
+        'SELECT * FROM public.projects ORDER BY created_at DESC, id DESC LIMIT 20'
+    ),
+    (
+        'listProjectsByCursor (org filter)',
+        'SELECT * FROM public.projects WHERE organization_id = %3$L ORDER BY created_at DESC, id DESC LIMIT 20'
+    ),
+    (
+        'listProjects (exact count)',
+        'SELECT count(*) FROM public.projects'
+    ),
+    (
+        'fetchProjectById',
+        'SELECT * FROM public.projects WHERE id = %2$L'
+    ),
+    (
+        'listOrganizationsByCursor (first page)',
+        'SELECT * FROM public.organizations ORDER BY created_at DESC, id DESC LIMIT 20'
+    ),
+    (
+        'organization members',
+        'SELECT * FROM public.organization_members WHERE organization_id = %3$L'
+    ),
+    (
+        'fetchPendingInvitations',
+        'SELECT * FROM public.get_pending_invitations()'
+    ),
+    (
+        'fetchUserAccess',
+        'SELECT * FROM public.user_access WHERE profile_id = %1$L'
+    );
+
+CREATE TEMP TABLE bench_timings (
+    query text NOT NULL,
+    label text NOT NULL,
+    ms double precision NOT NULL
+) ON COMMIT DROP;
+
+CREATE TEMP TABLE bench_plans (
+    query text NOT NULL,
+    label text NOT NULL,
+    plan jsonb NOT NULL
+) ON COMMIT DROP;
+
+-- ========= Run =========
+-- psql variables are not interpolated inside the DO body; pass them as settings.
+SELECT
+    set_config('bench.iterations', :'iterations', true),
+    set_config('bench.warmup', :'warmup', true);
+
+DO $$
+DECLARE
+    bench_user record;
+
+bench_query record;
+
+target_project uuid;
+
+target_organization uuid;
+
+statement text;
+
+plan json;
+
+started timestamp with time zone;
+
+i integer;
+
+iterations integer := current_setting('bench.iterations') :: integer;
+
+warmup integer := current_setting('bench.warmup') :: integer;
+
+BEGIN
+    FOR bench_user IN
+    SELECT
+        *
+    FROM
+        bench_users LOOP
+        -- Largest accessible organization and one of its projects.
+    SELECT
+        ua.organization_id,
+        max(ua.project_id :: text) :: uuid INTO target_organization,
+        target_project
+    FROM
+        public.user_access ua
+    WHERE
+        ua.profile_id = bench_user.id
+    GROUP BY
+        ua.organization_id
+    ORDER BY
+        count(*) DESC
+    LIMIT
+        1;
+
+FOR bench_query IN
+SELECT
+    *
+FROM
+    bench_queries LOOP statement := format(
+        bench_query.sql,
+        bench_user.id,
+        target_project,
+        target_organization
+    );
+
+PERFORM set_config(
+    'request.jwt.claims',
+    json_build_object(
+        'sub',
+        bench_user.id,
+        'email',
+        bench_user.email,
+        'role',
+        'authenticated'
+    ) :: text,
+    true
+);
+
+SET
+    LOCAL ROLE authenticated;
+
+FOR i IN 1..warmup LOOP EXECUTE statement;
+
+END LOOP;
+
+FOR i IN 1..iterations LOOP started := clock_timestamp();
+
+EXECUTE statement;
+
+RESET ROLE;
+
+INSERT INTO
+    bench_timings (query, label, ms)
+VALUES
+    (
+        bench_query.name,
+        bench_user.label,
+        extract(
+            epoch
+            FROM
+                clock_timestamp() - started
+        ) * 1000
+    );
+
+SET
+    LOCAL ROLE authenticated;
+
+END LOOP;
+
+EXECUTE 'EXPLAIN (ANALYZE, BUFFERS, FORMAT JSON) ' || statement INTO plan;
+
+RESET ROLE;
+
+INSERT INTO
+    bench_plans (query, label, plan)
+VALUES
+    (bench_query.name, bench_user.label, plan :: jsonb -> 0);
+
+END LOOP;
+
+END LOOP;
+
+END $$;
+
+\echo '=== Benchmark users ==='
+SELECT
+    label,
+    email,
+    projects AS accessible_projects
+FROM
+    bench_users
+ORDER BY
+    projects;
+
+\echo '=== Latency (ms) ==='
+SELECT
+    t.query,
+    t.label,
+    count(*) AS runs,
+    round(
+        percentile_cont(0.5) WITHIN GROUP (
+            ORDER BY
+                t.ms
+        ) :: numeric,
+        3
+    ) AS p50,
+    round(
+        percentile_cont(0.95) WITHIN GROUP (
+            ORDER BY
+                t.ms
+        ) :: numeric,
+        3
+    ) AS p95,
+    round(
+        percentile_cont(0.99) WITHIN GROUP (
+            ORDER BY
+                t.ms
+        ) :: numeric,
+        3
+    ) AS p99,
+    round(max(t.ms) :: numeric, 3) AS max
+FROM
+    bench_timings t
+    JOIN bench_users u ON u.label = t.label
+GROUP BY
+    t.query,
+    t.label,
+    u.projects
+ORDER BY
+    t.query,
+    u.projects;
+
+\echo '=== Plan summary (EXPLAIN ANALYZE of the last run) ==='
+SELECT
+    p.query,
+    p.label,
+    p.plan -> 'Plan' ->> 'Node Type' AS top_node,
+    round((p.plan ->> 'Planning Time') :: numeric, 3) AS planning_ms,
+    round((p.plan ->> 'Execution Time') :: numeric, 3) AS execution_ms,
+    (p.plan -> 'Plan' ->> 'Shared Hit Blocks') :: bigint + (p.plan -> 'Plan' ->> 'Shared Read Blocks') :: bigint AS buffers,
+    (
+        SELECT
+            string_agg(DISTINCT relation #>> '{}', ', ')
+        FROM
+            jsonb_path_query(
+                p.plan,
+                'strict $.** ? (@."Node Type" == "Seq Scan")."Relation Name"'
+            ) relation
+    ) AS seq_scans
+FROM
+    bench_plans p
+    JOIN bench_users u ON u.label = p.label
+ORDER BY
+    p.query,
+    u.projects;
+
+ROLLBACK;
@@ -0,0 +1,205 @@
+-- Benchmark: rls-policies.sql
+-- Purpose: Compare the per-row correlated RLS policies from 0002_RLS_POLICIES.sql with the
+--   helper-function policies from 0006_RLS_PERFORMANCE.sql on a realistic data volume.
+-- Usage (local stack): pnpm supabase:bench:rls
+--   or: psql "$SUPABASE_DB_URL" -v projects=100000 -f supabase/benchmarks/rls-policies.sql
+-- Everything runs inside a single transaction that is rolled back, so no data is left behind.
+\set ON_ERROR_STOP on
+\if :{?projects}
+\else
+\set projects 100000
+\endif
+\if :{?users}
+\else
+\set users 1000
+\endif
+\if :{?orgs}
+\else
+\set orgs 500
+\endif
+\set bench_user '00000000-0000-0000-0000-00000000beef'
+\pset pager off
+BEGIN
+;
+
+-- ========= Fixture =========
+-- Auth users fire the profile and default organization triggers, so every user
+-- also gets a "Personal" organization and an owner membership.
+INSERT INTO
+    auth.users (
+        id,
+        email,
+        encrypted_password,
+        role,
+        instance_id,
+        aud,
+        email_confirmed_at
+    )
+SELECT
+    CASE
+        WHEN g = 1 THEN :'bench_user'::uuid
+        ELSE gen_random_uuid()
+    END,
+    'bench-' || g || '@example.com',
+    '',
+    'authenticated',
+    '00000000-0000-0000-0000-000000000000',
+    'authenticated',
+    now()
+FROM
+    generate_series(1, :users) g;
+
+INSERT INTO
+    public.organizations (name)
+SELECT
+    'Bench Org ' || g
+FROM
+    generate_series(1, :orgs) g;
+
+-- Each user joins ~1% of the shared organizations; the benchmark user joins 10.
+INSERT INTO
+    public.organization_members (organization_id, profile_id, role)
+SELECT
+    o.id,
+    p.id,
+    'member'
+FROM
+    public.organizations o
+    JOIN public.profiles p ON random() < 0.01
+WHERE
+    o.name LIKE 'Bench Org %'
+    AND p.id <> :'bench_user'::uuid ON CONFLICT DO NOTHING;
+
+INSERT INTO
+    public.organization_members (organization_id, profile_id, role)
+SELECT
+    id,
+    :'bench_user'::uuid,
+    'member'
+FROM
+    public.organizations
+WHERE
+    name LIKE 'Bench Org %'
+ORDER BY
+    random()
+LIMIT
+    10 ON CONFLICT DO NOTHING;
+
+INSERT INTO
+    public.projects (organization_id, name, created_at)
+SELECT
+    o.ids[1 + (g % array_length(o.ids, 1))],
+    'Bench Project ' || g,
+    now() - (g || ' seconds')::interval
+FROM
+    generate_series(1, :projects) g,
+    (
+        SELECT
+            array_agg(id) AS ids
+        FROM
+            public.organizations
+        WHERE
+            name LIKE 'Bench Org %'
+    ) o;
+
+ANALYZE public.organizations;
+
+ANALYZE public.organization_members;
+
+ANALYZE public.projects;
+
+ANALYZE public.project_members;
+
+SELECT
+    set_config(
+        'request.jwt.claims',
+        json_build_object('sub', :'bench_user', 'role', 'authenticated') :: text,
+        true
+    );
+
+-- ========= Legacy policy (0002) =========
+-- Only the projects SELECT policy is swapped back: the original organization_members
+-- policy references its own table and fails with infinite recursion when evaluated.
+SAVEPOINT legacy_policies;
+
+DROP POLICY "Members can view projects in their orgs" ON public.projects;
+
+CREATE POLICY "Members can view projects in their orgs" ON public.projects FOR
+SELECT
+    USING (
+        EXISTS (
+            SELECT
+                1
+            FROM
+                public.organization_members om
+            WHERE
+                om.organization_id = projects.organization_id
+                AND om.profile_id = auth.uid()
+        )
+    );
+
+\echo '=== Legacy policy: latest projects page ==='
+SET
+    LOCAL ROLE authenticated;
+
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF)
+SELECT
+    id,
+    name,
+    created_at
+FROM
+    public.projects
+ORDER BY
+    created_at DESC,
+    id DESC
+LIMIT
+    50;
+
+\echo '=== Legacy policy: count visible projects ==='
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF)
+SELECT
+    count(*)
+FROM
+    public.projects;
+
+RESET ROLE;
+
+ROLLBACK TO SAVEPOINT legacy_policies;
+
+-- ========= Current policy (0006) =========
+\echo '=== Current policy: latest projects page ==='
+SET
+    LOCAL ROLE authenticated;
+
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF)
+SELECT
+    id,
+    name,
+    created_at
+FROM
+    public.projects
+ORDER BY
+    created_at DESC,
+    id DESC
+LIMIT
+    50;
+
+\echo '=== Current policy: count visible projects ==='
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF)
+SELECT
+    count(*)
+FROM
+    public.projects;
+
+\echo '=== Current policy: organization members (previously recursive) ==='
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF)
+SELECT
+    organization_id,
+    profile_id,
+    role
+FROM
+    public.organization_members;
+
+RESET ROLE;
+
+ROLLBACK;
@@ -0,0 +1,403 @@
+-- Benchmark: synthetic-data.sql
+-- Purpose: Load a seed-scale synthetic dataset into the local stack so schema and RLS changes
+--   can be measured (see query-benchmark.sql). Unlike rls-policies.sql the data is committed.
+--   Distributions are skewed the way real tenants are:
+--   * organization popularity follows a power law: a few shared orgs hold most members;
+--   * most users belong to 1-3 shared orgs, the top 1% ("power users") to ~10% of all orgs;
+--   * projects concentrate in the large orgs; ~30% of projects also have direct members;
+--   * invitations mix pending (some overdue), accepted, declined and expired rows.
+-- Usage (local stack): pnpm supabase:seed:synthetic
+--   or: psql "$SUPABASE_DB_URL" -v users=20000 -v orgs=2000 -v projects=200000 \
+--         -f supabase/benchmarks/synthetic-data.sql
+-- Variables: users, orgs, projects, invitations, memberships (mean shared orgs per user),
+--   seed (0..1, for reproducible data). Re-running replaces the previous synthetic dataset.
+-- Synthetic rows are identified by '@synthetic.test' emails and 'Synthetic ' names.
+\set ON_ERROR_STOP on
+\if :{?users}
+\else
+\set users 5000
+\endif
+\if :{?orgs}
+\else
+\set orgs 500
+\endif
+\if :{?projects}
+\else
+\set projects 50000
+\endif
+\if :{?invitations}
+\else
+\set invitations 20000
+\endif
+\if :{?memberships}
+\else
+\set memberships 2
+\endif
+\if :{?seed}
+\else
+\set seed 0.42
+\endif
+\pset pager off
+BEGIN
+;
+
+SELECT
+    setseed(:seed);
+
+-- ========= Cleanup =========
+-- Personal organizations of synthetic users are removed with them; shared synthetic
+-- organizations take their projects (and user_access rows) with them via ON DELETE CASCADE.
+DELETE FROM
+    public.organizations o
+WHERE
+    o.name LIKE 'Synthetic Org %'
+    OR (
+        o.name = 'Personal'
+        AND EXISTS (
+            SELECT
+                1
+            FROM
+                public.organization_members om
+                JOIN auth.users u ON u.id = om.profile_id
+            WHERE
+                om.organization_id = o.id
+                AND om.role = 'owner'
+                AND u.email LIKE '%@synthetic.test'
+        )
+    );
+
+DELETE FROM
+    auth.users
+WHERE
+    email LIKE '%@synthetic.test';
+
+-- ========= Users =========
+-- Auth users fire the profile and default organization triggers, so every user
+-- also gets a "Personal" organization and an owner membership.
+INSERT INTO
+    auth.users (
+        id,
+        email,
+        encrypted_password,
+        role,
+        instance_id,
+        aud,
+        email_confirmed_at,
+        raw_user_meta_data
+    )
+SELECT
+    gen_random_uuid(),
+    'synthetic-' || g || '@synthetic.test',
+    '',
+    'authenticated',
+    '00000000-0000-0000-0000-000000000000',
+    'authenticated',
+    now(),
+    jsonb_build_object('full_name', 'Synthetic User ' || g)
+FROM
+    generate_series(1, :users) g;
+
+CREATE TEMP TABLE synthetic_users ON COMMIT DROP AS
+SELECT
+    row_number() OVER (
+        ORDER BY
+            u.created_at,
+            u.email
+    ) AS n,
+    u.id,
+    u.email
+FROM
+    auth.users u
+WHERE
+    u.email LIKE '%@synthetic.test';
+
+-- ========= Organizations =========
+INSERT INTO
+    public.organizations (name, owner_id, created_at)
+SELECT
+    'Synthetic Org ' || g,
+    (
+        SELECT
+            id
+        FROM
+            synthetic_users
+        WHERE
+            n = 1 + (g * 7919) % :users
+    ),
+    now() - random() * interval '2 years'
+FROM
+    generate_series(1, :orgs) g;
+
+CREATE TEMP TABLE synthetic_orgs ON COMMIT DROP AS
+SELECT
+    substring(
+        o.name
+        FROM
+            15
+    ) :: int AS n,
+    o.id
+FROM
+    public.organizations o
+WHERE
+    o.name LIKE 'Synthetic Org %';
+
+CREATE UNIQUE INDEX ON synthetic_orgs (n);
+
+-- Owners are members of the organizations they own.
+INSERT INTO
+    public.organization_members (organization_id, profile_id, role)
+SELECT
+    o.id,
+    o.owner_id,
+    'owner'
+FROM
+    public.organizations o
+WHERE
+    o.name LIKE 'Synthetic Org %' ON CONFLICT DO NOTHING;
+
+-- ========= Organization Memberships =========
+-- Random picks are computed in subqueries (volatile, so evaluated once per row) and then
+-- joined. LATERAL arguments reference the outer row for the same reason.
+-- Membership count per user is exponential around :memberships; power users join ~10% of
+-- all orgs. Which org is joined follows a power law (random()^2.5 favours low org numbers).
+INSERT INTO
+    public.organization_members (organization_id, profile_id, role)
+SELECT
+    DISTINCT ON (o.id, picks.profile_id) o.id,
+    picks.profile_id,
+    picks.role
+FROM
+    (
+        SELECT
+            u.id AS profile_id,
+            1 + floor(:orgs * power(random(), 2.5)) :: int AS org_n,
+            CASE
+                WHEN random() < 0.05 THEN 'admin'
+                ELSE 'member'
+            END AS role
+        FROM
+            synthetic_users u
+            CROSS JOIN LATERAL generate_series(
+                1,
+                CASE
+                    WHEN u.n <= greatest(1, :users / 100) THEN greatest(1, :orgs / 10)
+                    ELSE least(
+                        :orgs,
+                        1 + floor(- ln(1 - random()) * :memberships) :: int
+                    )
+                END
+            ) j
+    ) picks
+    JOIN synthetic_orgs o ON o.n = least(picks.org_n, :orgs) ON CONFLICT DO NOTHING;
+
+-- ========= Projects =========
+-- Large orgs get most projects; creation times spread over the last year for pagination.
+INSERT INTO
+    public.projects (organization_id, name, description, created_at)
+SELECT
+    o.id,
+    'Synthetic Project ' || picks.g,
+    CASE
+        WHEN picks.described THEN 'Synthetic project description ' || picks.g
+    END,
+    picks.created_at
+FROM
+    (
+        SELECT
+            g,
+            1 + floor(:orgs * power(random(), 2)) :: int AS org_n,
+            random() < 0.5 AS described,
+            now() - random() * interval '1 year' AS created_at
+        FROM
+            generate_series(1, :projects) g
+    ) picks
+    JOIN synthetic_orgs o ON o.n = least(picks.org_n, :orgs);
+
+-- ========= Project Memberships =========
+-- ~30% of projects get 1-5 direct members, drawn uniformly from all synthetic users.
+INSERT INTO
+    public.project_members (project_id, profile_id, role)
+SELECT
+    DISTINCT ON (picks.project_id, u.id) picks.project_id,
+    u.id,
+    picks.role
+FROM
+    (
+        SELECT
+            p.id AS project_id,
+            1 + floor(random() * :users) :: int AS user_n,
+            (ARRAY ['editor', 'viewer', 'member']) [1 + floor(random() * 3) :: int] AS role
+        FROM
+            (
+                SELECT
+                    id,
+                    1 + floor(random() * 5) :: int AS member_count
+                FROM
+                    public.projects
+                WHERE
+                    name LIKE 'Synthetic Project %'
+                    AND random() < 0.3
+            ) p
+            CROSS JOIN LATERAL generate_series(1, p.member_count) j
+    ) picks
+    JOIN synthetic_users u ON u.n = least(picks.user_n, :users) ON CONFLICT DO NOTHING;
+
+-- ========= Invitations =========
+-- Half the invitees already have accounts (so accept_all_invitations has work to do).
+-- A quarter target a project of the chosen organization, when it has one.
+INSERT INTO
+    public.invitations (
+        inviter_id,
+        invitee_email,
+        target_type,
+        target_id,
+        role,
+        status,
+        expires_at,
+        created_at
+    )
+SELECT
+    inviter.id,
+    CASE
+        WHEN picks.existing_invitee THEN invitee.email
+        ELSE 'synthetic-invitee-' || picks.g || '@synthetic.test'
+    END,
+    CASE
+        WHEN target_project.id IS NOT NULL THEN 'project' :: public.invitation_target_type
+        ELSE 'organization' :: public.invitation_target_type
+    END,
+    coalesce(target_project.id, org.id),
+    'member',
+    CASE
+        WHEN picks.roll < 0.70 THEN 'pending'
+        WHEN picks.roll < 0.85 THEN 'accepted'
+        WHEN picks.roll < 0.95 THEN 'declined'
+        ELSE 'expired'
+    END :: public.invitation_status,
+    picks.expires_at,
+    picks.created_at
+FROM
+    (
+        SELECT
+            g,
+            1 + floor(:orgs * power(random(), 2)) :: int AS org_n,
+            1 + floor(random() * :users) :: int AS inviter_n,
+            1 + floor(random() * :users) :: int AS invitee_n,
+            random() < 0.5 AS existing_invitee,
+            random() AS roll,
+            CASE
+                WHEN random() >= 0.2 THEN now() + (random() * 60 - 15) * interval '1 day'
+            END AS expires_at,
+            now() - random() * interval '90 days' AS created_at
+        FROM
+            generate_series(1, :invitations) g
+    ) picks
+    JOIN synthetic_orgs org ON org.n = least(picks.org_n, :orgs)
+    JOIN synthetic_users inviter ON inviter.n = least(picks.inviter_n, :users)
+    JOIN synthetic_users invitee ON invitee.n = least(picks.invitee_n, :users)
+    LEFT JOIN LATERAL (
+        SELECT
+            p.id
+        FROM
+            public.projects p
+        WHERE
+            picks.g % 4 = 0
+            AND p.organization_id = org.id
+        LIMIT
+            1
+    ) target_project ON TRUE ON CONFLICT DO NOTHING;
+
+COMMIT;
+
+-- ========= Statistics =========
+ANALYZE public.profiles;
+
+ANALYZE public.organizations;
+
+ANALYZE public.organization_members;
+
+ANALYZE public.projects;
+
+ANALYZE public.project_members;
+
+ANALYZE public.invitations;
+
+ANALYZE public.user_access;
+
+\echo '=== Synthetic dataset ==='
+SELECT
+    (
+        SELECT
+            count(*)
+        FROM
+            auth.users
+        WHERE
+            email LIKE '%@synthetic.test'
+    ) AS users,
+    (
+        SELECT
+            count(*)
+        FROM
+            public.organizations
+        WHERE
+            name LIKE 'Synthetic Org %'
+    ) AS shared_orgs,
+    (
+        SELECT
+            count(*)
+        FROM
+            public.organization_members
+    ) AS org_memberships,
+    (
+        SELECT
+            count(*)
+        FROM
+            public.projects
+        WHERE
+            name LIKE 'Synthetic Project %'
+    ) AS projects,
+    (
+        SELECT
+            count(*)
+        FROM
+            public.project_members
+    ) AS project_memberships,
+    (
+        SELECT
+            count(*)
+        FROM
+            public.invitations
+        WHERE
+            invitee_email LIKE '%@synthetic.test'
+    ) AS invitations,
+    (
+        SELECT
+            count(*)
+        FROM
+            public.user_access
+    ) AS user_access_rows;
+
+\echo '=== Accessible projects per user (skew) ==='
+SELECT
+    percentile_disc(0.5) WITHIN GROUP (
+        ORDER BY
+            projects
+    ) AS p50,
+    percentile_disc(0.9) WITHIN GROUP (
+        ORDER BY
+            projects
+    ) AS p90,
+    percentile_disc(0.99) WITHIN GROUP (
+        ORDER BY
+            projects
+    ) AS p99,
+    max(projects) AS max
+FROM
+    (
+        SELECT
+            count(*) AS projects
+        FROM
+            public.user_access
+        GROUP BY
+            profile_id
+    ) per_user;
@@ -0,0 +1,29 @@
+-- Migration: 0005_LIST_PAGINATION_INDEXES.sql
+-- Purpose: Composite indexes backing keyset (cursor) pagination in the list*ByCursor module functions.
+-- Pages are ordered by (created_at DESC, id DESC), optionally filtered by a parent key,
+-- so each index leads with the filter column (when any) followed by the sort key.
+BEGIN
+;
+
+-- ========= Projects =========
+-- Per-organization listing: WHERE organization_id = $1 ORDER BY created_at DESC, id DESC
+CREATE INDEX IF NOT EXISTS idx_projects_org_created_at_id ON public.projects (organization_id, created_at DESC, id DESC);
+
+-- Unfiltered listing (rows visible through RLS across all of a user's organizations)
+CREATE INDEX IF NOT EXISTS idx_projects_created_at_id ON public.projects (created_at DESC, id DESC);
+
+-- The composite index above covers every lookup the single-column index served.
+DROP INDEX IF EXISTS public.idx_projects_organization_id;
+
+-- ========= Organizations =========
+CREATE INDEX IF NOT EXISTS idx_organizations_created_at_id ON public.organizations (created_at DESC, id DESC);
+
+-- Listing organizations created by a given owner
+CREATE INDEX IF NOT EXISTS idx_organizations_owner_created_at_id ON public.organizations (owner_id, created_at DESC, id DESC);
+
+-- ========= Profiles =========
+CREATE INDEX IF NOT EXISTS idx_profiles_created_at_id ON public.profiles (created_at DESC, id DESC);
+
+COMMIT;
+
+-- End transaction
@@ -0,0 +1,482 @@
+-- Migration: 0006_RLS_PERFORMANCE.sql
+-- Purpose: Rewrite membership-based RLS policies for performance.
+--   * Membership lookups move into STABLE SECURITY DEFINER helper functions. The
+--     helpers read the membership tables without re-entering their RLS policies
+--     (which also removes the self-referencing policy on organization_members).
+--   * Policies compare against the helper result sets (`x IN (SELECT helper())`),
+--     which Postgres evaluates once per statement as a hashed InitPlan instead of
+--     running a correlated EXISTS subquery for every row scanned.
+--   * auth.uid() is wrapped as (SELECT auth.uid()) so it is evaluated once per
+--     statement rather than once per row.
+-- Benchmark: supabase/benchmarks/rls-policies.sql (pnpm supabase:bench:rls)
+BEGIN
+;
+
+-- ========= Membership Helper Functions =========
+-- Organizations the current user belongs to.
+CREATE
+OR REPLACE FUNCTION public.user_org_ids() RETURNS SETOF uuid LANGUAGE sql STABLE SECURITY DEFINER
+SET
+    search_path = '' AS $$
+SELECT
+    om.organization_id
+FROM
+    public.organization_members om
+WHERE
+    om.profile_id = (
+        SELECT
+            auth.uid()
+    );
+
+$$;
+
+COMMENT ON FUNCTION public.user_org_ids() IS 'Returns the ids of all organizations the authenticated user is a member of. Used by RLS policies.';
+
+-- Projects the current user is a direct member of.
+CREATE
+OR REPLACE FUNCTION public.user_project_ids() RETURNS SETOF uuid LANGUAGE sql STABLE SECURITY DEFINER
+SET
+    search_path = '' AS $$
+SELECT
+    pm.project_id
+FROM
+    public.project_members pm
+WHERE
+    pm.profile_id = (
+        SELECT
+            auth.uid()
+    );
+
+$$;
+
+COMMENT ON FUNCTION public.user_project_ids() IS 'Returns the ids of all projects the authenticated user is a direct member of. Used by RLS policies.';
+
+-- Projects that belong to any organization the current user is a member of.
+CREATE
+OR REPLACE FUNCTION public.user_org_project_ids() RETURNS SETOF uuid LANGUAGE sql STABLE SECURITY DEFINER
+SET
+    search_path = '' AS $$
+SELECT
+    p.id
+FROM
+    public.projects p
+    JOIN public.organization_members om ON om.organization_id = p.organization_id
+WHERE
+    om.profile_id = (
+        SELECT
+            auth.uid()
+    );
+
+$$;
+
+COMMENT ON FUNCTION public.user_org_project_ids() IS 'Returns the ids of all projects in organizations the authenticated user is a member of. Used by RLS policies.';
+
+-- Point checks, for application code and ad-hoc policies on a single row.
+CREATE
+OR REPLACE FUNCTION public.is_org_member(org_id uuid) RETURNS boolean LANGUAGE sql STABLE SECURITY DEFINER
+SET
+    search_path = '' AS $$
+SELECT
+    EXISTS (
+        SELECT
+            1
+        FROM
+            public.organization_members om
+        WHERE
+            om.organization_id = org_id
+            AND om.profile_id = (
+                SELECT
+                    auth.uid()
+            )
+    );
+
+$$;
+
+COMMENT ON FUNCTION public.is_org_member(uuid) IS 'Returns true when the authenticated user is a member of the given organization.';
+
+CREATE
+OR REPLACE FUNCTION public.is_project_member(project_id uuid) RETURNS boolean LANGUAGE sql STABLE SECURITY DEFINER
+SET
+    search_path = '' AS $$
+SELECT
+    EXISTS (
+        SELECT
+            1
+        FROM
+            public.project_members pm
+        WHERE
+            pm.project_id = is_project_member.project_id
+            AND pm.profile_id = (
+                SELECT
+                    auth.uid()
+            )
+    );
+
+$$;
+
+COMMENT ON FUNCTION public.is_project_member(uuid) IS 'Returns true when the authenticated user is a direct member of the given project.';
+
+GRANT EXECUTE ON FUNCTION public.user_org_ids() TO authenticated,
+service_role;
+
+GRANT EXECUTE ON FUNCTION public.user_project_ids() TO authenticated,
+service_role;
+
+GRANT EXECUTE ON FUNCTION public.user_org_project_ids() TO authenticated,
+service_role;
+
+GRANT EXECUTE ON FUNCTION public.is_org_member(uuid) TO authenticated,
+service_role;
+
+GRANT EXECUTE ON FUNCTION public.is_project_member(uuid) TO authenticated,
+service_role;
+
+-- ========= Indexes =========
+-- Covering indexes so the helpers resolve a user's memberships with an index-only scan.
+-- They supersede the single-column profile_id indexes from 0000_BASE_SCHEMA.sql.
+CREATE INDEX IF NOT EXISTS idx_organization_members_profile_org ON public.organization_members (profile_id, organization_id);
+
+DROP INDEX IF EXISTS public.idx_organization_members_profile_id;
+
+CREATE INDEX IF NOT EXISTS idx_project_members_profile_project ON public.project_members (profile_id, project_id);
+
+DROP INDEX IF EXISTS public.idx_project_members_profile_id;
+
+-- ========= Profiles Policies =========
+DROP POLICY IF EXISTS "Users can view own profile" ON public.profiles;
+
+DROP POLICY IF EXISTS "Users can update own profile" ON public.profiles;
+
+DROP POLICY IF EXISTS "Allow authenticated users to view any profile" ON public.profiles;
+
+CREATE POLICY "Users can view own profile" ON public.profiles FOR
+SELECT
+    TO authenticated USING (
+        (
+            SELECT
+                auth.uid()
+        ) = id
+    );
+
+CREATE POLICY "Users can update own profile" ON public.profiles FOR
+UPDATE
+    TO authenticated USING (
+        (
+            SELECT
+                auth.uid()
+        ) = id
+    ) WITH CHECK (
+        (
+            SELECT
+                auth.uid()
+        ) = id
+    );
+
+-- Equivalent to the previous auth.role() = 'authenticated' check, resolved by role instead of per row.
+CREATE POLICY "Allow authenticated users to view any profile" ON public.profiles FOR
+SELECT
+    TO authenticated USING (true);
+
+-- ========= Organizations Policies =========
+DROP POLICY IF EXISTS "Members can view their organizations" ON public.organizations;
+
+DROP POLICY IF EXISTS "Organization members can manage organization" ON public.organizations;
+
+DROP POLICY IF EXISTS "Authenticated users can create organizations" ON public.organizations;
+
+CREATE POLICY "Members can view their organizations" ON public.organizations FOR
+SELECT
+    TO authenticated USING (
+        id IN (
+            SELECT
+                public.user_org_ids()
+        )
+    );
+
+CREATE POLICY "Organization members can manage organization" ON public.organizations FOR
+UPDATE
+    TO authenticated USING (
+        id IN (
+            SELECT
+                public.user_org_ids()
+        ) -- AND public.org_role(id) = 'admin' -- Optional: Add role check
+    ) WITH CHECK (
+        id IN (
+            SELECT
+                public.user_org_ids()
+        )
+    );
+
+CREATE POLICY "Authenticated users can create organizations" ON public.organizations FOR
+INSERT
+    TO authenticated WITH CHECK (true);
+
+-- ========= Organization Members Policies =========
+DROP POLICY IF EXISTS "Members can view their own memberships" ON public.organization_members;
+
+DROP POLICY IF EXISTS "Org members can view other members in the same org" ON public.organization_members;
+
+DROP POLICY IF EXISTS "Users can leave organizations" ON public.organization_members;
+
+DROP POLICY IF EXISTS "Org members can add members (needs role check)" ON public.organization_members;
+
+DROP POLICY IF EXISTS "Org members can remove members (needs role check)" ON public.organization_members;
+
+CREATE POLICY "Members can view their own memberships" ON public.organization_members FOR
+SELECT
+    TO authenticated USING (
+        (
+            SELECT
+                auth.uid()
+        ) = profile_id
+    );
+
+CREATE POLICY "Org members can view other members in the same org" ON public.organization_members FOR
+SELECT
+    TO authenticated USING (
+        organization_id IN (
+            SELECT
+                public.user_org_ids()
+        )
+    );
+
+CREATE POLICY "Users can leave organizations" ON public.organization_members FOR
+DELETE
+    TO authenticated USING (
+        (
+            SELECT
+                auth.uid()
+        ) = profile_id
+    );
+
+CREATE POLICY "Org members can add members (needs role check)" ON public.organization_members FOR
+INSERT
+    TO authenticated WITH CHECK (
+        organization_id IN (
+            SELECT
+                public.user_org_ids()
+        )
+    );
+
+CREATE POLICY "Org members can remove members (needs role check)" ON public.organization_members FOR
+DELETE
+    TO authenticated USING (
+        (
+            SELECT
+                auth.uid()
+        ) <> profile_id
+        AND organization_id IN (
+            SELECT
+                public.user_org_ids()
+        )
+    );
+
+-- ========= Projects Policies =========
+DROP POLICY IF EXISTS "Members can view projects in their orgs" ON public.projects;
+
+DROP POLICY IF EXISTS "Org members can create projects" ON public.projects;
+
+DROP POLICY IF EXISTS "Org/Project members can manage projects" ON public.projects;
+
+DROP POLICY IF EXISTS "Org/Project members can delete projects" ON public.projects;
+
+CREATE POLICY "Members can view projects in their orgs" ON public.projects FOR
+SELECT
+    TO authenticated USING (
+        organization_id IN (
+            SELECT
+                public.user_org_ids()
+        )
+    );
+
+CREATE POLICY "Org members can create projects" ON public.projects FOR
+INSERT
+    TO authenticated WITH CHECK (
+        organization_id IN (
+            SELECT
+                public.user_org_ids()
+        )
+    );
+
+CREATE POLICY "Org/Project members can manage projects" ON public.projects FOR
+UPDATE
+    TO authenticated USING (
+        organization_id IN (
+            SELECT
+                public.user_org_ids()
+        )
+        OR id IN (
+            SELECT
+                public.user_project_ids()
+        )
+    ) WITH CHECK (
+        organization_id IN (
+            SELECT
+                public.user_org_ids()
+        )
+        OR id IN (
+            SELECT
+                public.user_project_ids()
+        )
+    );
+
+CREATE POLICY "Org/Project members can delete projects" ON public.projects FOR
+DELETE
+    TO authenticated USING (
+        organization_id IN (
+            SELECT
+                public.user_org_ids()
+        )
+        OR id IN (
+            SELECT
+                public.user_project_ids()
+        )
+    );
+
+-- ========= Project Members Policies =========
+DROP POLICY IF EXISTS "Project members can view their own project membership" ON public.project_members;
+
+DROP POLICY IF EXISTS "Project members can view other members in the same project" ON public.project_members;
+
+DROP POLICY IF EXISTS "Users can leave projects" ON public.project_members;
+
+DROP POLICY IF EXISTS "Project members can add members (needs role check)" ON public.project_members;
+
+DROP POLICY IF EXISTS "Project members can remove members (needs role check)" ON public.project_members;
+
+CREATE POLICY "Project members can view their own project membership" ON public.project_members FOR
+SELECT
+    TO authenticated USING (
+        (
+            SELECT
+                auth.uid()
+        ) = profile_id
+    );
+
+CREATE POLICY "Project members can view other members in the same project" ON public.project_members FOR
+SELECT
+    TO authenticated USING (
+        project_id IN (
+            SELECT
+                public.user_project_ids()
+        )
+    );
+
+CREATE POLICY "Users can leave projects" ON public.project_members FOR
+DELETE
+    TO authenticated USING (
+        (
+            SELECT
+                auth.uid()
+        ) = profile_id
+    );
+
+CREATE POLICY "Project members can add members (needs role check)" ON public.project_members FOR
+INSERT
+    TO authenticated WITH CHECK (
+        project_id IN (
+            SELECT
+                public.user_project_ids()
+        )
+        OR project_id IN (
+            SELECT
+                public.user_org_project_ids()
+        )
+    );
+
+CREATE POLICY "Project members can remove members (needs role check)" ON public.project_members FOR
+DELETE
+    TO authenticated USING (
+        (
+            SELECT
+                auth.uid()
+        ) <> profile_id
+        AND (
+            project_id IN (
+                SELECT
+                    public.user_project_ids()
+            )
+            OR project_id IN (
+                SELECT
+                    public.user_org_project_ids()
+            )
+        )
+    );
+
+-- ========= Invitations Policies =========
+DROP POLICY IF EXISTS "Invitees can view their own pending invitations" ON public.invitations;
+
+DROP POLICY IF EXISTS "Inviters can view invitations they sent" ON public.invitations;
+
+DROP POLICY IF EXISTS "Users can create invitations for orgs/projects they belong to" ON public.invitations;
+
+DROP POLICY IF EXISTS "Inviters can delete/cancel their own pending invitations" ON public.invitations;
+
+CREATE POLICY "Invitees can view their own pending invitations" ON public.invitations AS PERMISSIVE FOR
+SELECT
+    TO authenticated USING (
+        status = 'pending'
+        AND invitee_email = (
+            SELECT
+                u.email
+            FROM
+                auth.users u
+            WHERE
+                u.id = (
+                    SELECT
+                        auth.uid()
+                )
+        )
+        AND (
+            expires_at IS NULL
+            OR expires_at > now()
+        )
+    );
+
+CREATE POLICY "Inviters can view invitations they sent" ON public.invitations AS PERMISSIVE FOR
+SELECT
+    TO authenticated USING (
+        inviter_id = (
+            SELECT
+                auth.uid()
+        )
+    );
+
+CREATE POLICY "Users can create invitations for orgs/projects they belong to" ON public.invitations AS PERMISSIVE FOR
+INSERT
+    TO authenticated WITH CHECK (
+        inviter_id = (
+            SELECT
+                auth.uid()
+        )
+        AND (
+            (
+                target_type = 'organization'
+                AND target_id IN (
+                    SELECT
+                        public.user_org_ids()
+                )
+            )
+            OR (
+                target_type = 'project'
+                AND target_id IN (
+                    SELECT
+                        public.user_org_project_ids()
+                )
+            )
+        )
+    );
+
+CREATE POLICY "Inviters can delete/cancel their own pending invitations" ON public.invitations AS PERMISSIVE FOR
+DELETE
+    TO authenticated USING (
+        inviter_id = (
+            SELECT
+                auth.uid()
+        )
+        AND status = 'pending'
+    );
+
+COMMIT;
+
+-- End transaction
@@ -0,0 +1,145 @@
+-- Migration: 0007_BULK_UPDATE_FUNCTIONS.sql
+-- Purpose: Set-based update functions used by the bulk `update*` helpers in @maestro/supabase.
+--   Each function applies a JSON array of patches (`[{ "id": ..., "<column>": ... }, ...]`) in a
+--   single UPDATE statement. A column is only changed when its key is present in the patch, so an
+--   explicit `null` clears a nullable column while a missing key leaves it untouched. A key that is
+--   not a patchable column raises an error (SQLSTATE 22023) instead of being ignored.
+--   The functions are SECURITY INVOKER: the caller's RLS UPDATE policies apply, and rows the caller
+--   may not update are skipped exactly as with a regular UPDATE. Only updated rows are returned.
+BEGIN
+;
+
+-- ========= patch validation =========
+CREATE
+OR REPLACE FUNCTION public.assert_bulk_patch_keys(patches jsonb, allowed text []) RETURNS void LANGUAGE plpgsql
+SET
+    search_path = '' AS $$
+DECLARE
+    unknown text [];
+BEGIN
+    SELECT
+        array_agg(DISTINCT k.key ORDER BY k.key) INTO unknown
+    FROM
+        jsonb_array_elements(patches) AS p(patch),
+        jsonb_object_keys(p.patch) AS k(key)
+    WHERE
+        k.key <> 'id'
+        AND k.key <> ALL (allowed);
+
+    IF unknown IS NOT NULL THEN
+        RAISE EXCEPTION 'Unknown patch columns: %', array_to_string(unknown, ', ')
+            USING ERRCODE = '22023',
+            HINT = 'Patchable columns: ' || array_to_string(allowed, ', ');
+    END IF;
+END;
+$$;
+
+COMMENT ON FUNCTION public.assert_bulk_patch_keys(jsonb, text []) IS 'Raises when a patch passed to a bulk_update_* function has a key other than id and the allowed columns.';
+
+GRANT EXECUTE ON FUNCTION public.assert_bulk_patch_keys(jsonb, text []) TO authenticated,
+service_role;
+
+-- ========= projects =========
+CREATE
+OR REPLACE FUNCTION public.bulk_update_projects(patches jsonb) RETURNS SETOF public.projects LANGUAGE sql SECURITY INVOKER
+SET
+    search_path = '' AS $$
+SELECT
+    public.assert_bulk_patch_keys(patches, ARRAY ['organization_id', 'name', 'description']);
+
+UPDATE
+    public.projects AS t
+SET
+    organization_id = CASE
+        WHEN p.patch ? 'organization_id' THEN (p.patch ->> 'organization_id') :: uuid
+        ELSE t.organization_id
+    END,
+    name = CASE
+        WHEN p.patch ? 'name' THEN (p.patch ->> 'name')
+        ELSE t.name
+    END,
+    description = CASE
+        WHEN p.patch ? 'description' THEN (p.patch ->> 'description')
+        ELSE t.description
+    END
+FROM
+    jsonb_array_elements(patches) AS p(patch)
+WHERE
+    t.id = (p.patch ->> 'id') :: uuid RETURNING t.*;
+
+$$;
+
+COMMENT ON FUNCTION public.bulk_update_projects(jsonb) IS 'Applies a JSON array of { id, ...columns } patches to projects in one statement. Patchable columns: organization_id, name, description; any other key raises an error. Pass at most one patch per id.';
+
+GRANT EXECUTE ON FUNCTION public.bulk_update_projects(jsonb) TO authenticated,
+service_role;
+
+-- ========= organizations =========
+CREATE
+OR REPLACE FUNCTION public.bulk_update_organizations(patches jsonb) RETURNS SETOF public.organizations LANGUAGE sql SECURITY INVOKER
+SET
+    search_path = '' AS $$
+SELECT
+    public.assert_bulk_patch_keys(patches, ARRAY ['name', 'owner_id']);
+
+UPDATE
+    public.organizations AS t
+SET
+    name = CASE
+        WHEN p.patch ? 'name' THEN (p.patch ->> 'name')
+        ELSE t.name
+    END,
+    owner_id = CASE
+        WHEN p.patch ? 'owner_id' THEN (p.patch ->> 'owner_id') :: uuid
+        ELSE t.owner_id
+    END
+FROM
+    jsonb_array_elements(patches) AS p(patch)
+WHERE
+    t.id = (p.patch ->> 'id') :: uuid RETURNING t.*;
+
+$$;
+
+COMMENT ON FUNCTION public.bulk_update_organizations(jsonb) IS 'Applies a JSON array of { id, ...columns } patches to organizations in one statement. Patchable columns: name, owner_id; any other key raises an error. Pass at most one patch per id.';
+
+GRANT EXECUTE ON FUNCTION public.bulk_update_organizations(jsonb) TO authenticated,
+service_role;
+
+-- ========= profiles =========
+CREATE
+OR REPLACE FUNCTION public.bulk_update_profiles(patches jsonb) RETURNS SETOF public.profiles LANGUAGE sql SECURITY INVOKER
+SET
+    search_path = '' AS $$
+SELECT
+    public.assert_bulk_patch_keys(patches, ARRAY ['username', 'full_name', 'avatar_url']);
+
+UPDATE
+    public.profiles AS t
+SET
+    username = CASE
+        WHEN p.patch ? 'username' THEN (p.patch ->> 'username')
+        ELSE t.username
+    END,
+    full_name = CASE
+        WHEN p.patch ? 'full_name' THEN (p.patch ->> 'full_name')
+        ELSE t.full_name
+    END,
+    avatar_url = CASE
+        WHEN p.patch ? 'avatar_url' THEN (p.patch ->> 'avatar_url')
+        ELSE t.avatar_url
+    END
+FROM
+    jsonb_array_elements(patches) AS p(patch)
+WHERE
+    t.id = (p.patch ->> 'id') :: uuid RETURNING t.*;
+
+$$;
+
+COMMENT ON FUNCTION public.bulk_update_profiles(jsonb) IS 'Applies a JSON array of { id, ...columns } patches to profiles in one statement. Patchable columns: username, full_name, avatar_url; any other key raises an error. Pass at most one patch per id.';
+
+GRANT EXECUTE ON FUNCTION public.bulk_update_profiles(jsonb) TO authenticated,
+service_role;
+
+COMMIT;
+
+-- End transaction
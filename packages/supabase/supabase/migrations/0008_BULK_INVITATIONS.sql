@@ -0,0 +1,328 @@
+-- Migration: 0008_BULK_INVITATIONS.sql
+-- Purpose: Set-based invitation processing.
+--   * accept_all_invitations() / decline_all_invitations(): process every pending invitation
+--     for the current user in one transaction, with one auth.users lookup and set-based writes.
+--     Emails are compared case-insensitively.
+--   * create_invitations(jsonb): create many invitations in one statement (e.g. inviting a team).
+--   * expire_invitations(): mark every overdue pending invitation as expired in one indexed UPDATE.
+--     Run it on a schedule (see apps/backend/src/jobs/expire-invitations.ts) or on demand.
+BEGIN
+;
+
+-- ========= Indexes =========
+-- Serves the case-insensitive invitee lookups of accept_all_invitations() / decline_all_invitations().
+CREATE INDEX IF NOT EXISTS idx_invitations_invitee_email_lower_pending ON public.invitations (lower(invitee_email))
+WHERE
+    status = 'pending';
+
+-- Serves expire_invitations(): only pending invitations with an expiry are indexed.
+CREATE INDEX IF NOT EXISTS idx_invitations_pending_expires_at ON public.invitations (expires_at)
+WHERE
+    status = 'pending'
+    AND expires_at IS NOT NULL;
+
+-- ========= Functions =========
+-- Marks all overdue pending invitations as expired. Returns the number of rows expired.
+CREATE
+OR REPLACE FUNCTION public.expire_invitations() RETURNS integer LANGUAGE plpgsql SECURITY DEFINER
+SET
+    search_path = '' AS $$
+DECLARE
+    expired_count integer;
+
+BEGIN
+    UPDATE
+        public.invitations
+    SET
+        status = 'expired'
+    WHERE
+        status = 'pending'
+        AND expires_at IS NOT NULL
+        AND expires_at <= now();
+
+GET DIAGNOSTICS expired_count = ROW_COUNT;
+
+RETURN expired_count;
+
+END;
+
+$$;
+
+COMMENT ON FUNCTION public.expire_invitations() IS 'Marks every pending invitation whose expires_at has passed as expired. Returns the number of invitations expired.';
+
+-- Accepts every pending, unexpired invitation addressed to the current user (email compared
+-- case-insensitively) whose organization or project still exists.
+-- Memberships the user already has are kept as they are. All-or-nothing: on error nothing is applied.
+CREATE
+OR REPLACE FUNCTION public.accept_all_invitations() RETURNS jsonb LANGUAGE plpgsql SECURITY DEFINER
+SET
+    search_path = '' AS $$
+DECLARE
+    caller_id uuid := auth.uid();
+
+caller_email text;
+
+expired_count integer;
+
+accepted_count integer;
+
+organization_count integer;
+
+project_count integer;
+
+BEGIN
+    SELECT
+        lower(u.email) INTO caller_email
+    FROM
+        auth.users u
+    WHERE
+        u.id = caller_id;
+
+IF caller_email IS NULL THEN RAISE
+EXCEPTION
+    'User not found.';
+
+END IF;
+
+-- Expire overdue invitations first so they are never accepted.
+UPDATE
+    public.invitations
+SET
+    status = 'expired'
+WHERE
+    lower(invitee_email) = caller_email
+    AND status = 'pending'
+    AND expires_at IS NOT NULL
+    AND expires_at <= now();
+
+GET DIAGNOSTICS expired_count = ROW_COUNT;
+
+-- The UPDATE locks the invitations it accepts; a concurrent accept waits and then skips them.
+-- Invitations whose organization or project was deleted are skipped (left pending).
+WITH accepted AS (
+    UPDATE
+        public.invitations inv
+    SET
+        status = 'accepted'
+    WHERE
+        lower(inv.invitee_email) = caller_email
+        AND inv.status = 'pending'
+        AND (
+            (
+                inv.target_type = 'organization'
+                AND EXISTS (
+                    SELECT
+                        1
+                    FROM
+                        public.organizations o
+                    WHERE
+                        o.id = inv.target_id
+                )
+            )
+            OR (
+                inv.target_type = 'project'
+                AND EXISTS (
+                    SELECT
+                        1
+                    FROM
+                        public.projects p
+                    WHERE
+                        p.id = inv.target_id
+                )
+            )
+        ) RETURNING inv.target_type,
+        inv.target_id,
+        inv.role
+),
+organization_rows AS (
+    INSERT INTO
+        public.organization_members (organization_id, profile_id, role)
+    SELECT
+        a.target_id,
+        caller_id,
+        a.role
+    FROM
+        accepted a
+        JOIN public.organizations o ON o.id = a.target_id
+    WHERE
+        a.target_type = 'organization' ON CONFLICT (organization_id, profile_id) DO NOTHING RETURNING 1
+),
+project_rows AS (
+    INSERT INTO
+        public.project_members (project_id, profile_id, role)
+    SELECT
+        a.target_id,
+        caller_id,
+        a.role
+    FROM
+        accepted a
+        JOIN public.projects p ON p.id = a.target_id
+    WHERE
+        a.target_type = 'project' ON CONFLICT (project_id, profile_id) DO NOTHING RETURNING 1
+)
+SELECT
+    (
+        SELECT
+            count(*)
+        FROM
+            accepted
+    ),
+    (
+        SELECT
+            count(*)
+        FROM
+            organization_rows
+    ),
+    (
+        SELECT
+            count(*)
+        FROM
+            project_rows
+    ) INTO accepted_count,
+    organization_count,
+    project_count;
+
+RETURN jsonb_build_object(
+    'status',
+    'success',
+    'accepted',
+    accepted_count,
+    'organizations_joined',
+    organization_count,
+    'projects_joined',
+    project_count,
+    'expired',
+    expired_count
+);
+
+EXCEPTION
+    WHEN others THEN RAISE WARNING 'Error accepting invitations for user %: %',
+    caller_id,
+    SQLERRM;
+
+RETURN jsonb_build_object(
+    'status',
+    'error',
+    'message',
+    'Failed to accept invitations: ' || SQLERRM
+);
+
+END;
+
+$$;
+
+COMMENT ON FUNCTION public.accept_all_invitations() IS 'Accepts every pending, unexpired invitation addressed to the authenticated user whose target still exists, in a single transaction, adding them to the target organizations and projects.';
+
+-- Declines every pending invitation addressed to the current user.
+CREATE
+OR REPLACE FUNCTION public.decline_all_invitations() RETURNS jsonb LANGUAGE plpgsql SECURITY DEFINER
+SET
+    search_path = '' AS $$
+DECLARE
+    caller_id uuid := auth.uid();
+
+caller_email text;
+
+declined_count integer;
+
+BEGIN
+    SELECT
+        lower(u.email) INTO caller_email
+    FROM
+        auth.users u
+    WHERE
+        u.id = caller_id;
+
+IF caller_email IS NULL THEN RAISE
+EXCEPTION
+    'User not found.';
+
+END IF;
+
+UPDATE
+    public.invitations
+SET
+    status = 'declined'
+WHERE
+    lower(invitee_email) = caller_email
+    AND status = 'pending';
+
+GET DIAGNOSTICS declined_count = ROW_COUNT;
+
+RETURN jsonb_build_object(
+    'status',
+    'success',
+    'declined',
+    declined_count
+);
+
+EXCEPTION
+    WHEN others THEN RAISE WARNING 'Error declining invitations for user %: %',
+    caller_id,
+    SQLERRM;
+
+RETURN jsonb_build_object(
+    'status',
+    'error',
+    'message',
+    'Failed to decline invitations: ' || SQLERRM
+);
+
+END;
+
+$$;
+
+COMMENT ON FUNCTION public.decline_all_invitations() IS 'Declines every pending invitation addressed to the authenticated user.';
+
+-- Creates many invitations in one statement. `invitations` is a JSON array of
+-- { invitee_email, target_type, target_id, role, expires_at? } objects.
+-- SECURITY INVOKER: the RLS INSERT policy checks the caller belongs to each target.
+-- Emails that already have a pending invitation for the same target are skipped.
+CREATE
+OR REPLACE FUNCTION public.create_invitations(invitations jsonb) RETURNS SETOF public.invitations LANGUAGE sql SECURITY INVOKER
+SET
+    search_path = '' AS $$
+INSERT INTO
+    public.invitations (
+        inviter_id,
+        invitee_email,
+        target_type,
+        target_id,
+        role,
+        expires_at
+    )
+SELECT
+    auth.uid(),
+    lower(btrim(item ->> 'invitee_email')),
+    (item ->> 'target_type') :: public.invitation_target_type,
+    (item ->> 'target_id') :: uuid,
+    item ->> 'role',
+    (item ->> 'expires_at') :: timestamp with time zone
+FROM
+    jsonb_array_elements(invitations) AS item ON CONFLICT (invitee_email, target_type, target_id)
+WHERE
+    status = 'pending' DO NOTHING RETURNING *;
+
+$$;
+
+COMMENT ON FUNCTION public.create_invitations(jsonb) IS 'Creates invitations from a JSON array of { invitee_email, target_type, target_id, role, expires_at? } in one statement. Duplicate pending invitations are skipped; only created rows are returned.';
+
+-- ========= Permissions =========
+GRANT EXECUTE ON FUNCTION public.accept_all_invitations() TO authenticated;
+
+GRANT EXECUTE ON FUNCTION public.decline_all_invitations() TO authenticated;
+
+GRANT EXECUTE ON FUNCTION public.create_invitations(jsonb) TO authenticated;
+
+-- Expiry is a maintenance task: only the service role (backend job) may run it.
+REVOKE EXECUTE ON FUNCTION public.expire_invitations()
+FROM
+    PUBLIC,
+    anon,
+    authenticated;
+
+GRANT EXECUTE ON FUNCTION public.expire_invitations() TO service_role;
+
+COMMIT;
+
+-- End transaction
@@ -0,0 +1,479 @@
+-- Migration: 0009_USER_ACCESS.sql
+-- Purpose: Maintained per-user access set.
+--   * public.user_access holds one row per (profile, accessible project) with the role the
+--     user has through the project's organization and/or a direct project membership.
+--   * Statement-level triggers on organization_members, project_members and projects keep it
+--     up to date incrementally: only the (profile, project) pairs touched by a statement are
+--     recomputed, so bulk membership changes cost one recompute per statement.
+--   * Authorization paths read a single indexed table instead of re-joining both membership
+--     tables: user_org_project_ids() now reads user_access, and the backend caches a user's
+--     access set once per request (see apps/backend/src/middleware/access.ts).
+BEGIN
+;
+
+-- ========= Table =========
+CREATE TABLE IF NOT EXISTS public.user_access (
+    profile_id uuid NOT NULL REFERENCES public.profiles(id) ON DELETE CASCADE,
+    project_id uuid NOT NULL REFERENCES public.projects(id) ON DELETE CASCADE,
+    organization_id uuid NOT NULL REFERENCES public.organizations(id) ON DELETE CASCADE,
+    -- Role in the project's organization, or NULL when the user is not an org member.
+    organization_role text,
+    -- Direct project role, or NULL when the user is not a project member.
+    project_role text,
+    updated_at timestamp with time zone DEFAULT timezone('utc' :: text, now()) NOT NULL,
+    PRIMARY KEY (profile_id, project_id),
+    CONSTRAINT user_access_has_role CHECK (
+        organization_role IS NOT NULL
+        OR project_role IS NOT NULL
+    )
+);
+
+ALTER TABLE
+    public.user_access OWNER TO postgres;
+
+COMMENT ON TABLE public.user_access IS 'Derived: projects each user can access and the roles granting access. Maintained by triggers on the membership tables; do not write directly.';
+
+CREATE INDEX IF NOT EXISTS idx_user_access_project_id ON public.user_access (project_id);
+
+CREATE INDEX IF NOT EXISTS idx_user_access_organization_id ON public.user_access (organization_id);
+
+-- ========= Maintenance Functions =========
+-- Recomputes user_access for the given (profile, project) pairs, zipped from the two arrays.
+CREATE
+OR REPLACE FUNCTION public.refresh_user_access_pairs(profile_ids uuid [], project_ids uuid []) RETURNS void LANGUAGE sql SECURITY DEFINER
+SET
+    search_path = '' AS $$
+DELETE FROM
+    public.user_access ua USING unnest(profile_ids, project_ids) AS pair(profile_id, project_id)
+WHERE
+    ua.profile_id = pair.profile_id
+    AND ua.project_id = pair.project_id;
+
+INSERT INTO
+    public.user_access (
+        profile_id,
+        project_id,
+        organization_id,
+        organization_role,
+        project_role
+    )
+SELECT
+    pair.profile_id,
+    p.id,
+    p.organization_id,
+    om.role,
+    pm.role
+FROM
+    (
+        SELECT
+            DISTINCT profile_id,
+            project_id
+        FROM
+            unnest(profile_ids, project_ids) AS pairs(profile_id, project_id)
+    ) pair
+    JOIN public.projects p ON p.id = pair.project_id
+    JOIN public.profiles pr ON pr.id = pair.profile_id
+    LEFT JOIN public.organization_members om ON om.organization_id = p.organization_id
+    AND om.profile_id = pair.profile_id
+    LEFT JOIN public.project_members pm ON pm.project_id = p.id
+    AND pm.profile_id = pair.profile_id
+WHERE
+    om.profile_id IS NOT NULL
+    OR pm.profile_id IS NOT NULL ON CONFLICT (profile_id, project_id) DO
+UPDATE
+SET
+    organization_id = EXCLUDED.organization_id,
+    organization_role = EXCLUDED.organization_role,
+    project_role = EXCLUDED.project_role,
+    updated_at = timezone('utc' :: text, now());
+
+$$;
+
+COMMENT ON FUNCTION public.refresh_user_access_pairs(uuid [], uuid []) IS 'Recomputes user_access rows for the (profile_ids[i], project_ids[i]) pairs from the membership tables.';
+
+-- Recomputes user_access for every user of the given projects (e.g. after a project moves org).
+CREATE
+OR REPLACE FUNCTION public.refresh_user_access_projects(project_ids uuid []) RETURNS void LANGUAGE plpgsql SECURITY DEFINER
+SET
+    search_path = '' AS $$
+DECLARE
+    profile_list uuid [];
+
+project_list uuid [];
+
+BEGIN
+    SELECT
+        array_agg(candidates.profile_id),
+        array_agg(candidates.project_id) INTO profile_list,
+        project_list
+    FROM
+        (
+            SELECT
+                ua.profile_id,
+                ua.project_id
+            FROM
+                public.user_access ua
+            WHERE
+                ua.project_id = ANY (project_ids)
+            UNION
+            SELECT
+                om.profile_id,
+                p.id
+            FROM
+                public.projects p
+                JOIN public.organization_members om ON om.organization_id = p.organization_id
+            WHERE
+                p.id = ANY (project_ids)
+            UNION
+            SELECT
+                pm.profile_id,
+                pm.project_id
+            FROM
+                public.project_members pm
+            WHERE
+                pm.project_id = ANY (project_ids)
+        ) candidates;
+
+IF profile_list IS NOT NULL THEN PERFORM public.refresh_user_access_pairs(profile_list, project_list);
+
+END IF;
+
+END;
+
+$$;
+
+COMMENT ON FUNCTION public.refresh_user_access_projects(uuid []) IS 'Recomputes user_access rows for every current or former user of the given projects.';
+
+-- Rebuilds user_access from scratch. Used for the initial backfill and for repair.
+CREATE
+OR REPLACE FUNCTION public.rebuild_user_access() RETURNS void LANGUAGE sql SECURITY DEFINER
+SET
+    search_path = '' AS $$
+DELETE FROM
+    public.user_access
+WHERE
+    TRUE;
+
+INSERT INTO
+    public.user_access (
+        profile_id,
+        project_id,
+        organization_id,
+        organization_role,
+        project_role
+    )
+SELECT
+    access.profile_id,
+    access.project_id,
+    access.organization_id,
+    max(access.organization_role),
+    max(access.project_role)
+FROM
+    (
+        SELECT
+            om.profile_id,
+            p.id AS project_id,
+            p.organization_id,
+            om.role AS organization_role,
+            NULL :: text AS project_role
+        FROM
+            public.projects p
+            JOIN public.organization_members om ON om.organization_id = p.organization_id
+        UNION ALL
+        SELECT
+            pm.profile_id,
+            p.id,
+            p.organization_id,
+            NULL,
+            pm.role
+        FROM
+            public.projects p
+            JOIN public.project_members pm ON pm.project_id = p.id
+    ) access
+GROUP BY
+    access.profile_id,
+    access.project_id,
+    access.organization_id;
+
+$$;
+
+COMMENT ON FUNCTION public.rebuild_user_access() IS 'Rebuilds user_access from the membership tables.';
+
+-- ========= Trigger Functions =========
+-- organization_members: recompute the member's pairs for every project of the organization.
+CREATE
+OR REPLACE FUNCTION public.sync_user_access_from_organization_members() RETURNS trigger LANGUAGE plpgsql SECURITY DEFINER
+SET
+    search_path = '' AS $$
+DECLARE
+    profile_list uuid [];
+
+project_list uuid [];
+
+BEGIN
+    IF TG_OP = 'INSERT' THEN
+    SELECT
+        array_agg(r.profile_id),
+        array_agg(p.id) INTO profile_list,
+        project_list
+    FROM
+        new_rows r
+        JOIN public.projects p ON p.organization_id = r.organization_id;
+
+ELSIF TG_OP = 'DELETE' THEN
+SELECT
+    array_agg(r.profile_id),
+    array_agg(p.id) INTO profile_list,
+    project_list
+FROM
+    old_rows r
+    JOIN public.projects p ON p.organization_id = r.organization_id;
+
+ELSE
+SELECT
+    array_agg(r.profile_id),
+    array_agg(p.id) INTO profile_list,
+    project_list
+FROM
+    (
+        SELECT
+            organization_id,
+            profile_id
+        FROM
+            old_rows
+        UNION
+        SELECT
+            organization_id,
+            profile_id
+        FROM
+            new_rows
+    ) r
+    JOIN public.projects p ON p.organization_id = r.organization_id;
+
+END IF;
+
+IF profile_list IS NOT NULL THEN PERFORM public.refresh_user_access_pairs(profile_list, project_list);
+
+END IF;
+
+RETURN NULL;
+
+END;
+
+$$;
+
+-- project_members: recompute exactly the (profile, project) pairs that changed.
+CREATE
+OR REPLACE FUNCTION public.sync_user_access_from_project_members() RETURNS trigger LANGUAGE plpgsql SECURITY DEFINER
+SET
+    search_path = '' AS $$
+DECLARE
+    profile_list uuid [];
+
+project_list uuid [];
+
+BEGIN
+    IF TG_OP = 'INSERT' THEN
+    SELECT
+        array_agg(r.profile_id),
+        array_agg(r.project_id) INTO profile_list,
+        project_list
+    FROM
+        new_rows r;
+
+ELSIF TG_OP = 'DELETE' THEN
+SELECT
+    array_agg(r.profile_id),
+    array_agg(r.project_id) INTO profile_list,
+    project_list
+FROM
+    old_rows r;
+
+ELSE
+SELECT
+    array_agg(r.profile_id),
+    array_agg(r.project_id) INTO profile_list,
+    project_list
+FROM
+    (
+        SELECT
+            project_id,
+            profile_id
+        FROM
+            old_rows
+        UNION
+        SELECT
+            project_id,
+            profile_id
+        FROM
+            new_rows
+    ) r;
+
+END IF;
+
+IF profile_list IS NOT NULL THEN PERFORM public.refresh_user_access_pairs(profile_list, project_list);
+
+END IF;
+
+RETURN NULL;
+
+END;
+
+$$;
+
+-- projects: new projects inherit the org's members; moved projects are recomputed.
+-- Deleted projects need nothing: their rows go with the ON DELETE CASCADE.
+CREATE
+OR REPLACE FUNCTION public.sync_user_access_from_projects() RETURNS trigger LANGUAGE plpgsql SECURITY DEFINER
+SET
+    search_path = '' AS $$
+DECLARE
+    project_list uuid [];
+
+BEGIN
+    IF TG_OP = 'INSERT' THEN
+    SELECT
+        array_agg(r.id) INTO project_list
+    FROM
+        new_rows r;
+
+ELSE
+SELECT
+    array_agg(n.id) INTO project_list
+FROM
+    new_rows n
+    JOIN old_rows o ON o.id = n.id
+WHERE
+    o.organization_id IS DISTINCT FROM n.organization_id;
+
+END IF;
+
+IF project_list IS NOT NULL THEN PERFORM public.refresh_user_access_projects(project_list);
+
+END IF;
+
+RETURN NULL;
+
+END;
+
+$$;
+
+-- ========= Triggers =========
+-- Transition tables cannot be shared across events, so each event gets its own trigger.
+CREATE TRIGGER user_access_organization_members_insert
+AFTER
+INSERT
+    ON public.organization_members REFERENCING NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION public.sync_user_access_from_organization_members();
+
+CREATE TRIGGER user_access_organization_members_update
+AFTER
+UPDATE
+    ON public.organization_members REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION public.sync_user_access_from_organization_members();
+
+CREATE TRIGGER user_access_organization_members_delete
+AFTER
+    DELETE ON public.organization_members REFERENCING OLD TABLE AS old_rows FOR EACH STATEMENT EXECUTE FUNCTION public.sync_user_access_from_organization_members();
+
+CREATE TRIGGER user_access_project_members_insert
+AFTER
+INSERT
+    ON public.project_members REFERENCING NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION public.sync_user_access_from_project_members();
+
+CREATE TRIGGER user_access_project_members_update
+AFTER
+UPDATE
+    ON public.project_members REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION public.sync_user_access_from_project_members();
+
+CREATE TRIGGER user_access_project_members_delete
+AFTER
+    DELETE ON public.project_members REFERENCING OLD TABLE AS old_rows FOR EACH STATEMENT EXECUTE FUNCTION public.sync_user_access_from_project_members();
+
+CREATE TRIGGER user_access_projects_insert
+AFTER
+INSERT
+    ON public.projects REFERENCING NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION public.sync_user_access_from_projects();
+
+CREATE TRIGGER user_access_projects_update
+AFTER
+UPDATE
+    ON public.projects REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION public.sync_user_access_from_projects();
+
+-- ========= Backfill =========
+SELECT
+    public.rebuild_user_access();
+
+-- ========= RLS =========
+ALTER TABLE
+    public.user_access ENABLE ROW LEVEL SECURITY;
+
+-- Read-only for users; rows are written by the SECURITY DEFINER trigger functions.
+CREATE POLICY "Users can view their own access" ON public.user_access FOR
+SELECT
+    TO authenticated USING (
+        profile_id = (
+            SELECT
+                auth.uid()
+        )
+    );
+
+-- ========= Helpers =========
+-- Projects the current user can access, directly or through their organization.
+CREATE
+OR REPLACE FUNCTION public.user_accessible_project_ids() RETURNS SETOF uuid LANGUAGE sql STABLE SECURITY DEFINER
+SET
+    search_path = '' AS $$
+SELECT
+    ua.project_id
+FROM
+    public.user_access ua
+WHERE
+    ua.profile_id = (
+        SELECT
+            auth.uid()
+    );
+
+$$;
+
+COMMENT ON FUNCTION public.user_accessible_project_ids() IS 'Returns the ids of all projects the authenticated user can access, via organization or direct membership. Reads user_access.';
+
+-- Same result as before, now a primary-key range scan instead of a projects x members join.
+CREATE
+OR REPLACE FUNCTION public.user_org_project_ids() RETURNS SETOF uuid LANGUAGE sql STABLE SECURITY DEFINER
+SET
+    search_path = '' AS $$
+SELECT
+    ua.project_id
+FROM
+    public.user_access ua
+WHERE
+    ua.profile_id = (
+        SELECT
+            auth.uid()
+    )
+    AND ua.organization_role IS NOT NULL;
+
+$$;
+
+-- ========= Permissions =========
+GRANT
+SELECT
+    ON public.user_access TO authenticated,
+    service_role;
+
+GRANT EXECUTE ON FUNCTION public.user_accessible_project_ids() TO authenticated,
+service_role;
+
+-- Maintenance functions are internal: only the service role may call them directly.
+REVOKE EXECUTE ON FUNCTION public.refresh_user_access_pairs(uuid [], uuid []),
+public.refresh_user_access_projects(uuid []),
+public.rebuild_user_access()
+FROM
+    PUBLIC,
+    anon,
+    authenticated;
+
+GRANT EXECUTE ON FUNCTION public.rebuild_user_access() TO service_role;
+
+COMMIT;
+
+-- End transaction
@@ -0,0 +1,264 @@
+-- Migration: 0010_STRIPE_CATALOG.sql
+-- Purpose: Local mirror of the Stripe product catalog.
+--   * stripe_products / stripe_prices hold the fields the app renders, so pricing pages read
+--     Postgres instead of calling the Stripe API on every render.
+--   * Rows are written by the backend only: product.* / price.* webhooks upsert single objects
+--     and `pnpm stripe:sync-catalog` re-syncs everything (apps/backend/src/modules/stripe/catalog.ts).
+--   * last_event_at guards against out-of-order webhook delivery: an upsert never replaces a row
+--     with data older than what is already stored.
+--   * Deleted objects are kept as tombstones (deleted = true, active = false) rather than removed,
+--     so a late *.updated event cannot revive them; an upsert never writes over a tombstone.
+BEGIN
+;
+
+-- ========= Tables =========
+CREATE TABLE IF NOT EXISTS public.stripe_products (
+    id text NOT NULL PRIMARY KEY,
+    active boolean NOT NULL,
+    name text NOT NULL,
+    description text,
+    default_price_id text,
+    images text [] NOT NULL DEFAULT '{}',
+    metadata jsonb NOT NULL DEFAULT '{}' :: jsonb,
+    marketing_features jsonb NOT NULL DEFAULT '[]' :: jsonb,
+    livemode boolean NOT NULL,
+    -- Tombstone: the object was deleted in Stripe (Stripe never reuses ids).
+    deleted boolean NOT NULL DEFAULT FALSE,
+    created_at timestamp with time zone NOT NULL,
+    -- Time of the Stripe event (or full sync) the row reflects.
+    last_event_at timestamp with time zone NOT NULL,
+    synced_at timestamp with time zone DEFAULT timezone('utc' :: text, now()) NOT NULL
+);
+
+ALTER TABLE
+    public.stripe_products OWNER TO postgres;
+
+COMMENT ON TABLE public.stripe_products IS 'Mirror of Stripe products, maintained by the backend from webhooks and full syncs.';
+
+-- No foreign key to stripe_products: price events can arrive before their product's event.
+CREATE TABLE IF NOT EXISTS public.stripe_prices (
+    id text NOT NULL PRIMARY KEY,
+    product_id text NOT NULL,
+    active boolean NOT NULL,
+    currency text NOT NULL,
+    unit_amount bigint,
+    type text NOT NULL CHECK (type IN ('one_time', 'recurring')),
+    recurring_interval text CHECK (
+        recurring_interval IN ('day', 'week', 'month', 'year')
+    ),
+    recurring_interval_count integer,
+    lookup_key text,
+    nickname text,
+    metadata jsonb NOT NULL DEFAULT '{}' :: jsonb,
+    livemode boolean NOT NULL,
+    deleted boolean NOT NULL DEFAULT FALSE,
+    created_at timestamp with time zone NOT NULL,
+    last_event_at timestamp with time zone NOT NULL,
+    synced_at timestamp with time zone DEFAULT timezone('utc' :: text, now()) NOT NULL
+);
+
+ALTER TABLE
+    public.stripe_prices OWNER TO postgres;
+
+COMMENT ON TABLE public.stripe_prices IS 'Mirror of Stripe prices, maintained by the backend from webhooks and full syncs.';
+
+-- ========= Indexes =========
+-- Serves the pricing page query: active products, then active prices of those products.
+CREATE INDEX IF NOT EXISTS idx_stripe_products_active ON public.stripe_products (active, created_at);
+
+CREATE INDEX IF NOT EXISTS idx_stripe_prices_product_id_active ON public.stripe_prices (product_id, active);
+
+-- ========= Functions =========
+-- Upserts products from a JSON array of stripe_products rows (synced_at is set here).
+-- Rows older than the stored version (by last_event_at) are ignored. Tombstones are final: a
+-- deletion always applies and nothing is written over it.
+CREATE
+OR REPLACE FUNCTION public.upsert_stripe_products(products jsonb) RETURNS integer LANGUAGE plpgsql SECURITY INVOKER
+SET
+    search_path = '' AS $$
+DECLARE
+    written integer;
+
+BEGIN
+    INSERT INTO
+        public.stripe_products (
+            id,
+            active,
+            name,
+            description,
+            default_price_id,
+            images,
+            metadata,
+            marketing_features,
+            livemode,
+            deleted,
+            created_at,
+            last_event_at,
+            synced_at
+        )
+    SELECT
+        r.id,
+        r.active,
+        r.name,
+        r.description,
+        r.default_price_id,
+        coalesce(r.images, '{}'),
+        coalesce(r.metadata, '{}' :: jsonb),
+        coalesce(r.marketing_features, '[]' :: jsonb),
+        r.livemode,
+        coalesce(r.deleted, FALSE),
+        r.created_at,
+        r.last_event_at,
+        timezone('utc' :: text, now())
+    FROM
+        jsonb_populate_recordset(NULL :: public.stripe_products, products) r ON CONFLICT (id) DO
+    UPDATE
+    SET
+        active = EXCLUDED.active,
+        name = EXCLUDED.name,
+        description = EXCLUDED.description,
+        default_price_id = EXCLUDED.default_price_id,
+        images = EXCLUDED.images,
+        metadata = EXCLUDED.metadata,
+        marketing_features = EXCLUDED.marketing_features,
+        livemode = EXCLUDED.livemode,
+        deleted = EXCLUDED.deleted,
+        last_event_at = EXCLUDED.last_event_at,
+        synced_at = EXCLUDED.synced_at
+    WHERE
+        NOT public.stripe_products.deleted
+        AND (
+            public.stripe_products.last_event_at <= EXCLUDED.last_event_at
+            OR EXCLUDED.deleted
+        );
+
+GET DIAGNOSTICS written = ROW_COUNT;
+
+RETURN written;
+
+END;
+
+$$;
+
+COMMENT ON FUNCTION public.upsert_stripe_products(jsonb) IS 'Upserts stripe_products rows from a JSON array, skipping rows older than the stored version and tombstoned rows. Returns the number of rows written.';
+
+CREATE
+OR REPLACE FUNCTION public.upsert_stripe_prices(prices jsonb) RETURNS integer LANGUAGE plpgsql SECURITY INVOKER
+SET
+    search_path = '' AS $$
+DECLARE
+    written integer;
+
+BEGIN
+    INSERT INTO
+        public.stripe_prices (
+            id,
+            product_id,
+            active,
+            currency,
+            unit_amount,
+            type,
+            recurring_interval,
+            recurring_interval_count,
+            lookup_key,
+            nickname,
+            metadata,
+            livemode,
+            deleted,
+            created_at,
+            last_event_at,
+            synced_at
+        )
+    SELECT
+        r.id,
+        r.product_id,
+        r.active,
+        r.currency,
+        r.unit_amount,
+        r.type,
+        r.recurring_interval,
+        r.recurring_interval_count,
+        r.lookup_key,
+        r.nickname,
+        coalesce(r.metadata, '{}' :: jsonb),
+        r.livemode,
+        coalesce(r.deleted, FALSE),
+        r.created_at,
+        r.last_event_at,
+        timezone('utc' :: text, now())
+    FROM
+        jsonb_populate_recordset(NULL :: public.stripe_prices, prices) r ON CONFLICT (id) DO
+    UPDATE
+    SET
+        product_id = EXCLUDED.product_id,
+        active = EXCLUDED.active,
+        currency = EXCLUDED.currency,
+        unit_amount = EXCLUDED.unit_amount,
+        type = EXCLUDED.type,
+        recurring_interval = EXCLUDED.recurring_interval,
+        recurring_interval_count = EXCLUDED.recurring_interval_count,
+        lookup_key = EXCLUDED.lookup_key,
+        nickname = EXCLUDED.nickname,
+        metadata = EXCLUDED.metadata,
+        livemode = EXCLUDED.livemode,
+        deleted = EXCLUDED.deleted,
+        last_event_at = EXCLUDED.last_event_at,
+        synced_at = EXCLUDED.synced_at
+    WHERE
+        NOT public.stripe_prices.deleted
+        AND (
+            public.stripe_prices.last_event_at <= EXCLUDED.last_event_at
+            OR EXCLUDED.deleted
+        );
+
+GET DIAGNOSTICS written = ROW_COUNT;
+
+RETURN written;
+
+END;
+
+$$;
+
+COMMENT ON FUNCTION public.upsert_stripe_prices(jsonb) IS 'Upserts stripe_prices rows from a JSON array, skipping rows older than the stored version and tombstoned rows. Returns the number of rows written.';
+
+-- ========= RLS =========
+ALTER TABLE
+    public.stripe_products ENABLE ROW LEVEL SECURITY;
+
+ALTER TABLE
+    public.stripe_prices ENABLE ROW LEVEL SECURITY;
+
+-- The catalog is public: anyone may read it, only the service role writes it.
+CREATE POLICY "Anyone can view the product catalog" ON public.stripe_products FOR
+SELECT
+    TO anon,
+    authenticated USING (TRUE);
+
+CREATE POLICY "Anyone can view catalog prices" ON public.stripe_prices FOR
+SELECT
+    TO anon,
+    authenticated USING (TRUE);
+
+-- ========= Permissions =========
+GRANT
+SELECT
+    ON public.stripe_products,
+    public.stripe_prices TO anon,
+    authenticated;
+
+GRANT ALL ON public.stripe_products,
+public.stripe_prices TO service_role;
+
+REVOKE EXECUTE ON FUNCTION public.upsert_stripe_products(jsonb),
+public.upsert_stripe_prices(jsonb)
+FROM
+    PUBLIC,
+    anon,
+    authenticated;
+
+GRANT EXECUTE ON FUNCTION public.upsert_stripe_products(jsonb),
+public.upsert_stripe_prices(jsonb) TO service_role;
+
+COMMIT;
+
+-- End transaction
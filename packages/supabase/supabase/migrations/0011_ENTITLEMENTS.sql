@@ -0,0 +1,206 @@
+-- Migration: 0011_ENTITLEMENTS.sql
+-- Purpose: Subscription entitlements projected from Stripe webhooks.
+--   * One row per Stripe subscription, owned by a profile or an organization, with the plans,
+--     status and features granted by all of its items (base plan and add-ons). Written by the
+--     backend only (apps/backend/src/modules/entitlements).
+--   * entitlements_for(profile) returns a user's own entitlements plus those of every
+--     organization they belong to, so "what plan is this user on?" is one indexed query.
+--   * last_event_at guards against out-of-order webhook delivery. Stripe event times have
+--     one-second resolution, so two events can tie: a tied event is not applied and the backend
+--     writes the subscription as read from the API instead (last_event_id NULL), which wins
+--     the tie.
+BEGIN
+;
+
+-- ========= Table =========
+CREATE TABLE IF NOT EXISTS public.entitlements (
+    stripe_subscription_id text NOT NULL PRIMARY KEY,
+    stripe_customer_id text NOT NULL,
+    profile_id uuid REFERENCES public.profiles(id) ON DELETE CASCADE,
+    organization_id uuid REFERENCES public.organizations(id) ON DELETE CASCADE,
+    -- Stripe subscription status: active, trialing, past_due, canceled, unpaid, ...
+    status text NOT NULL,
+    -- Price lookup keys (or product ids) of the subscription items, in item order.
+    plans text [] NOT NULL DEFAULT '{}',
+    product_ids text [] NOT NULL DEFAULT '{}',
+    price_ids text [] NOT NULL DEFAULT '{}',
+    -- Feature flags granted by the items' products (metadata "features", comma separated).
+    features text [] NOT NULL DEFAULT '{}',
+    -- Latest period end across the items.
+    current_period_end timestamp with time zone,
+    cancel_at_period_end boolean NOT NULL DEFAULT FALSE,
+    last_event_at timestamp with time zone NOT NULL,
+    -- Stripe event the row reflects; NULL when read from the API.
+    last_event_id text,
+    updated_at timestamp with time zone DEFAULT timezone('utc' :: text, now()) NOT NULL,
+    CONSTRAINT entitlements_single_owner CHECK (
+        (profile_id IS NULL) <> (organization_id IS NULL)
+    )
+);
+
+ALTER TABLE
+    public.entitlements OWNER TO postgres;
+
+COMMENT ON TABLE public.entitlements IS 'Subscriptions projected from Stripe webhooks: the plans, status and features granted to a profile or organization.';
+
+-- ========= Indexes =========
+CREATE INDEX IF NOT EXISTS idx_entitlements_profile_id ON public.entitlements (profile_id)
+WHERE
+    profile_id IS NOT NULL;
+
+CREATE INDEX IF NOT EXISTS idx_entitlements_organization_id ON public.entitlements (organization_id)
+WHERE
+    organization_id IS NOT NULL;
+
+-- ========= Functions =========
+-- Upserts one entitlement from a JSON object with the table's columns, unless the stored
+-- row reflects a later event. On a tie only data read from the API (last_event_id NULL)
+-- applies. Returns the stored row (updated or not).
+CREATE
+OR REPLACE FUNCTION public.upsert_entitlement(entitlement jsonb) RETURNS public.entitlements LANGUAGE plpgsql SECURITY INVOKER
+SET
+    search_path = '' AS $$
+DECLARE
+    stored public.entitlements;
+
+BEGIN
+    INSERT INTO
+        public.entitlements (
+            stripe_subscription_id,
+            stripe_customer_id,
+            profile_id,
+            organization_id,
+            status,
+            plans,
+            product_ids,
+            price_ids,
+            features,
+            current_period_end,
+            cancel_at_period_end,
+            last_event_at,
+            last_event_id,
+            updated_at
+        )
+    SELECT
+        r.stripe_subscription_id,
+        r.stripe_customer_id,
+        r.profile_id,
+        r.organization_id,
+        r.status,
+        coalesce(r.plans, '{}'),
+        coalesce(r.product_ids, '{}'),
+        coalesce(r.price_ids, '{}'),
+        coalesce(r.features, '{}'),
+        r.current_period_end,
+        coalesce(r.cancel_at_period_end, FALSE),
+        r.last_event_at,
+        r.last_event_id,
+        timezone('utc' :: text, now())
+    FROM
+        jsonb_populate_record(NULL :: public.entitlements, entitlement) r ON CONFLICT (stripe_subscription_id) DO
+    UPDATE
+    SET
+        stripe_customer_id = EXCLUDED.stripe_customer_id,
+        profile_id = EXCLUDED.profile_id,
+        organization_id = EXCLUDED.organization_id,
+        status = EXCLUDED.status,
+        plans = EXCLUDED.plans,
+        product_ids = EXCLUDED.product_ids,
+        price_ids = EXCLUDED.price_ids,
+        features = EXCLUDED.features,
+        current_period_end = EXCLUDED.current_period_end,
+        cancel_at_period_end = EXCLUDED.cancel_at_period_end,
+        last_event_at = EXCLUDED.last_event_at,
+        last_event_id = EXCLUDED.last_event_id,
+        updated_at = EXCLUDED.updated_at
+    WHERE
+        public.entitlements.last_event_at < EXCLUDED.last_event_at
+        OR (
+            public.entitlements.last_event_at = EXCLUDED.last_event_at
+            AND EXCLUDED.last_event_id IS NULL
+        );
+
+SELECT
+    * INTO stored
+FROM
+    public.entitlements e
+WHERE
+    e.stripe_subscription_id = entitlement ->> 'stripe_subscription_id';
+
+RETURN stored;
+
+END;
+
+$$;
+
+COMMENT ON FUNCTION public.upsert_entitlement(jsonb) IS 'Upserts an entitlement unless the stored row reflects a later Stripe event. Returns the stored row.';
+
+-- A profile's own entitlements plus those of the organizations it belongs to.
+-- SECURITY INVOKER: users only see what the RLS policies below allow.
+CREATE
+OR REPLACE FUNCTION public.entitlements_for(profile uuid) RETURNS SETOF public.entitlements LANGUAGE sql STABLE SECURITY INVOKER
+SET
+    search_path = '' AS $$
+SELECT
+    e.*
+FROM
+    public.entitlements e
+WHERE
+    e.profile_id = profile
+UNION ALL
+SELECT
+    e.*
+FROM
+    public.entitlements e
+    JOIN public.organization_members om ON om.organization_id = e.organization_id
+WHERE
+    om.profile_id = profile;
+
+$$;
+
+COMMENT ON FUNCTION public.entitlements_for(uuid) IS 'Returns the entitlements of a profile and of every organization it is a member of.';
+
+-- ========= RLS =========
+ALTER TABLE
+    public.entitlements ENABLE ROW LEVEL SECURITY;
+
+-- Read-only for users; rows are written by the backend with the service role.
+CREATE POLICY "Users can view their own entitlements" ON public.entitlements FOR
+SELECT
+    TO authenticated USING (
+        profile_id = (
+            SELECT
+                auth.uid()
+        )
+    );
+
+CREATE POLICY "Members can view their organizations' entitlements" ON public.entitlements FOR
+SELECT
+    TO authenticated USING (
+        organization_id IN (
+            SELECT
+                public.user_org_ids()
+        )
+    );
+
+-- ========= Permissions =========
+GRANT
+SELECT
+    ON public.entitlements TO authenticated;
+
+GRANT ALL ON public.entitlements TO service_role;
+
+GRANT EXECUTE ON FUNCTION public.entitlements_for(uuid) TO authenticated,
+service_role;
+
+REVOKE EXECUTE ON FUNCTION public.upsert_entitlement(jsonb)
+FROM
+    PUBLIC,
+    anon,
+    authenticated;
+
+GRANT EXECUTE ON FUNCTION public.upsert_entitlement(jsonb) TO service_role;
+
+COMMIT;
+
+-- End transaction
@@ -0,0 +1,125 @@
+-- Migration: 0012_STRIPE_CUSTOMERS.sql
+-- Purpose: Persistent Supabase user -> Stripe customer mapping.
+--   * Checkout reads the customer id from here instead of listing Stripe customers by email.
+--   * link_stripe_customer() is first-writer-wins: concurrent checkouts for the same user agree
+--     on one customer id.
+--   * unlink_stripe_customer() (customer deleted in Stripe) keeps the row with a NULL customer
+--     and bumps its generation; checkout derives its customer-create idempotency key from the
+--     generation, so a new customer is created instead of Stripe replaying the deleted one.
+--   * Written with the service role only (frontend checkout action, backend customer.* webhooks).
+BEGIN
+;
+
+-- ========= Table =========
+CREATE TABLE IF NOT EXISTS public.stripe_customers (
+    profile_id uuid NOT NULL PRIMARY KEY REFERENCES public.profiles(id) ON DELETE CASCADE,
+    -- NULL after the linked customer was deleted, until the next one is linked.
+    stripe_customer_id text UNIQUE,
+    -- Number of linked customers deleted so far.
+    generation integer NOT NULL DEFAULT 0,
+    created_at timestamp with time zone DEFAULT timezone('utc' :: text, now()) NOT NULL
+);
+
+ALTER TABLE
+    public.stripe_customers OWNER TO postgres;
+
+COMMENT ON TABLE public.stripe_customers IS 'Stripe customer of each profile, so checkout does not search Stripe by email.';
+
+-- ========= Functions =========
+-- Links a profile to a Stripe customer unless it already has one, and returns the customer id
+-- that is stored afterwards (the existing one if another request won the race). An unlinked
+-- row (NULL customer) takes the new customer.
+CREATE
+OR REPLACE FUNCTION public.link_stripe_customer(profile uuid, customer text) RETURNS text LANGUAGE plpgsql SECURITY INVOKER
+SET
+    search_path = '' AS $$
+DECLARE
+    linked text;
+
+BEGIN
+    INSERT INTO
+        public.stripe_customers (profile_id, stripe_customer_id)
+    VALUES
+        (profile, customer) ON CONFLICT (profile_id) DO
+    UPDATE
+    SET
+        stripe_customer_id = EXCLUDED.stripe_customer_id
+    WHERE
+        public.stripe_customers.stripe_customer_id IS NULL;
+
+SELECT
+    sc.stripe_customer_id INTO linked
+FROM
+    public.stripe_customers sc
+WHERE
+    sc.profile_id = profile;
+
+RETURN linked;
+
+END;
+
+$$;
+
+COMMENT ON FUNCTION public.link_stripe_customer(uuid, text) IS 'Links a profile to a Stripe customer unless already linked. Returns the stored customer id.';
+
+-- Unlinks a deleted Stripe customer and bumps the generation. Returns the number of rows
+-- unlinked (0 when the customer was not linked, e.g. already unlinked by another caller).
+CREATE
+OR REPLACE FUNCTION public.unlink_stripe_customer(customer text) RETURNS integer LANGUAGE plpgsql SECURITY INVOKER
+SET
+    search_path = '' AS $$
+DECLARE
+    unlinked integer;
+
+BEGIN
+    UPDATE
+        public.stripe_customers
+    SET
+        stripe_customer_id = NULL,
+        generation = generation + 1
+    WHERE
+        stripe_customer_id = customer;
+
+GET DIAGNOSTICS unlinked = ROW_COUNT;
+
+RETURN unlinked;
+
+END;
+
+$$;
+
+COMMENT ON FUNCTION public.unlink_stripe_customer(text) IS 'Unlinks a deleted Stripe customer and bumps the generation. Returns the number of rows unlinked.';
+
+-- ========= RLS =========
+ALTER TABLE
+    public.stripe_customers ENABLE ROW LEVEL SECURITY;
+
+CREATE POLICY "Users can view their own Stripe customer" ON public.stripe_customers FOR
+SELECT
+    TO authenticated USING (
+        profile_id = (
+            SELECT
+                auth.uid()
+        )
+    );
+
+-- ========= Permissions =========
+GRANT
+SELECT
+    ON public.stripe_customers TO authenticated;
+
+GRANT ALL ON public.stripe_customers TO service_role;
+
+REVOKE EXECUTE ON FUNCTION public.link_stripe_customer(uuid, text),
+public.unlink_stripe_customer(text)
+FROM
+    PUBLIC,
+    anon,
+    authenticated;
+
+GRANT EXECUTE ON FUNCTION public.link_stripe_customer(uuid, text),
+public.unlink_stripe_customer(text) TO service_role;
+
+COMMIT;
+
+-- End transaction
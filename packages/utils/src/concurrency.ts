@@ -0,0 +1,43 @@
+/**
+ * Maps an (async) iterable with at most `concurrency` calls in flight,
+ * yielding results in input order. Use it to expand streamed rows or objects
+ * (e.g. fetch each customer's payment methods) without unbounded fan-out;
+ * collect the results into an array when the input is an array.
+ *
+ * A rejected call is rethrown when its result is due, i.e. after every
+ * earlier result has been yielded; the iteration then stops and calls still
+ * in flight are not awaited. Mappers that must not stop the batch should
+ * return their errors instead of throwing (as the bulk write helpers of
+ * @maestro/supabase do).
+ * @param source The items to map.
+ * @param concurrency Maximum number of pending `mapper` calls.
+ * @param mapper Async function applied to each item and its index.
+ * @returns An async iterator over the mapped results.
+ * @example
+ * const withMethods = mapWithConcurrency(
+ *   iterateCustomers({ stripe }),
+ *   4,
+ *   async (customer) => ({
+ *     customer,
+ *     methods: await stripe.customers.listPaymentMethods(customer.id),
+ *   }),
+ * );
+ * for await (const { customer, methods } of withMethods) { ... }
+ */
+export async function* mapWithConcurrency<T, R>(
+  source: AsyncIterable<T> | Iterable<T>,
+  concurrency: number,
+  mapper: (item: T, index: number) => Promise<R>,
+): AsyncGenerator<R, void, undefined> {
+  const limit = Math.max(1, Math.floor(concurrency));
+  const inFlight: Promise<R>[] = [];
+  let index = 0;
+  for await (const item of source) {
+    const pending = mapper(item, index++);
+    // Settled out of order; the error is rethrown when the result is due
+    pending.catch(() => undefined);
+    inFlight.push(pending);
+    if (inFlight.length >= limit) yield await inFlight.shift()!;
+  }
+  while (inFlight.length > 0) yield await inFlight.shift()!;
+}
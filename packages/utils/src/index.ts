@@ -0,0 +1,2 @@
+export * from "./concurrency";
+export * from "./query-cache";
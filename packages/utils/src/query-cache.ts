@@ -0,0 +1,34 @@
+/**
+ * Returns true for list query keys, i.e. `[resource, { ...filters }]`.
+ * Detail keys are `[resource, id]`.
+ * @param queryKey The query key to test.
+ * @returns Whether the key belongs to a list query.
+ */
+export const isListQueryKey = (queryKey: readonly unknown[]): boolean => {
+  const filters = queryKey[1];
+  return (
+    typeof filters === "object" && filters !== null && !Array.isArray(filters)
+  );
+};
+
+const toVersion = (value: unknown): number => {
+  if (typeof value === "number") return value;
+  if (typeof value === "string") return Date.parse(value);
+  return NaN;
+};
+
+/**
+ * Checks whether a cached row holds a newer version than one returned by the
+ * server. Versions are ISO timestamps (`updated_at`) or Unix seconds (e.g.
+ * Stripe's `updated`); a missing or unparsable version is never newer.
+ * @param cached The cached row, if any.
+ * @param incoming The row returned by the server.
+ * @param versionKey The column holding the version (default: "updated_at").
+ * @returns Whether the cached row should be kept.
+ */
+export const isNewerVersion = (
+  cached: Record<string, unknown> | undefined,
+  incoming: Record<string, unknown>,
+  versionKey = "updated_at",
+): boolean =>
+  toVersion(cached?.[versionKey]) > toVersion(incoming[versionKey]);